@@ -65,6 +65,7 @@
 #include <debugger/shared/hostutils.h>
 
 #include <coreplugin/icore.h>
+#include <extensionsystem/pluginmanager.h>
 #include <projectexplorer/taskhub.h>
 #include <projectexplorer/itaskhandler.h>
 #include <texteditor/itexteditor.h>
@@ -3397,6 +3398,36 @@ void GdbEngine::requestModuleSymbols(const QString &modulePath)
         QVariant(modulePath + QLatin1Char('@') +  fileName));
 }
 
+// gdb leaves D symbols mangled. The D editor plugin, if loaded, offers a
+// demangler in the object pool; it is used by name to avoid a dependency.
+static void demangleDSymbols(Symbols &symbols)
+{
+    QObject *demangler =
+        ExtensionSystem::PluginManager::getObjectByName(_("DEditor.SymbolDemangler"));
+    if (!demangler)
+        return;
+    QStringList names;
+    QList<int> indexes;
+    for (int i = 0; i < symbols.size(); ++i) {
+        const QString name = symbols.at(i).name.trimmed().section(QLatin1Char(' '), 0, 0);
+        if (symbols.at(i).demangled.trimmed().isEmpty()
+                && (name.startsWith(_("_D")) || name.startsWith(_("__D")))) {
+            names.append(name);
+            indexes.append(i);
+        }
+    }
+    if (names.isEmpty())
+        return;
+    QStringList demangled;
+    if (!QMetaObject::invokeMethod(demangler, "demangleSymbols", Qt::DirectConnection,
+            Q_RETURN_ARG(QStringList, demangled), Q_ARG(QStringList, names))
+            || demangled.size() != names.size())
+        return;
+    for (int i = 0; i < indexes.size(); ++i)
+        if (demangled.at(i) != names.at(i))
+            symbols[indexes.at(i)].demangled = demangled.at(i);
+}
+
 void GdbEngine::handleShowModuleSymbols(const GdbResponse &response)
 {
     const QString cookie = response.cookie.toString();
@@ -3451,6 +3482,7 @@ void GdbEngine::handleShowModuleSymbols(const GdbResponse &response)
         }
         file.close();
         file.remove();
+        demangleDSymbols(symbols);
         debuggerCore()->showModuleSymbols(modulePath, symbols);
     } else {
         showMessageBox(QMessageBox::Critical, tr("Cannot Read Symbols"),
@@ -9,7 +9,12 @@ SOURCES += deditorplugin.cpp \
     dhoverhandler.cpp \
     dcompletionassist.cpp \
     qcdassist.cpp \
-    deditorhighlighter.cpp
+    deditorhighlighter.cpp \
+    dlazyhighlighter.cpp \
+    dindenter.cpp \
+    dsourcescanner.cpp \
+    dfindreferences.cpp \
+    dsymboldemangler.cpp
 
 HEADERS += deditorplugin.h \
         deditor_global.h \
@@ -20,7 +25,12 @@ HEADERS += deditorplugin.h \
     dhoverhandler.h \
     dcompletionassist.h \
     qcdassist.h \
-    deditorhighlighter.h
+    deditorhighlighter.h \
+    dlazyhighlighter.h \
+    dindenter.h \
+    dsourcescanner.h \
+    dfindreferences.h \
+    dsymboldemangler.h
 
 # Qt Creator linking
 
@@ -5,7 +5,9 @@ QTC_LIB_DEPENDS += \
 QTC_PLUGIN_DEPENDS += \
     coreplugin \
 				texteditor \
-				cpptools
+				cpptools \
+				projectexplorer \
+				find
 
 QTC_PLUGIN_RECOMMENDS += \
     # optional plugin dependencies. nothing here at this time
@@ -7,6 +7,8 @@ namespace DEditor {
 namespace Constants {
 
 const char D_ACTION_CLEARASSISTCACHE_ID[] = "DEditor.Action";
+const char D_ACTION_FIND_USAGES_ID[] = "DEditor.FindUsages";
+const char D_ACTION_RENAME_SYMBOL_ID[] = "DEditor.RenameSymbolUnderCursor";
 
 const char M_CONTEXT[] = "DEditor.ContextMenu";
 const char M_TOOLS_D[] = "DEditor.Tools.Menu";
@@ -16,6 +18,9 @@ const char M_REFACTORING_MENU_INSERTION_POINT[] = "DEditor.RefactorGroup";
 const char C_DEDITOR_ID[] = "DEditor.DTextEditor";
 const char C_DEDITOR_DISPLAY_NAME[] = QT_TRANSLATE_NOOP("OpenWith::Editors", "D Editor");
 
+/// object pool name of the DSymbolDemangler, looked up by the debugger
+const char D_SYMBOL_DEMANGLER_OBJECT[] = "DEditor.SymbolDemangler";
+
 const char D_MIMETYPE_SRC[] = "text/x-dsrc";
 const char D_MIMETYPE_HDR[] = "text/x-dhdr";
 
@@ -25,6 +30,13 @@ const char WIZARD_TR_CATEGORY_D[] = QT_TRANSLATE_NOOP("DEditor", "D");
 // Settings
 const char INI_SOURCE_ROOT_KEY[]   = "SourceRoot";
 
+const char SETTINGS_GROUP[] = "DEditor";
+const char LARGE_FILE_THRESHOLD_KEY[] = "LargeFileThreshold";
+const qint64 LARGE_FILE_THRESHOLD_DEFAULT = 4 * 1024 * 1024;
+
+// Info bar
+const char INFO_LARGE_FILE_MODE[] = "DEditor.LargeFileMode";
+
 } // namespace DEditor
 } // namespace Constants
 
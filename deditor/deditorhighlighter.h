@@ -36,6 +36,8 @@ public:
  explicit DEditorHighlighter(TextEditor::BaseTextDocument *parent);
  virtual ~DEditorHighlighter();
 
+ static void correctTokens(QList<CPlusPlus::Token>& tokens, const QString& text);
+
 protected:
  void highlightBlock(const QString &text);
 
@@ -50,8 +52,6 @@ private:
                               int length);
 
  bool isPPKeyword(const QStringRef &text) const;
-
- void correctTokens(QList<CPlusPlus::Token>& tokens, const QString& text);
 };
 
 class DEditorHighlighterFactory : public TextEditor::IHighlighterFactory
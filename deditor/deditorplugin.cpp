@@ -7,6 +7,8 @@
 #include "dcompletionassist.h"
 #include "deditorhighlighter.h"
 #include "qcdassist.h"
+#include "dfindreferences.h"
+#include "dsymboldemangler.h"
 
 #include <coreplugin/icore.h>
 #include <coreplugin/icontext.h>
@@ -15,6 +17,7 @@
 #include <coreplugin/actionmanager/command.h>
 #include <coreplugin/actionmanager/actioncontainer.h>
 #include <coreplugin/coreconstants.h>
+#include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/mimedatabase.h>
 #include <coreplugin/id.h>
 #include <coreplugin/fileiconprovider.h>
@@ -40,7 +43,8 @@ DEditorPlugin *DEditorPlugin::m_instance = 0;
 DEditorPlugin::DEditorPlugin()
  : m_editorFactory(0),
    m_settings(0),
-   m_searchResultWindow(0)
+   m_searchResultWindow(0),
+   m_findReferences(0)
 {
  QTC_ASSERT(!m_instance, return);
  m_instance = this;
@@ -77,6 +81,9 @@ bool DEditorPlugin::initialize(const QStringList &arguments, QString *errorStrin
  addAutoReleasedObject(new DCompletionAssistProvider);
  addAutoReleasedObject(new DHoverHandler(this));
 	addAutoReleasedObject(new DEditorHighlighterFactory);
+ DSymbolDemangler *demangler = new DSymbolDemangler;
+ demangler->setObjectName(QLatin1String(Constants::D_SYMBOL_DEMANGLER_OBJECT));
+ addAutoReleasedObject(demangler);
 
  QObject *core = ICore::instance();
  DFileWizard* wizard = new DFileWizard(DFileWizard::Source, core);
@@ -109,6 +116,23 @@ bool DEditorPlugin::initialize(const QStringList &arguments, QString *errorStrin
                                            Core::Context(Core::Constants::C_GLOBAL));
  connect(action, SIGNAL(triggered()), this, SLOT(clearAssistCacheAction()));
  menu->addAction(cmd);
+ //-- Find usages / rename
+ m_findReferences = new DFindReferences(this);
+ Core::Context dContext(Constants::C_DEDITOR_ID);
+ QAction *findUsagesAction = new QAction(tr("Find Usages"), this);
+ Core::Command *findUsagesCmd = Core::ActionManager::registerAction(findUsagesAction,
+                                                                    Constants::D_ACTION_FIND_USAGES_ID,
+                                                                    dContext);
+ findUsagesCmd->setDefaultKeySequence(QKeySequence(tr("Ctrl+Shift+U")));
+ connect(findUsagesAction, SIGNAL(triggered()), this, SLOT(findUsages()));
+ menu->addAction(findUsagesCmd);
+ QAction *renameAction = new QAction(tr("Rename Symbol Under Cursor"), this);
+ Core::Command *renameCmd = Core::ActionManager::registerAction(renameAction,
+                                                                Constants::D_ACTION_RENAME_SYMBOL_ID,
+                                                                dContext);
+ renameCmd->setDefaultKeySequence(QKeySequence(tr("Ctrl+Shift+R")));
+ connect(renameAction, SIGNAL(triggered()), this, SLOT(renameSymbolUnderCursor()));
+ menu->addAction(renameCmd);
  //--
  Core::ActionManager::actionContainer(Core::Constants::M_TOOLS)->addMenu(menu);
 
@@ -118,6 +142,8 @@ bool DEditorPlugin::initialize(const QStringList &arguments, QString *errorStrin
    ActionManager::createMenu(Constants::M_CONTEXT);
 
  //contextMenu->addSeparator(context);
+ contextMenu->addAction(findUsagesCmd);
+ contextMenu->addAction(renameCmd);
  cmd = ActionManager::command(TextEditor::Constants::AUTO_INDENT_SELECTION);
  contextMenu->addAction(cmd);
  cmd = ActionManager::command(TextEditor::Constants::UN_COMMENT_SELECTION);
@@ -140,6 +166,20 @@ void DEditorPlugin::clearAssistCacheAction()
  QcdAssist::sendClearChache();
 }
 
+void DEditorPlugin::findUsages()
+{
+ DTextEditor *editor = qobject_cast<DTextEditor*>(Core::EditorManager::currentEditor());
+ if (editor)
+  m_findReferences->findUsages(static_cast<DTextEditorWidget*>(editor->editorWidget()));
+}
+
+void DEditorPlugin::renameSymbolUnderCursor()
+{
+ DTextEditor *editor = qobject_cast<DTextEditor*>(Core::EditorManager::currentEditor());
+ if (editor)
+  m_findReferences->renameUsages(static_cast<DTextEditorWidget*>(editor->editorWidget()));
+}
+
 void DEditorPlugin::extensionsInitialized()
 {
  // Retrieve objects from the plugin manager's object pool
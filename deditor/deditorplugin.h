@@ -14,6 +14,7 @@ namespace Internal {
 
 class DEditorFactory;
 class DTextEditorWidget;
+class DFindReferences;
 
 class DEditorPlugin : public ExtensionSystem::IPlugin
 {
@@ -38,6 +39,8 @@ public:
 private slots:
  void updateSearchResultsFont(const TextEditor::FontSettings &);
  void clearAssistCacheAction();
+ void findUsages();
+ void renameSymbolUnderCursor();
 
 private:
  static DEditorPlugin* m_instance;
@@ -46,6 +49,7 @@ private:
 
  TextEditor::TextEditorSettings* m_settings;
  Find::SearchResultWindow *m_searchResultWindow;
+ DFindReferences *m_findReferences;
 };
 
 } // namespace Internal
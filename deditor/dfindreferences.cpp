@@ -0,0 +1,348 @@
+#include "dfindreferences.h"
+#include "dtexteditor.h"
+#include "dsourcescanner.h"
+#include "qcdassist.h"
+
+#include <coreplugin/documentmanager.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/documentmodel.h>
+#include <coreplugin/messagemanager.h>
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <coreplugin/progressmanager/futureprogress.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/session.h>
+#include <texteditor/basefilefind.h>
+#include <texteditor/basetextdocument.h>
+#include <qtconcurrent/runextensions.h>
+
+#include <QtConcurrentMap>
+#include <QDir>
+#include <QFile>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QVector>
+
+using namespace DEditor;
+using namespace DEditor::Internal;
+
+namespace
+{
+const char SEARCH_TASK_ID[] = "DEditor.Task.Search";
+
+struct SearchRequest
+{
+ QStringList files;
+ QHash<QString, QString> workingCopy;
+ QString symbol;
+ QString fileName;  ///< of the editor the search started in
+ QByteArray source; ///< the text of that editor
+ uint bytePos;      ///< of the symbol in source
+};
+
+bool sameFile(const QString &a, const QString &b)
+{
+ return QDir::cleanPath(a) == QDir::cleanPath(b);
+}
+
+class ScanFile
+{
+public:
+ typedef QList<DUsage> result_type;
+
+ ScanFile(const QHash<QString, QString> &workingCopy, const QString &symbol,
+          const QcdAssist::DCDSymbolLocation &declaration, QFutureInterface<DUsage> *future)
+  : m_workingCopy(workingCopy), m_symbol(symbol), m_symbolUtf8(symbol.toUtf8()),
+    m_declaration(declaration), m_future(future)
+ {}
+
+ QList<DUsage> operator()(const QString &fileName)
+ {
+  QList<DUsage> usages;
+  if (m_future->isCanceled())
+   return usages;
+
+  QString text;
+  if (m_workingCopy.contains(fileName))
+   text = m_workingCopy.value(fileName);
+  else
+  {
+   QFile file(fileName);
+   if (!file.open(QIODevice::ReadOnly))
+    return usages;
+   const QByteArray data = file.readAll();
+   // cheap rejection before decoding and tokenizing
+   if (!data.contains(m_symbolUtf8))
+    return usages;
+   text = QString::fromUtf8(data.constData(), data.size());
+  }
+  if (!text.contains(m_symbol))
+   return usages;
+
+  // the tokens first, with their byte offsets for DCD
+  const bool verify = m_declaration.isValid();
+  QList<DUsage> hits;
+  QList<int> hitOffsets;
+  int charPos = 0;
+  int bytePos = 0;
+  DSourceScanner scanner(text);
+  for (DSourceScanner::Token tk = scanner.next(); !tk.is(DSourceScanner::EndOfFile); tk = scanner.next())
+  {
+   if (!tk.is(DSourceScanner::Identifier) || tk.length != m_symbol.length()
+       || scanner.text(tk) != m_symbol)
+    continue;
+   hits.append(DUsage(fileName, tk.line, scanner.lineText(tk), tk.column, tk.length, false));
+   if (verify)
+   {
+    bytePos += text.midRef(charPos, tk.begin - charPos).toUtf8().size();
+    charPos = tk.begin;
+    hitOffsets.append(bytePos);
+   }
+  }
+  if (!verify || hits.isEmpty())
+   return hits;
+
+  // then one DCD query for each distinct symbol of that name in the file
+  const bool declaringFile = sameFile(fileName, m_declaration.fileName);
+  const QByteArray utf8 = text.toUtf8();
+  QHash<int, int> hitAt;
+  for (int i = 0; i < hitOffsets.size(); ++i)
+   hitAt.insert(hitOffsets.at(i), i);
+  QVector<bool> resolved(hits.size(), false);
+  QVector<bool> verified(hits.size(), false);
+  for (int i = 0; i < hits.size() && !m_future->isCanceled(); ++i)
+  {
+   if (resolved.at(i))
+    continue;
+   resolved[i] = true;
+   QList<int> uses;
+   const QcdAssist::DCDSymbolLocation location = QcdAssist::queryLocalUsages(utf8, hitOffsets.at(i), &uses);
+   if (!location.isValid())
+    continue;
+   const bool matches = isDeclaration(location, declaringFile);
+   verified[i] = matches;
+   foreach (int use, uses)
+   {
+    const int hit = hitAt.value(use, -1);
+    if (hit < 0)
+     continue;
+    resolved[hit] = true;
+    verified[hit] = matches;
+   }
+  }
+  for (int i = 0; i < hits.size(); ++i)
+   if (verified.at(i))
+   {
+    hits[i].verified = true;
+    usages.append(hits.at(i));
+   }
+  return usages;
+ }
+
+private:
+ /** Whether DCD's answer names the declaration searched for. */
+ bool isDeclaration(const QcdAssist::DCDSymbolLocation &location, bool declaringFile) const
+ {
+  if (location.offset != m_declaration.offset)
+   return false;
+  // "stdin": declared in the file itself
+  return location.fileName.isEmpty() ? declaringFile
+                                     : sameFile(location.fileName, m_declaration.fileName);
+ }
+
+ QHash<QString, QString> m_workingCopy;
+ QString m_symbol;
+ QByteArray m_symbolUtf8;
+ QcdAssist::DCDSymbolLocation m_declaration;
+ QFutureInterface<DUsage> *m_future;
+};
+
+/**
+ * Asks DCD where the symbol is declared and keeps only the identifiers that
+ * DCD resolves to that declaration, asking once per file for each distinct
+ * symbol of that name (--localUse lists all of its uses). Without a
+ * declaration, every identifier of the same name is reported, unverified.
+ */
+void findUsagesHelper(QFutureInterface<DUsage> &future, const SearchRequest request)
+{
+ QcdAssist::DCDSymbolLocation declaration = QcdAssist::querySymbolLocation(request.source, request.bytePos);
+ if (declaration.isValid() && declaration.fileName.isEmpty())
+  declaration.fileName = request.fileName;
+
+ // the declaration may live outside the project (an include path, phobos, ...)
+ QStringList files = request.files;
+ if (declaration.isValid() && !files.contains(declaration.fileName))
+  files.prepend(declaration.fileName);
+
+ future.setProgressRange(0, files.size());
+ QFuture<QList<DUsage> > scanning =
+   QtConcurrent::mapped(files, ScanFile(request.workingCopy, request.symbol, declaration, &future));
+ // Forward the results file by file, so the window fills while the rest is scanned.
+ for (int i = 0; i < files.size(); ++i)
+ {
+  if (future.isCanceled())
+  {
+   scanning.cancel();
+   break;
+  }
+  const QList<DUsage> usages = scanning.resultAt(i);
+  if (!usages.isEmpty())
+   future.reportResults(usages.toVector());
+  future.setProgressValue(i + 1);
+ }
+ scanning.waitForFinished();
+}
+} // Anonymous
+
+DFindReferences::DFindReferences(QObject *parent)
+ : QObject(parent)
+{
+ qRegisterMetaType<DEditor::Internal::DUsage>("DEditor::Internal::DUsage");
+ connect(&m_watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(displayResults(int,int)));
+ connect(&m_watcher, SIGNAL(finished()), this, SLOT(searchFinished()));
+}
+
+DFindReferences::~DFindReferences()
+{
+ m_watcher.cancel();
+ m_watcher.waitForFinished();
+}
+
+void DFindReferences::findUsages(DTextEditorWidget *editor)
+{
+ startSearch(editor, false, QString());
+}
+
+void DFindReferences::renameUsages(DTextEditorWidget *editor, const QString &replacement)
+{
+ startSearch(editor, true, replacement);
+}
+
+void DFindReferences::startSearch(DTextEditorWidget *editor, bool replace, const QString &replacement)
+{
+ QTextCursor tc = editor->textCursor();
+ tc.select(QTextCursor::WordUnderCursor);
+ const QString symbol = tc.selectedText();
+ if (symbol.isEmpty() || !(symbol.at(0).isLetter() || symbol.at(0) == QLatin1Char('_')))
+  return;
+
+ if (m_watcher.isRunning())
+ {
+  m_watcher.cancel();
+  m_watcher.waitForFinished();
+ }
+
+ // DCD is asked where the symbol is declared in the search itself, off the GUI thread
+ SearchRequest request;
+ const QString text = editor->document()->toPlainText();
+ request.source = text.left(tc.selectionStart()).toUtf8();
+ request.bytePos = request.source.length();
+ request.source.append(text.mid(tc.selectionStart()).toUtf8());
+ request.fileName = editor->editorDocument()->filePath();
+ request.files = candidateFiles(request.fileName);
+ request.workingCopy = workingCopy();
+ request.symbol = symbol;
+
+ Find::SearchResultWindow *window = Find::SearchResultWindow::instance();
+ m_search = window->startNewSearch(tr("D Usages:"), QString(), symbol,
+                                   replace ? Find::SearchResultWindow::SearchAndReplace
+                                           : Find::SearchResultWindow::SearchOnly);
+ if (replace)
+ {
+  m_search->setTextToReplace(replacement.isEmpty() ? symbol : replacement);
+  connect(m_search, SIGNAL(replaceButtonClicked(QString,QList<Find::SearchResultItem>,bool)),
+          this, SLOT(onReplaceButtonClicked(QString,QList<Find::SearchResultItem>,bool)));
+ }
+ connect(m_search, SIGNAL(activated(Find::SearchResultItem)),
+         this, SLOT(openEditor(Find::SearchResultItem)));
+ connect(m_search, SIGNAL(cancelled()), this, SLOT(cancel()));
+ window->popup(Core::IOutputPane::ModeSwitch | Core::IOutputPane::WithFocus);
+
+ QFuture<DUsage> result = QtConcurrent::run(&findUsagesHelper, request);
+ m_watcher.setFuture(result);
+
+ Core::FutureProgress *progress =
+   Core::ProgressManager::addTask(result, tr("Searching for Usages"), SEARCH_TASK_ID);
+ connect(progress, SIGNAL(clicked()), m_search, SLOT(popup()));
+}
+
+QStringList DFindReferences::candidateFiles(const QString &fileName) const
+{
+ static QLatin1String dotd(".d");
+ static QLatin1String dotdi(".di");
+
+ QStringList files;
+ if (ProjectExplorer::Project *project = ProjectExplorer::SessionManager::projectForFile(fileName))
+ {
+  foreach (const QString &file, project->files(ProjectExplorer::Project::AllFiles))
+   if (file.endsWith(dotd) || file.endsWith(dotdi))
+    files.append(file);
+ }
+ if (!files.contains(fileName))
+  files.prepend(fileName);
+ return files;
+}
+
+QHash<QString, QString> DFindReferences::workingCopy() const
+{
+ QHash<QString, QString> copy;
+ foreach (Core::IDocument *document, Core::EditorManager::documentModel()->openedDocuments())
+ {
+  TextEditor::BaseTextDocument *textDocument = qobject_cast<TextEditor::BaseTextDocument *>(document);
+  if (textDocument && textDocument->isModified())
+   copy.insert(textDocument->filePath(), textDocument->document()->toPlainText());
+ }
+ return copy;
+}
+
+void DFindReferences::displayResults(int first, int last)
+{
+ if (!m_search)
+ {
+  m_watcher.cancel();
+  return;
+ }
+ for (int index = first; index != last; ++index)
+ {
+  const DUsage usage = m_watcher.resultAt(index);
+  m_search->addResult(usage.path, usage.line, usage.lineText, usage.column, usage.length,
+                      usage.verified);
+ }
+}
+
+void DFindReferences::searchFinished()
+{
+ if (m_search)
+  m_search->finishSearch(m_watcher.isCanceled());
+}
+
+void DFindReferences::cancel()
+{
+ m_watcher.cancel();
+}
+
+void DFindReferences::openEditor(const Find::SearchResultItem &item)
+{
+ if (item.path.isEmpty())
+  return;
+ Core::EditorManager::openEditorAt(item.path.first(), item.lineNumber, item.textMarkPos);
+}
+
+void DFindReferences::onReplaceButtonClicked(const QString &text,
+                                             const QList<Find::SearchResultItem> &items,
+                                             bool preserveCase)
+{
+ // an identifier DCD did not resolve to the declaration may be anything of the same name
+ QList<Find::SearchResultItem> verified;
+ foreach (const Find::SearchResultItem &item, items)
+  if (item.userData.toBool())
+   verified.append(item);
+ if (verified.size() != items.size())
+  Core::MessageManager::write(tr("%n usage(s) could not be verified with DCD and were not renamed.",
+                                 0, items.size() - verified.size()));
+ const QStringList fileNames = TextEditor::BaseFileFind::replaceAll(text, verified, preserveCase);
+ if (!fileNames.isEmpty())
+ {
+  Core::DocumentManager::notifyFilesChangedInternally(fileNames);
+  Find::SearchResultWindow::instance()->hide();
+ }
+}
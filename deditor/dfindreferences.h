@@ -0,0 +1,74 @@
+#ifndef DFINDREFERENCES_H
+#define DFINDREFERENCES_H
+
+#include <find/searchresultwindow.h>
+
+#include <QObject>
+#include <QPointer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QStringList>
+
+namespace DEditor {
+namespace Internal {
+
+class DTextEditorWidget;
+
+struct DUsage
+{
+ DUsage() : line(0), column(0), length(0), verified(false) {}
+ DUsage(const QString &p, int l, const QString &t, int c, int len, bool v)
+  : path(p), line(l), lineText(t), column(c), length(len), verified(v) {}
+
+ QString path;
+ int line;
+ QString lineText;
+ int column;
+ int length;
+ bool verified; ///< DCD resolved it to the declaration searched for
+};
+
+/**
+ * Project-wide Find Usages and Rename Symbol for D.
+ * The declaration is located with DCD; candidate files are scanned in
+ * parallel with DSourceScanner, so matches inside comments and string
+ * literals are ignored, and each identifier of the same name is kept only
+ * if DCD resolves it to that declaration. If DCD cannot locate the
+ * declaration, all of them are listed but none is renamed. Results are
+ * streamed into the search result window as each file is done and the
+ * search can be cancelled from there.
+ */
+class DFindReferences : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DFindReferences(QObject *parent = 0);
+ ~DFindReferences();
+
+ void findUsages(DTextEditorWidget *editor);
+ void renameUsages(DTextEditorWidget *editor, const QString &replacement = QString());
+
+private slots:
+ void displayResults(int first, int last);
+ void searchFinished();
+ void cancel();
+ void openEditor(const Find::SearchResultItem &item);
+ void onReplaceButtonClicked(const QString &text, const QList<Find::SearchResultItem> &items,
+                             bool preserveCase);
+
+private:
+ void startSearch(DTextEditorWidget *editor, bool replace, const QString &replacement);
+ QStringList candidateFiles(const QString &fileName) const;
+ QHash<QString, QString> workingCopy() const;
+
+ QPointer<Find::SearchResult> m_search;
+ QFutureWatcher<DUsage> m_watcher;
+};
+
+} // namespace Internal
+} // namespace DEditor
+
+Q_DECLARE_METATYPE(DEditor::Internal::DUsage)
+
+#endif // DFINDREFERENCES_H
@@ -0,0 +1,148 @@
+#include "dindenter.h"
+
+#include <texteditor/basetextdocumentlayout.h>
+#include <texteditor/tabsettings.h>
+
+#include <3rdparty/cplusplus/Lexer.h>
+
+#include <QTextDocument>
+#include <QTextBlock>
+
+using namespace DEditor::Internal;
+using namespace TextEditor;
+
+namespace
+{
+bool isCommentState(int lexerState)
+{
+ return lexerState == CPlusPlus::Lexer::State_MultiLineComment
+   || lexerState == CPlusPlus::Lexer::State_MultiLineDoxyComment;
+}
+// A line that does not end a statement or a block makes the next one a continuation.
+bool isContinuationLine(const QString &trimmed)
+{
+ if (trimmed.isEmpty())
+  return false;
+ if (trimmed.startsWith(QLatin1String("//")) || trimmed.endsWith(QLatin1String("*/"))
+     || trimmed.endsWith(QLatin1String("+/")))
+  return false;
+ switch (trimmed.at(trimmed.length() - 1).unicode())
+ {
+ case ';':
+ case '{':
+ case '}':
+ case ':':
+ case ',':
+  return false;
+ default:
+  return trimmed.at(0) != QLatin1Char('@') && trimmed.at(0) != QLatin1Char('#');
+ }
+}
+// How far back an argument list is looked for.
+const int MAX_PARENTHESIS_BLOCKS = 64;
+
+// Position just after the last '(' or '[' still open at the end of @a block,
+// in the block that opened it, which is returned in @a opening; or -1.
+// Stops at a brace, so only the current statement is looked at.
+int unmatchedParenthesis(const QTextBlock &block, QTextBlock *opening)
+{
+ int closed = 0;
+ QTextBlock it = block;
+ for (int n = 0; it.isValid() && n < MAX_PARENTHESIS_BLOCKS; ++n, it = it.previous())
+ {
+  const Parentheses parens = BaseTextDocumentLayout::parentheses(it);
+  for (int i = parens.size() - 1; i >= 0; --i)
+  {
+   const Parenthesis &p = parens.at(i);
+   if (p.chr == QLatin1Char('{') || p.chr == QLatin1Char('}')
+       || p.chr == QLatin1Char('+') || p.chr == QLatin1Char('-'))
+    return -1;
+   if (p.type == Parenthesis::Closed)
+    ++closed;
+   else if (closed > 0)
+    --closed;
+   else
+   {
+    *opening = it;
+    return p.pos + 1;
+   }
+  }
+ }
+ return -1;
+}
+} // Anonymous
+
+DIndenter::DIndenter()
+{}
+
+DIndenter::~DIndenter()
+{}
+
+bool DIndenter::isElectricCharacter(const QChar &ch) const
+{
+ return ch == QLatin1Char('{') || ch == QLatin1Char('}');
+}
+
+void DIndenter::indentBlock(QTextDocument *doc,
+                            const QTextBlock &block,
+                            const QChar &typedChar,
+                            const TabSettings &tabSettings)
+{
+ Q_UNUSED(doc)
+ Q_UNUSED(typedChar)
+
+ const QTextBlock previous = block.previous();
+ if (!previous.isValid())
+ {
+  tabSettings.indentLine(block, 0);
+  return;
+ }
+
+ const QString previousText = previous.text();
+ const QString trimmed = block.text().trimmed();
+ const int previousState = previous.userState();
+
+ // No highlighter state (large-file mode): keep the previous line's indentation.
+ if (previousState == -1)
+ {
+  QTextBlock it = previous;
+  while (it.isValid() && it.text().trimmed().isEmpty())
+   it = it.previous();
+  tabSettings.indentLine(block, it.isValid() ? tabSettings.indentationColumn(it.text()) : 0);
+  return;
+ }
+
+ const int lexerState = previousState & 0xff;
+ const int braceDepth = qMax(0, previousState >> 8);
+
+ // Inside a multi-line comment: line up with the comment body.
+ if (isCommentState(lexerState))
+ {
+  int indent = tabSettings.indentationColumn(previousText);
+  const QString previousTrimmed = previousText.trimmed();
+  if (previousTrimmed.startsWith(QLatin1String("/*")) || previousTrimmed.startsWith(QLatin1String("/+")))
+   ++indent;
+  tabSettings.indentLine(block, indent);
+  return;
+ }
+
+ int indent = braceDepth * tabSettings.m_indentSize;
+ if (trimmed.startsWith(QLatin1Char('}')))
+  indent = qMax(0, indent - tabSettings.m_indentSize);
+
+ // the third and later lines of an argument list line up like the second
+ QTextBlock opening;
+ const int paren = unmatchedParenthesis(previous, &opening);
+ if (paren != -1)
+ {
+  const int column = tabSettings.columnAt(opening.text(), paren);
+  tabSettings.indentLine(block, indent, qMax(0, column - indent));
+  return;
+ }
+
+ if (!trimmed.startsWith(QLatin1Char('{')) && !trimmed.startsWith(QLatin1Char('}'))
+     && isContinuationLine(previousText.trimmed()))
+  indent += tabSettings.m_indentSize;
+
+ tabSettings.indentLine(block, indent);
+}
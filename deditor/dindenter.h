@@ -0,0 +1,32 @@
+#ifndef DINDENTER_H
+#define DINDENTER_H
+
+#include <texteditor/indenter.h>
+
+namespace DEditor {
+namespace Internal {
+
+/**
+ * Indenter for D sources. It does not lex anything itself: the brace depth
+ * and lexer end state that DEditorHighlighter stores in every block's
+ * userState(), plus the parentheses kept in the block user data, are
+ * enough to indent a line by looking at the previous block, and back to
+ * the line that opened an argument list still open.
+ */
+class DIndenter : public TextEditor::Indenter
+{
+public:
+ DIndenter();
+ virtual ~DIndenter();
+
+ bool isElectricCharacter(const QChar &ch) const;
+ void indentBlock(QTextDocument *doc,
+                  const QTextBlock &block,
+                  const QChar &typedChar,
+                  const TextEditor::TabSettings &tabSettings);
+};
+
+} // namespace Internal
+} // namespace DEditor
+
+#endif // DINDENTER_H
@@ -0,0 +1,180 @@
+#include "dlazyhighlighter.h"
+#include "deditorhighlighter.h"
+
+#include <texteditor/basetexteditor.h>
+#include <texteditor/fontsettings.h>
+#include <texteditor/texteditorsettings.h>
+
+#include <cplusplus/SimpleLexer.h>
+
+#include <QTextDocument>
+#include <QTextLayout>
+#include <QScrollBar>
+
+using namespace DEditor::Internal;
+using namespace TextEditor;
+using namespace CPlusPlus;
+
+namespace {
+// QTextBlock::userState() layout used by the lazy highlighter:
+//  bits 0..7 - lexer state at the end of the block
+//  bit  8    - formats were already applied to the block
+const int LexerStateMask = 0xff;
+const int FormattedFlag = 0x100;
+} // Anonymous
+
+DLazyHighlighter::DLazyHighlighter(BaseTextEditorWidget *editor)
+ : QObject(editor), m_editor(editor)
+{
+ fontSettingsChanged();
+ connect(m_editor, SIGNAL(updateRequest(QRect,int)),
+         this, SLOT(updateRequest(QRect,int)));
+ connect(TextEditorSettings::instance(), SIGNAL(fontSettingsChanged(TextEditor::FontSettings)),
+         this, SLOT(fontSettingsChanged()));
+}
+
+DLazyHighlighter::~DLazyHighlighter()
+{
+}
+
+void DLazyHighlighter::clear()
+{
+ disconnect(m_editor, 0, this, 0);
+ QTextDocument *doc = m_editor->document();
+ for (QTextBlock block = doc->begin(); block.isValid(); block = block.next())
+ {
+  if (block.userState() == -1)
+   continue;
+  if (block.userState() & FormattedFlag)
+   block.layout()->clearAdditionalFormats();
+  block.setUserState(-1);
+ }
+ doc->markContentsDirty(0, doc->characterCount());
+}
+
+void DLazyHighlighter::fontSettingsChanged()
+{
+ static QVector<TextStyle> categories;
+ if (categories.isEmpty())
+ {
+  categories << C_NUMBER
+             << C_STRING
+             << C_TYPE
+             << C_KEYWORD
+             << C_OPERATOR
+             << C_PREPROCESSOR
+             << C_LABEL
+             << C_COMMENT
+             << C_DOXYGEN_COMMENT
+             << C_DOXYGEN_TAG
+             << C_VISUAL_WHITESPACE;
+ }
+ const FontSettings &fs = TextEditorSettings::instance()->fontSettings();
+ m_formats.clear();
+ foreach (TextStyle style, categories)
+  m_formats.append(fs.toTextCharFormat(style));
+
+ // Force the visible blocks to be formatted again with the new colors.
+ QTextDocument *doc = m_editor->document();
+ for (QTextBlock block = doc->begin(); block.isValid(); block = block.next())
+  if (block.userState() != -1)
+   block.setUserState(block.userState() & ~FormattedFlag);
+ highlightVisibleBlocks();
+}
+
+void DLazyHighlighter::updateRequest(const QRect &rect, int dy)
+{
+ Q_UNUSED(rect)
+ Q_UNUSED(dy)
+ highlightVisibleBlocks();
+}
+
+void DLazyHighlighter::highlightVisibleBlocks()
+{
+ QTextBlock block = m_editor->cursorForPosition(QPoint(0, 0)).block();
+ const QTextBlock last =
+   m_editor->cursorForPosition(QPoint(0, m_editor->viewport()->height())).block();
+ if (!block.isValid())
+  return;
+
+ int state = lexerStateBefore(block);
+ while (block.isValid())
+ {
+  const int userState = block.userState();
+  if (userState != -1 && (userState & FormattedFlag))
+   state = userState & LexerStateMask;
+  else
+   state = lexBlock(block, state, true);
+  if (block == last)
+   break;
+  block = block.next();
+ }
+}
+
+/**
+ * Returns the lexer state at the start of @p block. Only the blocks between
+ * the nearest block with a known state and @p block are lexed, and that
+ * is done without producing formats.
+ */
+int DLazyHighlighter::lexerStateBefore(const QTextBlock &block)
+{
+ QTextBlock known = block.previous();
+ while (known.isValid() && known.userState() == -1)
+  known = known.previous();
+
+ int state = known.isValid() ? (known.userState() & LexerStateMask) : 0;
+ QTextBlock it = known.isValid() ? known.next() : block.document()->begin();
+ for (; it.isValid() && it != block; it = it.next())
+  state = lexBlock(it, state, false);
+ return state;
+}
+
+int DLazyHighlighter::lexBlock(const QTextBlock &block, int state, bool applyFormats)
+{
+ const QString text = block.text();
+
+ SimpleLexer tokenize;
+ tokenize.setQtMocRunEnabled(false);
+ tokenize.setObjCEnabled(false);
+ tokenize.setCxx0xEnabled(true);
+ QList<Token> tokens = tokenize(text, state);
+ const int endState = tokenize.state() & LexerStateMask;
+
+ QTextBlock b = block;
+ if (!applyFormats)
+ {
+  b.setUserState(endState);
+  return endState;
+ }
+
+ DEditorHighlighter::correctTokens(tokens, text);
+
+ QList<QTextLayout::FormatRange> ranges;
+ foreach (const Token &tk, tokens)
+ {
+  int format = -1;
+  if (tk.is(T_NUMERIC_LITERAL))
+   format = CppNumberFormat;
+  else if (tk.isStringLiteral() || tk.isCharLiteral())
+   format = CppStringFormat;
+  else if (tk.isComment())
+   format = (tk.is(T_COMMENT) || tk.is(T_CPP_COMMENT)) ? CppCommentFormat : CppDoxygenCommentFormat;
+  else if (tk.isKeyword())
+   format = CppKeywordFormat;
+  else if (tk.is(T_IDENTIFIER) && text.at(tk.begin()).isUpper())
+   format = CppTypeFormat;
+  if (format == -1)
+   continue;
+
+  QTextLayout::FormatRange range;
+  range.start = tk.begin();
+  range.length = tk.length();
+  range.format = m_formats.at(format);
+  ranges.append(range);
+ }
+
+ b.layout()->setAdditionalFormats(ranges);
+ b.setUserState(endState | FormattedFlag);
+ m_editor->document()->markContentsDirty(b.position(), b.length());
+ return endState;
+}
@@ -0,0 +1,56 @@
+#ifndef DLAZYHIGHLIGHTER_H
+#define DLAZYHIGHLIGHTER_H
+
+#include <QObject>
+#include <QTextBlock>
+#include <QTextCharFormat>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QRect;
+QT_END_NAMESPACE
+
+namespace TextEditor {
+class BaseTextEditorWidget;
+}
+
+namespace DEditor {
+namespace Internal {
+
+/**
+ * Lexical-only highlighter for files opened in large-file mode.
+ * Unlike DEditorHighlighter it does not run over the whole document:
+ * only the blocks that become visible are lexed and formatted, and the
+ * lexer end state is kept in QTextBlock::userState() so no per-block
+ * user data is allocated.
+ */
+class DLazyHighlighter : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DLazyHighlighter(TextEditor::BaseTextEditorWidget *editor);
+ ~DLazyHighlighter();
+
+ /// Drops all formats applied so far and detaches from the editor.
+ void clear();
+
+public slots:
+ void highlightVisibleBlocks();
+
+private slots:
+ void updateRequest(const QRect &rect, int dy);
+ void fontSettingsChanged();
+
+private:
+ int lexerStateBefore(const QTextBlock &block);
+ int lexBlock(const QTextBlock &block, int state, bool applyFormats);
+
+ TextEditor::BaseTextEditorWidget *m_editor;
+ QVector<QTextCharFormat> m_formats;
+};
+
+} // namespace Internal
+} // namespace DEditor
+
+#endif // DLAZYHIGHLIGHTER_H
@@ -0,0 +1,239 @@
+#include "dsourcescanner.h"
+
+using namespace DEditor;
+
+namespace
+{
+inline bool isIdentifierStart(QChar ch)
+{
+ return ch.isLetter() || ch == QLatin1Char('_');
+}
+inline bool isIdentifierChar(QChar ch)
+{
+ return ch.isLetterOrNumber() || ch == QLatin1Char('_');
+}
+} // Anonymous
+
+DSourceScanner::DSourceScanner(const QString &text)
+ : m_text(text), m_pos(0), m_line(1), m_lineStart(0)
+{
+}
+
+QChar DSourceScanner::peek(int offset) const
+{
+ const int pos = m_pos + offset;
+ return pos < m_text.length() ? m_text.at(pos) : QChar();
+}
+
+void DSourceScanner::advance(int count)
+{
+ for (; count > 0 && m_pos < m_text.length(); --count)
+ {
+  if (m_text.at(m_pos) == QLatin1Char('\n'))
+  {
+   ++m_line;
+   m_lineStart = m_pos + 1;
+  }
+  ++m_pos;
+ }
+}
+
+QString DSourceScanner::lineText(const Token &tk) const
+{
+ int start = tk.begin - tk.column;
+ int end = m_text.indexOf(QLatin1Char('\n'), tk.begin);
+ if (end == -1)
+  end = m_text.length();
+ if (end > start && m_text.at(end - 1) == QLatin1Char('\r'))
+  --end;
+ return m_text.mid(start, end - start);
+}
+
+DSourceScanner::Token DSourceScanner::next()
+{
+ const int length = m_text.length();
+ while (m_pos < length)
+ {
+  const QChar ch = m_text.at(m_pos);
+  if (ch.isSpace())
+  {
+   advance();
+   continue;
+  }
+  if (ch == QLatin1Char('/'))
+  {
+   const QChar n = peek(1);
+   if (n == QLatin1Char('/')) { skipLineComment(); continue; }
+   if (n == QLatin1Char('*')) { skipBlockComment(); continue; }
+   if (n == QLatin1Char('+')) { skipNestedComment(); continue; }
+  }
+
+  Token tk;
+  tk.begin = m_pos;
+  tk.line = m_line;
+  tk.column = m_pos - m_lineStart;
+
+  const QChar n = peek(1);
+  if ((ch == QLatin1Char('r') || ch == QLatin1Char('x')) && n == QLatin1Char('"'))
+  {
+   advance();
+   skipQuoted(QLatin1Char('"'), false);
+   tk.kind = String;
+  }
+  else if (ch == QLatin1Char('q') && n == QLatin1Char('"'))
+  {
+   skipDelimitedString();
+   tk.kind = String;
+  }
+  else if (isIdentifierStart(ch))
+  {
+   do { ++m_pos; }
+   while (m_pos < length && isIdentifierChar(m_text.at(m_pos)));
+   tk.kind = Identifier;
+  }
+  else if (ch.isDigit())
+  {
+   do { ++m_pos; }
+   while (m_pos < length
+          && (isIdentifierChar(m_text.at(m_pos))
+              || (m_text.at(m_pos) == QLatin1Char('.') && peek(1) != QLatin1Char('.')
+                  && !isIdentifierStart(peek(1)))));
+   tk.kind = Number;
+  }
+  else if (ch == QLatin1Char('"'))
+  {
+   skipQuoted(ch, true);
+   tk.kind = String;
+  }
+  else if (ch == QLatin1Char('`'))
+  {
+   skipQuoted(ch, false);
+   tk.kind = String;
+  }
+  else if (ch == QLatin1Char('\''))
+  {
+   skipQuoted(ch, true);
+   tk.kind = Character;
+  }
+  else
+  {
+   advance();
+   tk.kind = Punctuation;
+  }
+  // string postfix: "abc"c, "abc"w, "abc"d
+  if (tk.kind == String && m_pos < length
+      && (m_text.at(m_pos) == QLatin1Char('c') || m_text.at(m_pos) == QLatin1Char('w')
+          || m_text.at(m_pos) == QLatin1Char('d')))
+   ++m_pos;
+
+  tk.length = m_pos - tk.begin;
+  return tk;
+ }
+
+ Token eof;
+ eof.begin = length;
+ eof.line = m_line;
+ eof.column = m_pos - m_lineStart;
+ return eof;
+}
+
+void DSourceScanner::skipLineComment()
+{
+ while (m_pos < m_text.length() && m_text.at(m_pos) != QLatin1Char('\n'))
+  ++m_pos;
+}
+
+void DSourceScanner::skipBlockComment()
+{
+ advance(2);
+ while (m_pos < m_text.length())
+ {
+  if (m_text.at(m_pos) == QLatin1Char('*') && peek(1) == QLatin1Char('/'))
+  {
+   advance(2);
+   return;
+  }
+  advance();
+ }
+}
+
+void DSourceScanner::skipNestedComment()
+{
+ int depth = 0;
+ while (m_pos < m_text.length())
+ {
+  const QChar ch = m_text.at(m_pos);
+  if (ch == QLatin1Char('/') && peek(1) == QLatin1Char('+'))
+  {
+   ++depth;
+   advance(2);
+  }
+  else if (ch == QLatin1Char('+') && peek(1) == QLatin1Char('/'))
+  {
+   advance(2);
+   if (--depth == 0)
+    return;
+  }
+  else
+   advance();
+ }
+}
+
+void DSourceScanner::skipQuoted(QChar quote, bool escapes)
+{
+ advance(); // opening quote
+ while (m_pos < m_text.length())
+ {
+  const QChar ch = m_text.at(m_pos);
+  if (escapes && ch == QLatin1Char('\\'))
+  {
+   advance(2);
+   continue;
+  }
+  advance();
+  if (ch == quote)
+   return;
+ }
+}
+
+// q"(...)", q"[...]", q"{...}", q"<...>", q"/.../" and q"EOS ... EOS"
+void DSourceScanner::skipDelimitedString()
+{
+ advance(2); // q"
+ if (m_pos >= m_text.length())
+  return;
+
+ const QChar open = m_text.at(m_pos);
+ QChar close = open;
+ if (open == QLatin1Char('(')) close = QLatin1Char(')');
+ else if (open == QLatin1Char('[')) close = QLatin1Char(']');
+ else if (open == QLatin1Char('{')) close = QLatin1Char('}');
+ else if (open == QLatin1Char('<')) close = QLatin1Char('>');
+ else if (isIdentifierStart(open))
+ {
+  // heredoc style: the identifier ends the string when it starts a line
+  int end = m_pos;
+  while (end < m_text.length() && isIdentifierChar(m_text.at(end)))
+   ++end;
+  const QString delimiter = QLatin1Char('\n') + m_text.mid(m_pos, end - m_pos) + QLatin1Char('"');
+  const int found = m_text.indexOf(delimiter, end);
+  advance((found == -1 ? m_text.length() : found + delimiter.length()) - m_pos);
+  return;
+ }
+
+ int depth = 0;
+ advance();
+ while (m_pos < m_text.length())
+ {
+  const QChar ch = m_text.at(m_pos);
+  advance();
+  if (ch == open && open != close)
+   ++depth;
+  else if (ch == close && depth-- == 0)
+  {
+   if (m_pos < m_text.length() && m_text.at(m_pos) == QLatin1Char('"'))
+    advance();
+   return;
+  }
+ }
+}
@@ -0,0 +1,69 @@
+#ifndef DSOURCESCANNER_H
+#define DSOURCESCANNER_H
+
+#include "deditor_global.h"
+
+#include <QString>
+#include <QStringRef>
+
+namespace DEditor {
+
+/**
+ * Minimal forward-only D tokenizer. It only knows enough of the language to
+ * skip comments (including nested /+ +/ ones), string and character literals,
+ * so callers can look at real identifiers and punctuation without a parser.
+ * Used by find usages, the symbol index and the import scanner.
+ */
+class DEDITORSHARED_EXPORT DSourceScanner
+{
+public:
+ enum Kind
+ {
+  EndOfFile,
+  Identifier,
+  Number,
+  String,
+  Character,
+  Punctuation
+ };
+
+ struct Token
+ {
+  Token() : kind(EndOfFile), begin(0), length(0), line(0), column(0) {}
+
+  Kind kind;
+  int begin;
+  int length;
+  int line;   // 1-based
+  int column; // 0-based, in characters
+
+  bool is(Kind k) const { return kind == k; }
+ };
+
+ explicit DSourceScanner(const QString &text);
+
+ Token next();
+ QStringRef text(const Token &tk) const { return QStringRef(&m_text, tk.begin, tk.length); }
+ QChar punctuation(const Token &tk) const { return m_text.at(tk.begin); }
+
+ /// Returns the whole line containing @p tk, without the line terminator.
+ QString lineText(const Token &tk) const;
+
+private:
+ QChar peek(int offset = 0) const;
+ void advance(int count = 1);
+ void skipLineComment();
+ void skipBlockComment();
+ void skipNestedComment();
+ void skipQuoted(QChar quote, bool escapes);
+ void skipDelimitedString();
+
+ const QString &m_text;
+ int m_pos;
+ int m_line;
+ int m_lineStart;
+};
+
+} // namespace DEditor
+
+#endif // DSOURCESCANNER_H
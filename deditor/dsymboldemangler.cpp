@@ -0,0 +1,968 @@
+#include "dsymboldemangler.h"
+
+namespace DEditor {
+
+namespace {
+const int MAX_DEPTH = 64;
+
+bool isDigit(char c)
+{
+ return c >= '0' && c <= '9';
+}
+
+bool isIdentifierChar(ushort c)
+{
+ return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isCallConvention(char c)
+{
+ return c == 'F' || c == 'U' || c == 'W' || c == 'V' || c == 'R' || c == 'Y';
+}
+
+/// Pascal and Objective-C functions do not nest and would be ambiguous there.
+bool isNameCallConvention(char c)
+{
+ return c == 'F' || c == 'U' || c == 'W' || c == 'R';
+}
+
+const char *basicType(char c)
+{
+ switch (c)
+ {
+ case 'v': return "void";
+ case 'g': return "byte";
+ case 'h': return "ubyte";
+ case 's': return "short";
+ case 't': return "ushort";
+ case 'i': return "int";
+ case 'k': return "uint";
+ case 'l': return "long";
+ case 'm': return "ulong";
+ case 'f': return "float";
+ case 'd': return "double";
+ case 'e': return "real";
+ case 'o': return "ifloat";
+ case 'p': return "idouble";
+ case 'j': return "ireal";
+ case 'q': return "cfloat";
+ case 'r': return "cdouble";
+ case 'c': return "creal";
+ case 'b': return "bool";
+ case 'a': return "char";
+ case 'u': return "wchar";
+ case 'w': return "dchar";
+ case 'n': return "typeof(null)";
+ default: return 0;
+ }
+}
+
+const char *functionAttribute(char c)
+{
+ switch (c)
+ {
+ case 'a': return "pure";
+ case 'b': return "nothrow";
+ case 'c': return "ref";
+ case 'd': return "@property";
+ case 'e': return "@trusted";
+ case 'f': return "@safe";
+ case 'i': return "@nogc";
+ case 'j': return "return";
+ case 'l': return "scope";
+ case 'm': return "@live";
+ default: return 0;
+ }
+}
+
+/** Recursive descent over one mangled name, see the ABI page of the D spec. */
+class Decoder
+{
+public:
+ Decoder(const char *data, int size)
+  : m_data(data), m_size(size), m_pos(0), m_depth(0)
+ {
+ }
+
+ bool mangledName(QByteArray &out);
+ bool atEnd() const { return m_pos >= m_size; }
+
+private:
+ struct Function
+ {
+  Function() : isFunction(false) {}
+  bool isFunction;
+  QByteArray convention;
+  QByteArray attributes;
+ };
+
+ char peek(int offset = 0) const
+ {
+  return m_pos + offset < m_size ? m_data[m_pos + offset] : '\0';
+ }
+ bool number(int &value);
+ bool backReference(int &position);
+ bool isSymbolNameFront();
+ bool qualifiedName(QByteArray &out, Function *last = 0);
+ bool symbolName(QByteArray &out);
+ bool templateInstance(QByteArray &out, int end);
+ bool templateArguments(QByteArray &out);
+ bool value(QByteArray &out, char type, const QByteArray &typeName);
+ bool hexFloat(QByteArray &out);
+ bool literalString(QByteArray &out, char width);
+ bool type(QByteArray &out, char *kind = 0);
+ bool typeModifiers(QByteArray &out);
+ bool functionArguments(Function &function, QByteArray &parameters);
+ bool parameters(QByteArray &out);
+ bool functionType(QByteArray &out, const char *keyword);
+
+ const char *m_data;
+ const int m_size;
+ int m_pos;
+ int m_depth;
+};
+
+/// Keeps the recursion depth of a decoder bounded for hostile input.
+class DepthGuard
+{
+public:
+ explicit DepthGuard(int &depth) : m_depth(depth) { ++m_depth; }
+ ~DepthGuard() { --m_depth; }
+ bool exceeded() const { return m_depth > MAX_DEPTH; }
+
+private:
+ int &m_depth;
+};
+
+bool Decoder::number(int &value)
+{
+ if (!isDigit(peek()))
+  return false;
+ qint64 result = 0;
+ while (isDigit(peek()))
+ {
+  result = result * 10 + (peek() - '0');
+  if (result > m_size)
+   return false;
+  ++m_pos;
+ }
+ value = int(result);
+ return true;
+}
+
+/// Q followed by a base 26 offset back from the Q: A-Z continue, a-z end.
+bool Decoder::backReference(int &position)
+{
+ const int start = m_pos;
+ ++m_pos;
+ qint64 offset = 0;
+ while (peek() >= 'A' && peek() <= 'Z')
+ {
+  offset = offset * 26 + (peek() - 'A');
+  if (offset > start)
+   return false;
+  ++m_pos;
+ }
+ if (peek() < 'a' || peek() > 'z')
+  return false;
+ offset = offset * 26 + (peek() - 'a');
+ ++m_pos;
+ if (offset <= 0 || offset > start)
+  return false;
+ position = start - int(offset);
+ return true;
+}
+
+bool Decoder::isSymbolNameFront()
+{
+ const char c = peek();
+ if (isDigit(c))
+  return true;
+ if (c == '_')
+  return peek(1) == '_' && (peek(2) == 'T' || peek(2) == 'U');
+ if (c != 'Q')
+  return false;
+ // a back reference to an identifier, not to a type
+ const int pos = m_pos;
+ int target;
+ const bool identifier = backReference(target) && (isDigit(m_data[target]) || m_data[target] == '_');
+ m_pos = pos;
+ return identifier;
+}
+
+bool Decoder::mangledName(QByteArray &out)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded() || peek() != '_' || peek(1) != 'D')
+  return false;
+ m_pos += 2;
+ if (m_size - m_pos == 4 && qstrncmp(m_data + m_pos, "main", 4) == 0)
+ {
+  m_pos += 4;
+  out += "D main";
+  return true;
+ }
+
+ QByteArray name;
+ Function function;
+ if (!qualifiedName(name, &function))
+  return false;
+ if (atEnd() || peek() == 'Z')
+ {
+  if (!atEnd())
+   ++m_pos;
+  out += name;
+  return true;
+ }
+ QByteArray result;
+ if (!type(result))
+  return false;
+ if (function.isFunction)
+ {
+  out += function.convention;
+  out += function.attributes;
+ }
+ out += result;
+ out += ' ';
+ out += name;
+ return true;
+}
+
+/**
+ * Names separated by dots. A function along the way, a parent of a nested
+ * symbol or the symbol itself, is followed by its parameters but not by its
+ * return type; @a last tells whether the last name is a function.
+ */
+bool Decoder::qualifiedName(QByteArray &out, Function *last)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded())
+  return false;
+ int count = 0;
+ do
+ {
+  if (count++)
+   out += '.';
+  if (!symbolName(out))
+   return false;
+
+  // the same letters follow type names in parameter lists, so back off
+  // when this does not look like a function
+  Function function;
+  QByteArray modifiers;
+  const int pos = m_pos;
+  if (peek() == 'M')
+  {
+   ++m_pos;
+   typeModifiers(modifiers);
+  }
+  QByteArray params;
+  if (isNameCallConvention(peek()) && functionArguments(function, params))
+  {
+   out += '(';
+   out += params;
+   out += ')';
+   if (!modifiers.isEmpty())
+   {
+    out += ' ';
+    out += modifiers;
+   }
+  }
+  else
+  {
+   m_pos = pos;
+   function = Function();
+  }
+  if (last)
+   *last = function;
+ } while (isSymbolNameFront());
+ return true;
+}
+
+bool Decoder::symbolName(QByteArray &out)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded())
+  return false;
+ const char c = peek();
+ if (c == 'Q')
+ {
+  int target;
+  if (!backReference(target))
+   return false;
+  const int pos = m_pos;
+  m_pos = target;
+  const bool ok = symbolName(out);
+  m_pos = pos;
+  return ok;
+ }
+ if (c == '_')
+  return templateInstance(out, -1);
+
+ int length;
+ if (!number(length) || length > m_size - m_pos)
+  return false;
+ if (length == 0)
+ {
+  out += "__anonymous";
+  return true;
+ }
+ if (length >= 3 && peek() == '_' && peek(1) == '_' && (peek(2) == 'T' || peek(2) == 'U'))
+  return templateInstance(out, m_pos + length);
+ out.append(m_data + m_pos, length);
+ m_pos += length;
+ return true;
+}
+
+/// __T name args Z, ending at @a end when the instance was length prefixed.
+bool Decoder::templateInstance(QByteArray &out, int end)
+{
+ m_pos += 3;
+ int length;
+ if (!number(length) || length > m_size - m_pos)
+  return false;
+ out.append(m_data + m_pos, length);
+ m_pos += length;
+ out += "!(";
+ if (!templateArguments(out))
+  return false;
+ out += ')';
+ if (end >= 0)
+ {
+  if (m_pos > end)
+   return false;
+  m_pos = end;
+ }
+ return true;
+}
+
+bool Decoder::templateArguments(QByteArray &out)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded())
+  return false;
+ for (int count = 0; peek() != 'Z'; ++count)
+ {
+  if (peek() == 'H') // specialized parameter
+   ++m_pos;
+  if (count)
+   out += ", ";
+  switch (peek())
+  {
+  case 'T':
+   ++m_pos;
+   if (!type(out))
+    return false;
+   break;
+  case 'V':
+  {
+   ++m_pos;
+   char kind = 0;
+   QByteArray typeName;
+   if (!type(typeName, &kind) || !value(out, kind, typeName))
+    return false;
+   break;
+  }
+  case 'S':
+  {
+   ++m_pos;
+   // an older compiler puts the whole mangled name with a length
+   const int pos = m_pos;
+   int length;
+   if (number(length) && peek() == '_' && peek(1) == 'D' && length <= m_size - m_pos)
+   {
+    Decoder symbol(m_data + m_pos, length);
+    QByteArray name;
+    if (symbol.mangledName(name) && symbol.atEnd())
+    {
+     out += name;
+     m_pos += length;
+     break;
+    }
+   }
+   m_pos = pos;
+   if (!qualifiedName(out))
+    return false;
+   break;
+  }
+  case 'X':
+  {
+   ++m_pos;
+   int length;
+   if (!number(length) || length > m_size - m_pos)
+    return false;
+   out.append(m_data + m_pos, length);
+   m_pos += length;
+   break;
+  }
+  default:
+   return false;
+  }
+ }
+ ++m_pos;
+ return true;
+}
+
+bool Decoder::value(QByteArray &out, char type, const QByteArray &typeName)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded())
+  return false;
+ const char c = peek();
+ ++m_pos;
+ switch (c)
+ {
+ case 'n':
+  out += "null";
+  return true;
+ case 'i':
+ case 'N':
+ {
+  const int start = m_pos;
+  while (isDigit(peek()))
+   ++m_pos;
+  if (start == m_pos)
+   return false;
+  const QByteArray digits(m_data + start, m_pos - start);
+  if (type == 'b')
+  {
+   out += digits == "0" ? "false" : "true";
+  }
+  else if ((type == 'a' || type == 'u' || type == 'w') && c == 'i' && digits.size() < 4
+           && digits.toInt() >= 0x20 && digits.toInt() < 0x7f)
+  {
+   out += '\'';
+   out += char(digits.toInt());
+   out += '\'';
+  }
+  else
+  {
+   if (c == 'N')
+    out += '-';
+   out += digits;
+   if (type == 'k' || type == 'm')
+    out += 'u';
+   if (type == 'l' || type == 'm')
+    out += 'L';
+  }
+  return true;
+ }
+ case 'e':
+  return hexFloat(out);
+ case 'c':
+  if (!hexFloat(out) || peek() != 'c')
+   return false;
+  ++m_pos;
+  out += '+';
+  if (!hexFloat(out))
+   return false;
+  out += 'i';
+  return true;
+ case 'a':
+ case 'w':
+ case 'd':
+  return literalString(out, c);
+ case 'A':
+ case 'H':
+ case 'S':
+ {
+  int count;
+  if (!number(count))
+   return false;
+  if (c == 'S')
+   out += typeName;
+  out += c == 'S' ? '(' : '[';
+  for (int i = 0; i < count; ++i)
+  {
+   if (i)
+    out += ", ";
+   if (!value(out, 0, QByteArray()))
+    return false;
+   if (c == 'H')
+   {
+    out += ':';
+    if (!value(out, 0, QByteArray()))
+     return false;
+   }
+  }
+  out += c == 'S' ? ')' : ']';
+  return true;
+ }
+ case 'f':
+  return mangledName(out);
+ default:
+  return false;
+ }
+}
+
+/// HexFloat: NAN, INF, NINF or N? hex digits P N? exponent.
+bool Decoder::hexFloat(QByteArray &out)
+{
+ static const char *const specials[] = { "NAN", "INF", "NINF" };
+ static const char *const names[] = { "nan", "inf", "-inf" };
+ for (int i = 0; i < 3; ++i)
+ {
+  const int length = int(qstrlen(specials[i]));
+  if (m_size - m_pos >= length && qstrncmp(m_data + m_pos, specials[i], length) == 0
+      && (peek(length) != 'F' || i != 1))
+  {
+   m_pos += length;
+   out += names[i];
+   return true;
+  }
+ }
+ if (peek() == 'N')
+ {
+  out += '-';
+  ++m_pos;
+ }
+ out += "0x";
+ const int start = m_pos;
+ while (isDigit(peek()) || (peek() >= 'A' && peek() <= 'F'))
+  ++m_pos;
+ if (start == m_pos || peek() != 'P')
+  return false;
+ out += m_data[start];
+ if (m_pos - start > 1)
+ {
+  out += '.';
+  out.append(m_data + start + 1, m_pos - start - 1);
+ }
+ ++m_pos;
+ out += 'p';
+ if (peek() == 'N')
+ {
+  out += '-';
+  ++m_pos;
+ }
+ const int exponent = m_pos;
+ while (isDigit(peek()))
+  ++m_pos;
+ if (exponent == m_pos)
+  return false;
+ out.append(m_data + exponent, m_pos - exponent);
+ return true;
+}
+
+/// Number of code units, '_', the units in hex: a for char, w wchar, d dchar.
+bool Decoder::literalString(QByteArray &out, char width)
+{
+ int count;
+ if (!number(count) || peek() != '_')
+  return false;
+ ++m_pos;
+ const int digits = width == 'a' ? 2 : width == 'w' ? 4 : 8;
+ if (qint64(count) * digits > m_size - m_pos)
+  return false;
+ QString text;
+ QByteArray bytes;
+ for (int i = 0; i < count; ++i)
+ {
+  bool ok;
+  const uint unit = QByteArray(m_data + m_pos, digits).toUInt(&ok, 16);
+  if (!ok)
+   return false;
+  m_pos += digits;
+  if (width == 'a')
+   bytes += char(unit);
+  else if (width == 'w')
+   text += QChar(ushort(unit));
+  else
+   text += QString::fromUcs4(&unit, 1);
+ }
+ out += '"';
+ out += width == 'a' ? bytes : text.toUtf8();
+ out += '"';
+ if (width != 'a')
+  out += width;
+ return true;
+}
+
+bool Decoder::typeModifiers(QByteArray &out)
+{
+ forever
+ {
+  const char *modifier = 0;
+  if (peek() == 'x')
+   modifier = "const";
+  else if (peek() == 'y')
+   modifier = "immutable";
+  else if (peek() == 'O')
+   modifier = "shared";
+  else if (peek() == 'N' && peek(1) == 'g')
+   modifier = "inout";
+  else
+   return true;
+  m_pos += peek() == 'N' ? 2 : 1;
+  if (!out.isEmpty())
+   out += ' ';
+  out += modifier;
+ }
+}
+
+/// Calling convention, attributes and parameters; the return type is left.
+bool Decoder::functionArguments(Function &function, QByteArray &params)
+{
+ function.isFunction = true;
+ switch (peek())
+ {
+ case 'U': function.convention = "extern(C) "; break;
+ case 'W': function.convention = "extern(Windows) "; break;
+ case 'V': function.convention = "extern(Pascal) "; break;
+ case 'R': function.convention = "extern(C++) "; break;
+ case 'Y': function.convention = "extern(Objective-C) "; break;
+ default: break;
+ }
+ ++m_pos;
+ while (peek() == 'N')
+ {
+  const char *attribute = functionAttribute(peek(1));
+  if (!attribute)
+   break;
+  m_pos += 2;
+  function.attributes += attribute;
+  function.attributes += ' ';
+ }
+ return parameters(params);
+}
+
+bool Decoder::parameters(QByteArray &out)
+{
+ for (int count = 0; ; ++count)
+ {
+  switch (peek())
+  {
+  case 'X':
+   ++m_pos;
+   out += "...";
+   return true;
+  case 'Y':
+   ++m_pos;
+   out += count ? ", ..." : "...";
+   return true;
+  case 'Z':
+   ++m_pos;
+   return true;
+  default:
+   break;
+  }
+  if (count)
+   out += ", ";
+  forever
+  {
+   if (peek() == 'I')
+    out += "in ";
+   else if (peek() == 'J')
+    out += "out ";
+   else if (peek() == 'K')
+    out += "ref ";
+   else if (peek() == 'L')
+    out += "lazy ";
+   else if (peek() == 'M')
+    out += "scope ";
+   else if (peek() == 'N' && peek(1) == 'k')
+   {
+    out += "return ";
+    ++m_pos;
+   }
+   else
+    break;
+   ++m_pos;
+  }
+  if (!type(out))
+   return false;
+ }
+}
+
+bool Decoder::functionType(QByteArray &out, const char *keyword)
+{
+ Function function;
+ QByteArray params;
+ QByteArray result;
+ if (!functionArguments(function, params) || !type(result))
+  return false;
+ out += function.convention;
+ out += result;
+ out += ' ';
+ out += keyword;
+ out += '(';
+ out += params;
+ out += ')';
+ if (!function.attributes.isEmpty())
+ {
+  out += ' ';
+  out += function.attributes;
+  out.chop(1);
+ }
+ return true;
+}
+
+bool Decoder::type(QByteArray &out, char *kind)
+{
+ DepthGuard guard(m_depth);
+ if (guard.exceeded())
+  return false;
+ const char c = peek();
+ if (kind)
+  *kind = c;
+ if (const char *basic = basicType(c))
+ {
+  ++m_pos;
+  out += basic;
+  return true;
+ }
+ switch (c)
+ {
+ case 'x':
+ case 'y':
+ case 'O':
+ {
+  QByteArray modifier;
+  if (!typeModifiers(modifier))
+   return false;
+  // "const(shared(int))" for "xOi"
+  const QList<QByteArray> modifiers = modifier.split(' ');
+  for (int i = 0; i < modifiers.size(); ++i)
+  {
+   out += modifiers.at(i);
+   out += '(';
+  }
+  if (!type(out))
+   return false;
+  for (int i = 0; i < modifiers.size(); ++i)
+   out += ')';
+  return true;
+ }
+ case 'N':
+  m_pos += 2;
+  switch (peek(-1))
+  {
+  case 'g':
+   out += "inout(";
+   break;
+  case 'h':
+   out += "__vector(";
+   break;
+  case 'n':
+   out += "typeof(null)";
+   return true;
+  default:
+   return false;
+  }
+  if (!type(out))
+   return false;
+  out += ')';
+  return true;
+ case 'A':
+  ++m_pos;
+  if (!type(out))
+   return false;
+  out += "[]";
+  return true;
+ case 'G':
+ {
+  ++m_pos;
+  int length;
+  if (!number(length) || !type(out))
+   return false;
+  out += '[';
+  out += QByteArray::number(length);
+  out += ']';
+  return true;
+ }
+ case 'H':
+ {
+  ++m_pos;
+  QByteArray key;
+  if (!type(key) || !type(out))
+   return false;
+  out += '[';
+  out += key;
+  out += ']';
+  return true;
+ }
+ case 'P':
+  ++m_pos;
+  if (isCallConvention(peek()))
+   return functionType(out, "function");
+  if (!type(out))
+   return false;
+  out += '*';
+  return true;
+ case 'F':
+ case 'U':
+ case 'W':
+ case 'V':
+ case 'R':
+ case 'Y':
+  return functionType(out, "function");
+ case 'D':
+ {
+  ++m_pos;
+  QByteArray modifiers;
+  if (!typeModifiers(modifiers) || !isCallConvention(peek()) || !functionType(out, "delegate"))
+   return false;
+  if (!modifiers.isEmpty())
+  {
+   out += ' ';
+   out += modifiers;
+  }
+  return true;
+ }
+ case 'I':
+ case 'C':
+ case 'S':
+ case 'E':
+ case 'T':
+  ++m_pos;
+  return qualifiedName(out);
+ case 'B':
+ {
+  ++m_pos;
+  int count;
+  if (!number(count))
+   return false;
+  out += "Tuple!(";
+  for (int i = 0; i < count; ++i)
+  {
+   if (i)
+    out += ", ";
+   if (!type(out))
+    return false;
+  }
+  out += ')';
+  return true;
+ }
+ case 'Q':
+ {
+  int target;
+  if (!backReference(target))
+   return false;
+  const int pos = m_pos;
+  m_pos = target;
+  const bool ok = type(out, kind);
+  m_pos = pos;
+  return ok;
+ }
+ case 'z':
+  m_pos += 2;
+  if (peek(-1) == 'i')
+   out += "cent";
+  else if (peek(-1) == 'k')
+   out += "ucent";
+  else
+   return false;
+  return true;
+ default:
+  return false;
+ }
+}
+} // namespace
+
+DSymbolDemangler::DSymbolDemangler(QObject *parent)
+ : QObject(parent)
+{
+}
+
+QByteArray DSymbolDemangler::demangle(const QByteArray &symbol, bool *ok)
+{
+ if (ok)
+  *ok = false;
+ int begin = 0;
+ if (symbol.startsWith('\1'))
+  ++begin;
+ if (symbol.size() - begin > 2 && symbol.at(begin) == '_' && symbol.at(begin + 1) == '_'
+     && symbol.at(begin + 2) == 'D')
+  ++begin; // the extra underscore of OS X and 32 bit Windows
+ if (symbol.size() - begin < 3 || symbol.at(begin) != '_' || symbol.at(begin + 1) != 'D')
+  return symbol;
+
+ // a mangled name has no dots, gcc and llvm append clone suffixes with one
+ int end = symbol.indexOf('.', begin);
+ if (end < 0)
+  end = symbol.size();
+
+ Decoder decoder(symbol.constData() + begin, end - begin);
+ QByteArray result;
+ result.reserve(symbol.size() * 2);
+ if (!decoder.mangledName(result) || !decoder.atEnd())
+  return symbol;
+ if (end < symbol.size())
+ {
+  result += " [clone ";
+  result.append(symbol.constData() + end, symbol.size() - end);
+  result += ']';
+ }
+ if (ok)
+  *ok = true;
+ return result;
+}
+
+QStringList DSymbolDemangler::demangle(const QStringList &symbols)
+{
+ QStringList result;
+ result.reserve(symbols.size());
+ foreach (const QString &symbol, symbols)
+ {
+  bool ok;
+  const QByteArray demangled = demangle(symbol.toLatin1(), &ok);
+  result.append(ok ? QString::fromUtf8(demangled) : symbol);
+ }
+ return result;
+}
+
+QString DSymbolDemangler::demangleText(const QString &text, bool *complete)
+{
+ if (complete)
+  *complete = true;
+ QString result;
+ int copied = 0;
+ const int size = text.size();
+ for (int i = 0; i < size; )
+ {
+  if (!isIdentifierChar(text.at(i).unicode()))
+  {
+   ++i;
+   continue;
+  }
+  int end = i;
+  while (end < size && isIdentifierChar(text.at(end).unicode()))
+   ++end;
+  // a clone suffix belongs to the symbol
+  while (end + 1 < size && text.at(end) == QLatin1Char('.') && isIdentifierChar(text.at(end + 1).unicode())
+         && text.at(i).unicode() == '_')
+  {
+   ++end;
+   while (end < size && isIdentifierChar(text.at(end).unicode()))
+    ++end;
+  }
+  const QStringRef word = text.midRef(i, end - i);
+  if (word.startsWith(QLatin1String("_D")) || word.startsWith(QLatin1String("__D")))
+  {
+   bool ok;
+   const QByteArray demangled = demangle(word.toLatin1(), &ok);
+   if (ok)
+   {
+    result += text.midRef(copied, i - copied);
+    result += QString::fromUtf8(demangled);
+    copied = end;
+   }
+   else if (complete && word.size() > 3 && (word.at(2).isDigit() || word.at(3).isDigit()))
+   {
+    *complete = false;
+   }
+  }
+  i = end;
+ }
+ if (copied == 0)
+  return text;
+ result += text.midRef(copied);
+ return result;
+}
+
+QStringList DSymbolDemangler::demangleSymbols(const QStringList &symbols) const
+{
+ return demangle(symbols);
+}
+
+} // namespace DEditor
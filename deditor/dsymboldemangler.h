@@ -0,0 +1,41 @@
+#ifndef DSYMBOLDEMANGLER_H
+#define DSYMBOLDEMANGLER_H
+
+#include "deditor_global.h"
+
+#include <QObject>
+#include <QStringList>
+
+namespace DEditor {
+
+/**
+ * Decodes D mangled symbols (_D...) as emitted by dmd, ldc and gdc: qualified
+ * names, function and variable types, template instances with their
+ * arguments, and the back references of the 2.077 mangling. Platform
+ * underscores, ldc's \1 prefix and compiler clone suffixes are accepted.
+ * Everything is static; the plugin puts an instance into the object pool as
+ * "DEditor.SymbolDemangler" so other plugins can use demangleSymbols()
+ * without linking against this one.
+ */
+class DEDITORSHARED_EXPORT DSymbolDemangler : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DSymbolDemangler(QObject *parent = 0);
+
+ /// The demangled @a symbol, or @a symbol itself when it is no D symbol.
+ static QByteArray demangle(const QByteArray &symbol, bool *ok = 0);
+ static QStringList demangle(const QStringList &symbols);
+ /**
+  * Replaces the D symbols in @a text, e.g. a line of linker output.
+  * @a complete is set to false if a symbol could not be decoded.
+  */
+ static QString demangleText(const QString &text, bool *complete = 0);
+
+ Q_INVOKABLE QStringList demangleSymbols(const QStringList &symbols) const;
+};
+
+} // namespace DEditor
+
+#endif // DSYMBOLDEMANGLER_H
@@ -2,20 +2,21 @@
 #include "deditorplugin.h"
 #include "dtexteditor.h"
 //#include "dautocompleter.h"
-//#include "dindenter.h"
+#include "dindenter.h"
 #include "dcompletionassist.h"
 #include "deditorhighlighter.h"
+#include "dlazyhighlighter.h"
 
 #include <coreplugin/coreconstants.h>
 #include <coreplugin/icore.h>
+#include <coreplugin/infobar.h>
 #include <coreplugin/mimedatabase.h>
 #include <extensionsystem/pluginmanager.h>
 #include <texteditor/basetextdocument.h>
 #include <texteditor/normalindenter.h>
 
-#include <cpptools/cppqtstyleindenter.h>
-
 #include <QFileInfo>
+#include <QSettings>
 
 using namespace Core;
 using namespace DEditor::Internal;
@@ -33,6 +34,7 @@ Core::IEditor* DTextEditor::duplicate(QWidget *parent)
 {
  DTextEditorWidget *newWidget = new DTextEditorWidget(parent);
  newWidget->duplicateFrom(editorWidget());
+ newWidget->setLargeFileMode(static_cast<DTextEditorWidget*>(editorWidget())->isLargeFileMode());
  DEditorPlugin::instance()->initializeEditor(newWidget);
  return newWidget->editor();
 }
@@ -45,13 +47,27 @@ Core::Id DTextEditor::id() const
 
 bool DTextEditor::open(QString *errorString, const QString &fileName, const QString &realFileName)
 {
- editorWidget()->setMimeType(Core::MimeDatabase::findByFile(QFileInfo(fileName)).type());
+ DTextEditorWidget *widget = static_cast<DTextEditorWidget*>(editorWidget());
+ widget->setMimeType(Core::MimeDatabase::findByFile(QFileInfo(fileName)).type());
+ // Switch the heavy features off before the text is loaded, not after.
+ if (DTextEditorWidget::isLargeFile(realFileName))
+  widget->setLargeFileMode(true);
  bool b = TextEditor::BaseTextEditor::open(errorString, fileName, realFileName);
+ if (b && widget->isLargeFileMode())
+ {
+  Core::InfoBarEntry info(Core::Id(Constants::INFO_LARGE_FILE_MODE),
+                          tr("The file is large and was opened read-only with highlighting, "
+                             "folding and code completion reduced."));
+  info.setCustomButtonInfo(tr("Enable Full Features"), widget, SLOT(enableFullFeatures()));
+  document()->infoBar()->addInfo(info);
+ }
  return b;
 }
 
 TextEditor::CompletionAssistProvider* DTextEditor::completionAssistProvider()
 {
+ if (static_cast<DTextEditorWidget*>(editorWidget())->isLargeFileMode())
+  return 0;
 	return ExtensionSystem::PluginManager::getObject<DCompletionAssistProvider>();
 }
 //-----------------------------
@@ -59,7 +75,9 @@ TextEditor::CompletionAssistProvider* DTextEditor::completionAssistProvider()
 //-----------------------------
 
 DTextEditorWidget::DTextEditorWidget(QWidget *parent)
-  : BaseTextEditorWidget(parent) // PlainTextEditorWidget(parent)
+  : BaseTextEditorWidget(parent), // PlainTextEditorWidget(parent)
+    m_lazyHighlighter(0),
+    m_largeFileMode(false)
 {
  setRevisionsVisible(true);
  setMarksVisible(true);
@@ -67,11 +85,9 @@ DTextEditorWidget::DTextEditorWidget(QWidget *parent)
  setParenthesesMatchingEnabled(true);
  setCodeFoldingSupported(true);
 
- setIndenter(new CppTools::CppQtStyleIndenter);
- // Indenter вызывает исключения в стандартном hightlighter
- //setIndenter(new DIndenter());
+ setIndenter(new DIndenter());
 
-	new DEditorHighlighter(baseTextDocument().data());
+	m_highlighter = new DEditorHighlighter(baseTextDocument().data());
 
  setMimeType(QLatin1String(DEditor::Constants::D_MIMETYPE_SRC));
  connect(editorDocument(), SIGNAL(changed()), this, SLOT(configure()));
@@ -101,6 +117,61 @@ void DTextEditorWidget::unCommentSelection()
  Utils::unCommentSelection(this);
 }
 
+bool DTextEditorWidget::isLargeFile(const QString &fileName)
+{
+ QSettings *s = Core::ICore::settings();
+ s->beginGroup(QLatin1String(DEditor::Constants::SETTINGS_GROUP));
+ const qint64 threshold = s->value(QLatin1String(DEditor::Constants::LARGE_FILE_THRESHOLD_KEY),
+                                   DEditor::Constants::LARGE_FILE_THRESHOLD_DEFAULT).toLongLong();
+ s->endGroup();
+ if (threshold <= 0)
+  return false;
+ return QFileInfo(fileName).size() >= threshold;
+}
+
+/**
+ * In large-file mode the document is read-only, every feature that keeps
+ * per-block user data (revisions, marks, folding, parentheses) is off and
+ * the full highlighter is replaced by DLazyHighlighter, which only lexes
+ * the blocks that get scrolled into view.
+ */
+void DTextEditorWidget::setLargeFileMode(bool on)
+{
+ if (m_largeFileMode == on)
+  return;
+ m_largeFileMode = on;
+
+ setRevisionsVisible(!on);
+ setMarksVisible(!on);
+ setLineSeparatorsAllowed(!on);
+ setParenthesesMatchingEnabled(!on);
+ setCodeFoldingSupported(!on);
+ setReadOnly(on);
+
+ if (on)
+ {
+  m_highlighter->setDocument(0);
+  m_lazyHighlighter = new DLazyHighlighter(this);
+ }
+ else
+ {
+  if (m_lazyHighlighter)
+  {
+   m_lazyHighlighter->clear();
+   delete m_lazyHighlighter;
+   m_lazyHighlighter = 0;
+  }
+  m_highlighter->setDocument(document());
+ }
+}
+
+void DTextEditorWidget::enableFullFeatures()
+{
+ setLargeFileMode(false);
+ if (editorDocument())
+  editorDocument()->infoBar()->removeInfo(Core::Id(DEditor::Constants::INFO_LARGE_FILE_MODE));
+}
+
 void DTextEditorWidget::configure()
 {
  MimeType mimeType;
@@ -13,6 +13,8 @@ namespace DEditor {
 namespace Internal {
 
 class DTextEditorWidget;
+class DEditorHighlighter;
+class DLazyHighlighter;
 
 class DTextEditor : public TextEditor::BaseTextEditor
 {
@@ -39,8 +41,13 @@ public:
  void configure(const QString& mimeType);
  void configure(const Core::MimeType &mimeType);
 
+ bool isLargeFileMode() const { return m_largeFileMode; }
+ void setLargeFileMode(bool on);
+ static bool isLargeFile(const QString &fileName);
+
 public slots:
  virtual void unCommentSelection();
+ void enableFullFeatures();
 
 private slots:
  void configure();
@@ -51,6 +58,10 @@ signals:
 protected:
  TextEditor::BaseTextEditor *createEditor();
 
+private:
+ DEditorHighlighter *m_highlighter;
+ DLazyHighlighter *m_lazyHighlighter;
+ bool m_largeFileMode;
 };
 
 } // namespace Internal
@@ -5,6 +5,7 @@
 //#include <QAbstractSocket>
 //#include <QHostAddress>
 //#include <QDebug>
+#include <QMutex>
 #include <QProcess>
 //#include <msgpack.hpp>
 
@@ -19,6 +20,9 @@ using namespace QcdAssist;
 
 QString QcdAssist::dcdClient()
 {
+ // also called by the reference search from worker threads
+ static QMutex mutex;
+ QMutexLocker locker(&mutex);
  static QString dcd;
  if(dcd.length() == 0)
  {
@@ -142,6 +146,102 @@ DCDCompletion QcdAssist::sendRequestToDCD(QByteArray& filedata, uint pos)
  return DCDCompletion();
 }
 
+DCDSymbolLocation QcdAssist::findSymbolLocation(QByteArray& filedata, uint pos)
+{
+ QString errorMessage;
+ const DCDSymbolLocation location = querySymbolLocation(filedata, pos, &errorMessage);
+ if(!errorMessage.isEmpty())
+  Core::MessageManager::write(errorMessage);
+ return location;
+}
+
+DCDSymbolLocation QcdAssist::querySymbolLocation(const QByteArray& filedata, uint pos, QString *errorMessage)
+{
+ DCDSymbolLocation location;
+ QProcess proc;
+ proc.setProcessChannelMode(QProcess::MergedChannels);
+ proc.start(QcdAssist::dcdClient(),
+  QStringList()
+   << QLatin1String("--symbolLocation")
+   << QString(QLatin1String("-c%1")).arg(pos)
+ );
+ proc.write(filedata);
+ proc.closeWriteChannel();
+ if(!proc.waitForFinished(QcdAssist::waitForReadyReadTimeout))
+ {
+  if(errorMessage)
+   *errorMessage = QLatin1String("qcdassist error: unable to find symbol: client didn't finish in time");
+  proc.close();
+  return location;
+ }
+ if(proc.exitCode() != 0)
+  return location;
+
+ // "<file>\t<offset>" or "Not found"
+ QString line = QString::fromUtf8(proc.readAllStandardOutput()).trimmed();
+ int tab = line.lastIndexOf(QLatin1Char('\t'));
+ if(tab == -1)
+  return location;
+ bool ok = false;
+ int offset = line.mid(tab + 1).toInt(&ok);
+ if(!ok)
+  return location;
+ QString file = line.left(tab);
+ if(file != QLatin1String("stdin"))
+  location.fileName = file;
+ location.offset = offset;
+ return location;
+}
+
+DCDSymbolLocation QcdAssist::queryLocalUsages(const QByteArray& filedata, uint pos, QList<int> *usages,
+                                              QString *errorMessage)
+{
+ DCDSymbolLocation location;
+ usages->clear();
+ QProcess proc;
+ proc.start(QcdAssist::dcdClient(),
+  QStringList()
+   << QLatin1String("--localUse")
+   << QString(QLatin1String("-c%1")).arg(pos)
+ );
+ proc.write(filedata);
+ proc.closeWriteChannel();
+ if(!proc.waitForFinished(QcdAssist::waitForReadyReadTimeout))
+ {
+  if(errorMessage)
+   *errorMessage = QLatin1String("qcdassist error: unable to find usages: client didn't finish in time");
+  proc.close();
+  return location;
+ }
+ if(proc.exitCode() != 0)
+  return location;
+
+ // "<file>\t<offset>" of the declaration, then one offset per use; "00000" if not found
+ const QStringList lines = QString::fromUtf8(proc.readAllStandardOutput())
+   .split(QLatin1Char('\n'), QString::SkipEmptyParts);
+ if(lines.isEmpty())
+  return location;
+ const QString first = lines.first().trimmed();
+ const int tab = first.lastIndexOf(QLatin1Char('\t'));
+ if(tab == -1)
+  return location;
+ bool ok = false;
+ const int offset = first.mid(tab + 1).toInt(&ok);
+ if(!ok)
+  return location;
+ for(int i = 1; i < lines.size(); ++i)
+ {
+  const int use = lines.at(i).trimmed().toInt(&ok);
+  if(ok)
+   usages->append(use);
+ }
+ const QString file = first.left(tab);
+ if(file != QLatin1String("stdin"))
+  location.fileName = file;
+ location.offset = offset;
+ return location;
+}
+
 DCDCompletion QcdAssist::processCompletion(QByteArray dataArray)
 {
  DCDCompletion completion;
@@ -74,6 +74,15 @@ namespace QcdAssist
   DCDCompletionType type;
   QList<DCDCompletionItem> completions;
  };
+ struct DCDSymbolLocation
+ {
+  DCDSymbolLocation() : offset(-1) {}
+
+  QString fileName; ///< empty when declared in the sent source itself
+  int offset;       ///< byte offset of the declaration in the file
+
+  bool isValid() const { return offset >= 0; }
+ };
 
  //--------------------
  //--- Socket Funcs ---
@@ -87,6 +96,17 @@ namespace QcdAssist
  DEDITORSHARED_EXPORT void sendAddImportToDCD(QString path);
  DEDITORSHARED_EXPORT DCDCompletion sendRequestToDCD(QByteArray& filedata, uint pos);
  DEDITORSHARED_EXPORT DCDCompletion processCompletion(QByteArray dataArray);
+ DEDITORSHARED_EXPORT DCDSymbolLocation findSymbolLocation(QByteArray& filedata, uint pos);
+ /// Like findSymbolLocation, but safe to call from any thread: errors go to @a errorMessage.
+ DEDITORSHARED_EXPORT DCDSymbolLocation querySymbolLocation(const QByteArray& filedata, uint pos,
+                                                            QString *errorMessage = 0);
+ /**
+  * The declaration of the symbol at @a pos and, in @a usages, the byte offsets
+  * of all uses of it in @a filedata, with one dcd-client --localUse run.
+  * Safe to call from any thread.
+  */
+ DEDITORSHARED_EXPORT DCDSymbolLocation queryLocalUsages(const QByteArray& filedata, uint pos,
+                                                         QList<int> *usages, QString *errorMessage = 0);
 
  //QByteArray sendRequestToDCD(AutocompleteRequest& req);
 // QByteArray sendRequestToDCD(const char* data, qint64 len);
@@ -0,0 +1,433 @@
+#include "dbenchmark.h"
+
+#include <utils/qtcprocess.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const char BASELINE_FILE_NAME[] = "/dbenchmark-baseline.json";
+
+/** The two-sided 95% quantile of Student's t distribution. */
+double tCritical(int degreesOfFreedom)
+{
+ static const double table[] = {
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+ };
+ if (degreesOfFreedom < 1)
+  return 0;
+ if (degreesOfFreedom <= int(sizeof(table) / sizeof(table[0])))
+  return table[degreesOfFreedom - 1];
+ if (degreesOfFreedom <= 40)
+  return 2.021;
+ if (degreesOfFreedom <= 60)
+  return 2.000;
+ if (degreesOfFreedom <= 120)
+  return 1.980;
+ return 1.960;
+}
+
+double metricValue(const DBenchmarkSample &sample, DBenchmark::Metric metric)
+{
+ switch (metric)
+ {
+ case DBenchmark::WallTime:
+  return sample.wallTime;
+ case DBenchmark::UserTime:
+  return sample.userTime;
+ case DBenchmark::SystemTime:
+  return sample.systemTime;
+ case DBenchmark::PeakRss:
+  return sample.peakRss;
+ default:
+  return 0;
+ }
+}
+
+#if defined(Q_OS_WIN)
+qint64 fileTimeMicroseconds(const FILETIME &time)
+{
+ return qint64((quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+}
+#endif
+} // namespace
+
+DBenchmarkStatistics DBenchmarkStatistics::compute(QVector<double> values)
+{
+ DBenchmarkStatistics statistics;
+ statistics.count = values.size();
+ if (values.isEmpty())
+  return statistics;
+ std::sort(values.begin(), values.end());
+ const int middle = values.size() / 2;
+ statistics.median = values.size() % 2 ? values.at(middle)
+                                       : (values.at(middle - 1) + values.at(middle)) / 2;
+ double sum = 0;
+ foreach (double value, values)
+  sum += value;
+ statistics.mean = sum / values.size();
+ if (values.size() < 2)
+  return statistics;
+ double squares = 0;
+ foreach (double value, values)
+  squares += (value - statistics.mean) * (value - statistics.mean);
+ statistics.stdev = std::sqrt(squares / (values.size() - 1));
+ statistics.confidence = tCritical(values.size() - 1) * statistics.stdev / std::sqrt(double(values.size()));
+ return statistics;
+}
+
+bool DBenchmarkStatistics::isSignificant(const DBenchmarkStatistics &baseline,
+                                         const DBenchmarkStatistics &current)
+{
+ if (baseline.count < 2 || current.count < 2)
+  return false;
+ const double baselineVariance = baseline.stdev * baseline.stdev / baseline.count;
+ const double currentVariance = current.stdev * current.stdev / current.count;
+ const double variance = baselineVariance + currentVariance;
+ if (variance == 0)
+  return baseline.mean != current.mean;
+ const double t = std::fabs(current.mean - baseline.mean) / std::sqrt(variance);
+ // Welch-Satterthwaite
+ const double degreesOfFreedom = variance * variance
+   / (baselineVariance * baselineVariance / (baseline.count - 1)
+      + currentVariance * currentVariance / (current.count - 1));
+ return t > tCritical(qMax(1, int(degreesOfFreedom)));
+}
+
+//--------------------------------------------------------------------------------------
+
+DBenchmarkProcess::DBenchmarkProcess(const QString &program, const QStringList &arguments,
+                                     const QString &workingDirectory,
+                                     const QProcessEnvironment &environment)
+ : m_program(program),
+   m_arguments(arguments),
+   m_workingDirectory(workingDirectory),
+   m_environment(environment),
+   m_pid(0),
+   m_handle(0),
+   m_killed(false)
+{
+}
+
+DBenchmarkProcess::~DBenchmarkProcess()
+{
+}
+
+void DBenchmarkProcess::kill()
+{
+ QMutexLocker locker(&m_mutex);
+ m_killed = true;
+#if defined(Q_OS_WIN)
+ if (m_handle)
+  TerminateProcess(m_handle, 1);
+#else
+ if (m_pid)
+  ::kill(pid_t(m_pid), SIGKILL);
+#endif
+}
+
+#if defined(Q_OS_WIN)
+DBenchmarkSample DBenchmarkProcess::run()
+{
+ DBenchmarkSample sample;
+ QString commandLine = Utils::QtcProcess::quoteArg(QDir::toNativeSeparators(m_program));
+ if (!m_arguments.isEmpty())
+  commandLine += QLatin1Char(' ') + Utils::QtcProcess::joinArgs(m_arguments);
+ QString environment;
+ foreach (const QString &entry, m_environment.toStringList())
+  environment += entry + QChar(0);
+ environment += QChar(0);
+ const QString workingDirectory = QDir::toNativeSeparators(m_workingDirectory);
+ const wchar_t *currentDirectory = workingDirectory.isEmpty()
+   ? 0 : reinterpret_cast<const wchar_t *>(workingDirectory.utf16());
+
+ SECURITY_ATTRIBUTES security = { sizeof(SECURITY_ATTRIBUTES), 0, TRUE };
+ HANDLE nul = CreateFileW(L"NUL", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                          &security, OPEN_EXISTING, 0, 0);
+ STARTUPINFOW startupInfo;
+ ZeroMemory(&startupInfo, sizeof(startupInfo));
+ startupInfo.cb = sizeof(startupInfo);
+ startupInfo.dwFlags = STARTF_USESTDHANDLES;
+ startupInfo.hStdInput = startupInfo.hStdOutput = startupInfo.hStdError = nul;
+ PROCESS_INFORMATION processInfo;
+ ZeroMemory(&processInfo, sizeof(processInfo));
+
+ QElapsedTimer timer;
+ timer.start();
+ const bool started = CreateProcessW(0, reinterpret_cast<wchar_t *>(commandLine.data()), 0, 0, TRUE,
+                                     CREATE_UNICODE_ENVIRONMENT | CREATE_NO_WINDOW,
+                                     const_cast<ushort *>(environment.utf16()),
+                                     currentDirectory,
+                                     &startupInfo, &processInfo);
+ if (nul != INVALID_HANDLE_VALUE)
+  CloseHandle(nul);
+ if (!started)
+ {
+  sample.error = tr("Could not start %1: error %2.")
+    .arg(QDir::toNativeSeparators(m_program)).arg(GetLastError());
+  return sample;
+ }
+ CloseHandle(processInfo.hThread);
+ {
+  QMutexLocker locker(&m_mutex);
+  m_handle = processInfo.hProcess;
+  if (m_killed)
+   TerminateProcess(m_handle, 1);
+ }
+ WaitForSingleObject(processInfo.hProcess, INFINITE);
+ sample.wallTime = timer.nsecsElapsed() / 1000;
+
+ DWORD exitCode = 0;
+ GetExitCodeProcess(processInfo.hProcess, &exitCode);
+ sample.exitCode = int(exitCode);
+ FILETIME creationTime, exitTime, kernelTime, userTime;
+ if (GetProcessTimes(processInfo.hProcess, &creationTime, &exitTime, &kernelTime, &userTime))
+ {
+  sample.userTime = fileTimeMicroseconds(userTime);
+  sample.systemTime = fileTimeMicroseconds(kernelTime);
+ }
+ PROCESS_MEMORY_COUNTERS memory;
+ if (GetProcessMemoryInfo(processInfo.hProcess, &memory, sizeof(memory)))
+  sample.peakRss = qint64(memory.PeakWorkingSetSize / 1024);
+
+ QMutexLocker locker(&m_mutex);
+ m_handle = 0;
+ CloseHandle(processInfo.hProcess);
+ if (m_killed)
+  sample.error = tr("The benchmark was stopped.");
+ return sample;
+}
+#else
+DBenchmarkSample DBenchmarkProcess::run()
+{
+ DBenchmarkSample sample;
+ // everything the child needs is prepared before fork, it only may call
+ // async-signal-safe functions until exec
+ QList<QByteArray> arguments;
+ arguments << QFile::encodeName(m_program);
+ foreach (const QString &argument, m_arguments)
+  arguments << argument.toLocal8Bit();
+ QVector<char *> argv;
+ for (int i = 0; i < arguments.size(); ++i)
+  argv.append(arguments[i].data());
+ argv.append(0);
+ QList<QByteArray> variables;
+ foreach (const QString &variable, m_environment.toStringList())
+  variables << variable.toLocal8Bit();
+ QVector<char *> envp;
+ for (int i = 0; i < variables.size(); ++i)
+  envp.append(variables[i].data());
+ envp.append(0);
+ const QByteArray workingDirectory = QFile::encodeName(m_workingDirectory);
+ char *const *argvData = argv.data();
+ char *const *envpData = envp.data();
+
+ // closed by exec, otherwise it carries the errno of the failure
+ int execPipe[2];
+ if (pipe(execPipe) != 0)
+ {
+  sample.error = tr("Could not start %1: %2.")
+    .arg(QDir::toNativeSeparators(m_program), QString::fromLocal8Bit(strerror(errno)));
+  return sample;
+ }
+ fcntl(execPipe[0], F_SETFD, FD_CLOEXEC);
+ fcntl(execPipe[1], F_SETFD, FD_CLOEXEC);
+
+ QElapsedTimer timer;
+ timer.start();
+ const pid_t pid = fork();
+ if (pid == 0)
+ {
+  const int nul = open("/dev/null", O_RDWR);
+  if (nul >= 0)
+  {
+   dup2(nul, STDIN_FILENO);
+   dup2(nul, STDOUT_FILENO);
+   dup2(nul, STDERR_FILENO);
+  }
+  if (workingDirectory.isEmpty() || chdir(workingDirectory.constData()) == 0)
+   execve(argvData[0], argvData, envpData);
+  const int error = errno;
+  const ssize_t written = write(execPipe[1], &error, sizeof(error));
+  Q_UNUSED(written);
+  _exit(127);
+ }
+ close(execPipe[1]);
+ if (pid < 0)
+ {
+  close(execPipe[0]);
+  sample.error = tr("Could not start %1: %2.")
+    .arg(QDir::toNativeSeparators(m_program), QString::fromLocal8Bit(strerror(errno)));
+  return sample;
+ }
+ {
+  QMutexLocker locker(&m_mutex);
+  m_pid = pid;
+  if (m_killed)
+   ::kill(pid, SIGKILL);
+ }
+
+ int execError = 0;
+ ssize_t bytesRead;
+ do
+  bytesRead = read(execPipe[0], &execError, sizeof(execError));
+ while (bytesRead < 0 && errno == EINTR);
+ close(execPipe[0]);
+
+ int status = 0;
+ struct rusage usage;
+ memset(&usage, 0, sizeof(usage));
+ pid_t waited;
+ do
+  waited = wait4(pid, &status, 0, &usage);
+ while (waited < 0 && errno == EINTR);
+ sample.wallTime = timer.nsecsElapsed() / 1000;
+
+ QMutexLocker locker(&m_mutex);
+ m_pid = 0;
+ if (bytesRead > 0)
+ {
+  sample.error = tr("Could not start %1: %2.")
+    .arg(QDir::toNativeSeparators(m_program), QString::fromLocal8Bit(strerror(execError)));
+  return sample;
+ }
+ sample.userTime = qint64(usage.ru_utime.tv_sec) * 1000000 + usage.ru_utime.tv_usec;
+ sample.systemTime = qint64(usage.ru_stime.tv_sec) * 1000000 + usage.ru_stime.tv_usec;
+#if defined(Q_OS_MAC)
+ sample.peakRss = usage.ru_maxrss / 1024; // in bytes there
+#else
+ sample.peakRss = usage.ru_maxrss;
+#endif
+ if (m_killed)
+  sample.error = tr("The benchmark was stopped.");
+ else if (waited < 0)
+  sample.error = tr("Could not wait for %1: %2.")
+    .arg(QDir::toNativeSeparators(m_program), QString::fromLocal8Bit(strerror(errno)));
+ else if (WIFSIGNALED(status))
+  sample.error = tr("%1 was killed by signal %2.")
+    .arg(QDir::toNativeSeparators(m_program)).arg(WTERMSIG(status));
+ else
+  sample.exitCode = WEXITSTATUS(status);
+ return sample;
+}
+#endif
+
+//--------------------------------------------------------------------------------------
+
+QString DBenchmark::baselineFileName(const QString &buildDirectory)
+{
+ return buildDirectory + QLatin1String(BASELINE_FILE_NAME);
+}
+
+QString DBenchmark::metricName(Metric metric)
+{
+ switch (metric)
+ {
+ case WallTime:
+  return tr("Wall time");
+ case UserTime:
+  return tr("User CPU");
+ case SystemTime:
+  return tr("System CPU");
+ case PeakRss:
+  return tr("Peak RSS");
+ default:
+  return QString();
+ }
+}
+
+double DBenchmark::displayValue(Metric metric, double value)
+{
+ return metric == PeakRss ? value / 1024 : value / 1000;
+}
+
+QString DBenchmark::displayUnit(Metric metric)
+{
+ return metric == PeakRss ? QLatin1String("MiB") : QLatin1String("ms");
+}
+
+/** Of the measured runs, warm-up and failed runs do not count. */
+DBenchmarkStatistics DBenchmark::statistics(Metric metric) const
+{
+ QVector<double> values;
+ foreach (const DBenchmarkSample &sample, m_samples)
+  if (!sample.warmUp && sample.error.isEmpty())
+   values.append(metricValue(sample, metric));
+ return DBenchmarkStatistics::compute(values);
+}
+
+bool DBenchmark::save(const QString &fileName) const
+{
+ QJsonArray samples;
+ foreach (const DBenchmarkSample &sample, m_samples)
+ {
+  if (sample.warmUp || !sample.error.isEmpty())
+   continue;
+  QJsonObject object;
+  object.insert(QLatin1String("wall"), double(sample.wallTime));
+  object.insert(QLatin1String("user"), double(sample.userTime));
+  object.insert(QLatin1String("system"), double(sample.systemTime));
+  object.insert(QLatin1String("rss"), double(sample.peakRss));
+  samples.append(object);
+ }
+ QJsonObject root;
+ root.insert(QLatin1String("samples"), samples);
+
+ QDir().mkpath(QFileInfo(fileName).absolutePath());
+ QSaveFile file(fileName);
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ file.write(QJsonDocument(root).toJson());
+ return file.commit();
+}
+
+bool DBenchmark::load(const QString &fileName)
+{
+ m_samples.clear();
+ QFile file(fileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return false;
+ const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+ foreach (const QJsonValue &value, root.value(QLatin1String("samples")).toArray())
+ {
+  const QJsonObject object = value.toObject();
+  DBenchmarkSample sample;
+  sample.wallTime = qint64(object.value(QLatin1String("wall")).toDouble());
+  sample.userTime = qint64(object.value(QLatin1String("user")).toDouble());
+  sample.systemTime = qint64(object.value(QLatin1String("system")).toDouble());
+  sample.peakRss = qint64(object.value(QLatin1String("rss")).toDouble());
+  m_samples.append(sample);
+ }
+ return !m_samples.isEmpty();
+}
+
+} // namespace Internal
+} // namespace DProjectManager
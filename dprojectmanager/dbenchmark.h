@@ -0,0 +1,105 @@
+#ifndef DBENCHMARK_H
+#define DBENCHMARK_H
+
+#include <QCoreApplication>
+#include <QList>
+#include <QMutex>
+#include <QProcessEnvironment>
+#include <QStringList>
+#include <QVector>
+
+namespace DProjectManager {
+namespace Internal {
+
+struct DBenchmarkSample
+{
+ DBenchmarkSample() : wallTime(0), userTime(0), systemTime(0), peakRss(0), exitCode(0), warmUp(false) {}
+
+ qint64 wallTime;   ///< in microseconds
+ qint64 userTime;   ///< in microseconds
+ qint64 systemTime; ///< in microseconds
+ qint64 peakRss;    ///< in KiB
+ int exitCode;
+ bool warmUp;
+ QString error;     ///< why the program did not run to a normal end, if it did not
+};
+
+struct DBenchmarkStatistics
+{
+ DBenchmarkStatistics() : count(0), mean(0), median(0), stdev(0), confidence(0) {}
+
+ /// The confidence interval of the mean is mean +/- confidence, at 95%.
+ static DBenchmarkStatistics compute(QVector<double> values);
+ /**
+  * Whether @a current differs from @a baseline by more than chance, by
+  * Welch's t-test at 95%.
+  */
+ static bool isSignificant(const DBenchmarkStatistics &baseline, const DBenchmarkStatistics &current);
+
+ int count;
+ double mean;
+ double median;
+ double stdev;
+ double confidence;
+};
+
+/**
+ * Runs a program to its end with its output discarded and measures its
+ * wall time, CPU time and peak resident set size, which QProcess does not
+ * tell. run() blocks; kill() may be called from another thread.
+ */
+class DBenchmarkProcess
+{
+ Q_DECLARE_TR_FUNCTIONS(DProjectManager::Internal::DBenchmarkProcess)
+
+public:
+ DBenchmarkProcess(const QString &program, const QStringList &arguments,
+                   const QString &workingDirectory, const QProcessEnvironment &environment);
+ ~DBenchmarkProcess();
+
+ DBenchmarkSample run();
+ void kill();
+
+private:
+ QString m_program;
+ QStringList m_arguments;
+ QString m_workingDirectory;
+ QProcessEnvironment m_environment;
+ QMutex m_mutex;
+ qint64 m_pid;    ///< of the running program, 0 if there is none
+ void *m_handle;  ///< of the running program on Windows
+ bool m_killed;
+};
+
+/**
+ * The measured runs of a benchmark, saved as a baseline to compare later
+ * runs with.
+ */
+class DBenchmark
+{
+ Q_DECLARE_TR_FUNCTIONS(DProjectManager::Internal::DBenchmark)
+
+public:
+ enum Metric { WallTime, UserTime, SystemTime, PeakRss, MetricCount };
+
+ static QString baselineFileName(const QString &buildDirectory);
+ static QString metricName(Metric metric);
+ /// Converts from the sample's unit to the displayed one, ms or MiB.
+ static double displayValue(Metric metric, double value);
+ static QString displayUnit(Metric metric);
+
+ void addSample(const DBenchmarkSample &sample) { m_samples.append(sample); }
+ const QList<DBenchmarkSample> &samples() const { return m_samples; }
+ DBenchmarkStatistics statistics(Metric metric) const;
+
+ bool save(const QString &fileName) const;
+ bool load(const QString &fileName);
+
+private:
+ QList<DBenchmarkSample> m_samples;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DBENCHMARK_H
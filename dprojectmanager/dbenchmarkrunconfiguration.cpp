@@ -0,0 +1,450 @@
+#include "dbenchmarkrunconfiguration.h"
+
+#include "dprojectmanagerconstants.h"
+#include "drunconfiguration.h"
+
+#include <coreplugin/progressmanager/progressmanager.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/environmentaspect.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/target.h>
+#include <utils/outputformat.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+#include <qtconcurrent/runextensions.h>
+
+#include <QCheckBox>
+#include <QDir>
+#include <QDoubleSpinBox>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QIcon>
+#include <QLabel>
+#include <QSpinBox>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int DEFAULT_ITERATIONS = 10;
+const int DEFAULT_WARM_UP_RUNS = 2;
+const double DEFAULT_THRESHOLD = 5.0;
+
+struct BenchmarkRequest
+{
+ QSharedPointer<DBenchmarkProcess> process;
+ int warmUpRuns;
+ int iterations;
+};
+
+/** Runs one after the other, stops at the first that fails. */
+void runBenchmark(QFutureInterface<DBenchmarkSample> &future, const BenchmarkRequest request)
+{
+ const int runs = request.warmUpRuns + request.iterations;
+ future.setProgressRange(0, runs);
+ for (int i = 0; i < runs && !future.isCanceled(); ++i)
+ {
+  DBenchmarkSample sample = request.process->run();
+  sample.warmUp = i < request.warmUpRuns;
+  future.reportResult(sample, i);
+  future.setProgressValue(i + 1);
+  if (!sample.error.isEmpty() || sample.exitCode != 0)
+   break;
+ }
+}
+
+QString formatValue(DBenchmark::Metric metric, double value)
+{
+ return QString::number(DBenchmark::displayValue(metric, value), 'f', 1)
+   + QLatin1Char(' ') + DBenchmark::displayUnit(metric);
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+//--- DBenchmarkRunConfiguration
+//-----------------------------------------------------------------------------
+void DBenchmarkRunConfiguration::ctor()
+{
+ setDefaultDisplayName(tr("Benchmark Run"));
+}
+
+DBenchmarkRunConfiguration::DBenchmarkRunConfiguration(Target *parent)
+ : RunConfiguration(parent, Core::Id(Constants::BENCHMARK_RUN_CONFIG_ID)),
+   m_iterations(DEFAULT_ITERATIONS),
+   m_warmUpRuns(DEFAULT_WARM_UP_RUNS),
+   m_threshold(DEFAULT_THRESHOLD),
+   m_saveBaseline(false)
+{
+ ctor();
+}
+
+DBenchmarkRunConfiguration::DBenchmarkRunConfiguration(Target *parent, DBenchmarkRunConfiguration *source)
+ : RunConfiguration(parent, source),
+   m_iterations(source->m_iterations),
+   m_warmUpRuns(source->m_warmUpRuns),
+   m_threshold(source->m_threshold),
+   m_saveBaseline(source->m_saveBaseline)
+{
+ ctor();
+}
+
+DRunConfiguration *DBenchmarkRunConfiguration::runConfiguration() const
+{
+ foreach (RunConfiguration *rc, target()->runConfigurations())
+  if (DRunConfiguration *drc = qobject_cast<DRunConfiguration *>(rc))
+   return drc;
+ return 0;
+}
+
+bool DBenchmarkRunConfiguration::isEnabled() const
+{
+ return runConfiguration() != 0;
+}
+
+QString DBenchmarkRunConfiguration::disabledReason() const
+{
+ if (!runConfiguration())
+  return tr("There is no D run configuration to benchmark.");
+ return QString();
+}
+
+QWidget *DBenchmarkRunConfiguration::createConfigurationWidget()
+{
+ return new DBenchmarkRunConfigurationWidget(this);
+}
+
+QVariantMap DBenchmarkRunConfiguration::toMap() const
+{
+ QVariantMap map(RunConfiguration::toMap());
+ map.insert(QLatin1String(Constants::BENCHMARK_ITERATIONS_KEY), m_iterations);
+ map.insert(QLatin1String(Constants::BENCHMARK_WARM_UP_RUNS_KEY), m_warmUpRuns);
+ map.insert(QLatin1String(Constants::BENCHMARK_THRESHOLD_KEY), m_threshold);
+ map.insert(QLatin1String(Constants::BENCHMARK_SAVE_BASELINE_KEY), m_saveBaseline);
+ return map;
+}
+
+bool DBenchmarkRunConfiguration::fromMap(const QVariantMap &map)
+{
+ m_iterations = map.value(QLatin1String(Constants::BENCHMARK_ITERATIONS_KEY), DEFAULT_ITERATIONS).toInt();
+ m_warmUpRuns = map.value(QLatin1String(Constants::BENCHMARK_WARM_UP_RUNS_KEY), DEFAULT_WARM_UP_RUNS).toInt();
+ m_threshold = map.value(QLatin1String(Constants::BENCHMARK_THRESHOLD_KEY), DEFAULT_THRESHOLD).toDouble();
+ m_saveBaseline = map.value(QLatin1String(Constants::BENCHMARK_SAVE_BASELINE_KEY)).toBool();
+ ctor();
+ return RunConfiguration::fromMap(map);
+}
+
+void DBenchmarkRunConfiguration::setIterations(int iterations)
+{
+ m_iterations = iterations;
+ emit changed();
+}
+
+void DBenchmarkRunConfiguration::setWarmUpRuns(int runs)
+{
+ m_warmUpRuns = runs;
+ emit changed();
+}
+
+void DBenchmarkRunConfiguration::setThreshold(double threshold)
+{
+ m_threshold = threshold;
+ emit changed();
+}
+
+void DBenchmarkRunConfiguration::setSaveBaseline(bool save)
+{
+ m_saveBaseline = save;
+ emit changed();
+}
+
+QString DBenchmarkRunConfiguration::baselineFileName() const
+{
+ BuildConfiguration *bc = target()->activeBuildConfiguration();
+ return bc ? DBenchmark::baselineFileName(bc->buildDirectory().toString()) : QString();
+}
+
+//-------------------------------------------------------------------------------
+//-- DBenchmarkRunConfigurationWidget
+//-------------------------------------------------------------------------------
+DBenchmarkRunConfigurationWidget::DBenchmarkRunConfigurationWidget(DBenchmarkRunConfiguration *rc)
+ : m_ignoreChange(false), m_runConfiguration(rc)
+{
+ QFormLayout *layout = new QFormLayout(this);
+ layout->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
+ layout->setMargin(0);
+
+ m_programLabel = new QLabel(this);
+ m_programLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+ layout->addRow(tr("Program:"), m_programLabel);
+
+ m_iterationsSpinBox = new QSpinBox(this);
+ m_iterationsSpinBox->setRange(2, 10000);
+ layout->addRow(tr("Measured runs:"), m_iterationsSpinBox);
+
+ m_warmUpSpinBox = new QSpinBox(this);
+ m_warmUpSpinBox->setRange(0, 1000);
+ layout->addRow(tr("Warm-up runs:"), m_warmUpSpinBox);
+
+ m_thresholdSpinBox = new QDoubleSpinBox(this);
+ m_thresholdSpinBox->setRange(0, 1000);
+ m_thresholdSpinBox->setDecimals(1);
+ m_thresholdSpinBox->setSuffix(QLatin1String(" %"));
+ m_thresholdSpinBox->setToolTip(tr("A significant change against the baseline by more than "
+                                   "this is reported as a regression."));
+ layout->addRow(tr("Regression threshold:"), m_thresholdSpinBox);
+
+ m_saveBaselineCheck = new QCheckBox(tr("Save the results as the new baseline"), this);
+ layout->addRow(QString(), m_saveBaselineCheck);
+
+ changed();
+
+ connect(m_iterationsSpinBox, SIGNAL(valueChanged(int)), this, SLOT(iterationsEdited(int)));
+ connect(m_warmUpSpinBox, SIGNAL(valueChanged(int)), this, SLOT(warmUpRunsEdited(int)));
+ connect(m_thresholdSpinBox, SIGNAL(valueChanged(double)), this, SLOT(thresholdEdited(double)));
+ connect(m_saveBaselineCheck, SIGNAL(toggled(bool)), this, SLOT(saveBaselineToggled(bool)));
+ connect(m_runConfiguration, SIGNAL(changed()), this, SLOT(changed()));
+}
+
+void DBenchmarkRunConfigurationWidget::changed()
+{
+ // We triggered the change, don't update us
+ if (m_ignoreChange)
+  return;
+
+ DRunConfiguration *rc = m_runConfiguration->runConfiguration();
+ m_programLabel->setText(rc ? QDir::toNativeSeparators(rc->rawExecutable())
+                            : m_runConfiguration->disabledReason());
+ m_iterationsSpinBox->setValue(m_runConfiguration->iterations());
+ m_warmUpSpinBox->setValue(m_runConfiguration->warmUpRuns());
+ m_thresholdSpinBox->setValue(m_runConfiguration->threshold());
+ m_saveBaselineCheck->setChecked(m_runConfiguration->saveBaseline());
+}
+
+void DBenchmarkRunConfigurationWidget::iterationsEdited(int iterations)
+{
+ m_ignoreChange = true;
+ m_runConfiguration->setIterations(iterations);
+ m_ignoreChange = false;
+}
+
+void DBenchmarkRunConfigurationWidget::warmUpRunsEdited(int runs)
+{
+ m_ignoreChange = true;
+ m_runConfiguration->setWarmUpRuns(runs);
+ m_ignoreChange = false;
+}
+
+void DBenchmarkRunConfigurationWidget::thresholdEdited(double threshold)
+{
+ m_ignoreChange = true;
+ m_runConfiguration->setThreshold(threshold);
+ m_ignoreChange = false;
+}
+
+void DBenchmarkRunConfigurationWidget::saveBaselineToggled(bool save)
+{
+ m_ignoreChange = true;
+ m_runConfiguration->setSaveBaseline(save);
+ m_ignoreChange = false;
+}
+
+//-----------------------------------------------------------------------------
+//--- DBenchmarkRunControl
+//-----------------------------------------------------------------------------
+DBenchmarkRunControl::DBenchmarkRunControl(DBenchmarkRunConfiguration *rc, RunMode mode)
+ : RunControl(rc, mode),
+   m_iterations(rc->iterations()),
+   m_warmUpRuns(rc->warmUpRuns()),
+   m_threshold(rc->threshold()),
+   m_saveBaseline(rc->saveBaseline()),
+   m_baselineFileName(rc->baselineFileName()),
+   m_failed(false)
+{
+ DRunConfiguration *measured = rc->runConfiguration();
+ m_program = measured->executable();
+ EnvironmentAspect *aspect = measured->extraAspect<EnvironmentAspect>();
+ m_process = QSharedPointer<DBenchmarkProcess>(
+    new DBenchmarkProcess(m_program, Utils::QtcProcess::splitArgs(measured->commandLineArguments()),
+                          measured->workingDirectory(),
+                          aspect ? aspect->environment().toProcessEnvironment()
+                                 : QProcessEnvironment::systemEnvironment()));
+ connect(&m_watcher, SIGNAL(resultReadyAt(int)), this, SLOT(sampleReady(int)));
+ connect(&m_watcher, SIGNAL(finished()), this, SLOT(benchmarkFinished()));
+}
+
+DBenchmarkRunControl::~DBenchmarkRunControl()
+{
+ if (m_watcher.isRunning())
+ {
+  m_watcher.disconnect(this);
+  stop();
+  m_watcher.waitForFinished();
+ }
+}
+
+void DBenchmarkRunControl::start()
+{
+ emit started();
+ message(tr("Benchmarking %1: %2 warm-up and %3 measured runs, output discarded")
+         .arg(QDir::toNativeSeparators(m_program)).arg(m_warmUpRuns).arg(m_iterations));
+ BenchmarkRequest request;
+ request.process = m_process;
+ request.warmUpRuns = m_warmUpRuns;
+ request.iterations = m_iterations;
+ QFuture<DBenchmarkSample> future = QtConcurrent::run(&runBenchmark, request);
+ m_watcher.setFuture(future);
+ Core::ProgressManager::addTask(future, tr("Benchmarking %1").arg(QFileInfo(m_program).fileName()),
+                                Constants::D_BENCHMARK_TASK_ID);
+}
+
+RunControl::StopResult DBenchmarkRunControl::stop()
+{
+ m_watcher.cancel();
+ m_process->kill();
+ return AsynchronousStop;
+}
+
+bool DBenchmarkRunControl::isRunning() const
+{
+ return m_watcher.isRunning();
+}
+
+QIcon DBenchmarkRunControl::icon() const
+{
+ return QIcon(QLatin1String(ProjectExplorer::Constants::ICON_RUN_SMALL));
+}
+
+void DBenchmarkRunControl::sampleReady(int index)
+{
+ const DBenchmarkSample sample = m_watcher.resultAt(index);
+ m_benchmark.addSample(sample);
+ if (!sample.error.isEmpty())
+ {
+  m_failed = true;
+  message(sample.error, true);
+  return;
+ }
+ if (sample.exitCode != 0)
+ {
+  m_failed = true;
+  message(tr("%1 exited with code %2.").arg(QDir::toNativeSeparators(m_program)).arg(sample.exitCode), true);
+  return;
+ }
+ const QString run = sample.warmUp ? tr("Warm-up run %1").arg(index + 1)
+                                   : tr("Run %1/%2").arg(index - m_warmUpRuns + 1).arg(m_iterations);
+ message(tr("%1: wall %2, user %3, system %4, peak RSS %5")
+         .arg(run, formatValue(DBenchmark::WallTime, sample.wallTime),
+              formatValue(DBenchmark::UserTime, sample.userTime),
+              formatValue(DBenchmark::SystemTime, sample.systemTime),
+              formatValue(DBenchmark::PeakRss, sample.peakRss)));
+}
+
+void DBenchmarkRunControl::benchmarkFinished()
+{
+ if (m_watcher.isCanceled())
+  message(tr("The benchmark was stopped."), true);
+ else if (!m_failed)
+  report();
+ emit finished();
+}
+
+/**
+ * The statistics of the measured runs, and their change against the
+ * baseline. A change is a regression when Welch's t-test says it is not
+ * chance and it is above the threshold.
+ */
+void DBenchmarkRunControl::report()
+{
+ DBenchmark baseline;
+ const bool haveBaseline = !m_baselineFileName.isEmpty() && baseline.load(m_baselineFileName);
+ int regressions = 0;
+ for (int i = 0; i < DBenchmark::MetricCount; ++i)
+ {
+  const DBenchmark::Metric metric = DBenchmark::Metric(i);
+  const DBenchmarkStatistics statistics = m_benchmark.statistics(metric);
+  message(tr("%1: mean %2 +/- %3 (95% confidence), median %4, stdev %5")
+          .arg(DBenchmark::metricName(metric), formatValue(metric, statistics.mean),
+               formatValue(metric, statistics.confidence), formatValue(metric, statistics.median),
+               formatValue(metric, statistics.stdev)));
+  if (!haveBaseline)
+   continue;
+
+  const DBenchmarkStatistics base = baseline.statistics(metric);
+  if (base.mean <= 0)
+   continue;
+  const double change = (statistics.mean - base.mean) / base.mean * 100;
+  const bool significant = DBenchmarkStatistics::isSignificant(base, statistics);
+  const QString comparison = tr("  %1%2% against the baseline mean of %3, %4")
+    .arg(change >= 0 ? QLatin1String("+") : QLatin1String(""))
+    .arg(change, 0, 'f', 1)
+    .arg(formatValue(metric, base.mean))
+    .arg(significant ? tr("significant") : tr("within noise"));
+  const bool regression = significant && change > m_threshold;
+  if (regression)
+   ++regressions;
+  message(comparison, regression);
+ }
+
+ if (!haveBaseline)
+  message(tr("There is no baseline to compare with."));
+ else if (regressions)
+  message(tr("Regression: %n metric(s) rose by more than %1% over the baseline.", 0, regressions)
+          .arg(m_threshold), true);
+ else
+  message(tr("No regression against the baseline."));
+
+ if (m_saveBaseline)
+ {
+  if (m_benchmark.save(m_baselineFileName))
+   message(tr("Saved the results as the baseline in %1.").arg(QDir::toNativeSeparators(m_baselineFileName)));
+  else
+   message(tr("Could not save the baseline in %1.").arg(QDir::toNativeSeparators(m_baselineFileName)), true);
+ }
+}
+
+void DBenchmarkRunControl::message(const QString &text, bool error)
+{
+ emit appendMessage(this, text + QLatin1Char('\n'),
+                    error ? Utils::ErrorMessageFormat : Utils::NormalMessageFormat);
+}
+
+//-----------------------------------------------------------------------------
+//--- DBenchmarkRunControlFactory
+//-----------------------------------------------------------------------------
+DBenchmarkRunControlFactory::DBenchmarkRunControlFactory(QObject *parent)
+ : IRunControlFactory(parent)
+{
+ setObjectName(QLatin1String("DBenchmarkRunControlFactory"));
+}
+
+QString DBenchmarkRunControlFactory::displayName() const
+{
+ return tr("Benchmark");
+}
+
+bool DBenchmarkRunControlFactory::canRun(RunConfiguration *runConfiguration, RunMode mode) const
+{
+ return mode == NormalRunMode && qobject_cast<DBenchmarkRunConfiguration *>(runConfiguration);
+}
+
+RunControl *DBenchmarkRunControlFactory::create(RunConfiguration *runConfiguration, RunMode mode,
+                                                QString *errorMessage)
+{
+ DBenchmarkRunConfiguration *rc = qobject_cast<DBenchmarkRunConfiguration *>(runConfiguration);
+ QTC_ASSERT(rc && mode == NormalRunMode, return 0);
+ DRunConfiguration *measured = rc->runConfiguration();
+ if (!measured)
+ {
+  if (errorMessage)
+   *errorMessage = rc->disabledReason();
+  return 0;
+ }
+ if (!measured->validateExecutable(0, errorMessage))
+  return 0;
+ return new DBenchmarkRunControl(rc, mode);
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,144 @@
+#ifndef DBENCHMARKRUNCONFIGURATION_H
+#define DBENCHMARKRUNCONFIGURATION_H
+
+#include "dbenchmark.h"
+
+#include <projectexplorer/runconfiguration.h>
+
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QSpinBox;
+QT_END_NAMESPACE
+
+namespace DProjectManager {
+namespace Internal {
+
+class DRunConfiguration;
+
+/**
+ * Measures the program of the target's D run configuration: it runs it a
+ * number of times after some warm-up runs, reports the statistics of the
+ * runs and compares them with the baseline saved in the build directory.
+ */
+class DBenchmarkRunConfiguration : public ProjectExplorer::RunConfiguration
+{
+ Q_OBJECT
+ friend class DRunConfigurationFactory;
+
+public:
+ explicit DBenchmarkRunConfiguration(ProjectExplorer::Target *parent);
+
+ /// The run configuration whose program, arguments and environment are used.
+ DRunConfiguration *runConfiguration() const;
+ bool isEnabled() const;
+ QString disabledReason() const;
+ QWidget *createConfigurationWidget();
+ QVariantMap toMap() const;
+
+ int iterations() const { return m_iterations; }
+ void setIterations(int iterations);
+ int warmUpRuns() const { return m_warmUpRuns; }
+ void setWarmUpRuns(int runs);
+ /// The change in percent above which a significant one is a regression.
+ double threshold() const { return m_threshold; }
+ void setThreshold(double threshold);
+ bool saveBaseline() const { return m_saveBaseline; }
+ void setSaveBaseline(bool save);
+ QString baselineFileName() const;
+
+signals:
+ void changed();
+
+protected:
+ DBenchmarkRunConfiguration(ProjectExplorer::Target *parent, DBenchmarkRunConfiguration *source);
+ bool fromMap(const QVariantMap &map);
+
+private:
+ void ctor();
+
+ int m_iterations;
+ int m_warmUpRuns;
+ double m_threshold;
+ bool m_saveBaseline;
+};
+
+class DBenchmarkRunConfigurationWidget : public QWidget
+{
+ Q_OBJECT
+
+public:
+ explicit DBenchmarkRunConfigurationWidget(DBenchmarkRunConfiguration *rc);
+
+private slots:
+ void changed();
+ void iterationsEdited(int iterations);
+ void warmUpRunsEdited(int runs);
+ void thresholdEdited(double threshold);
+ void saveBaselineToggled(bool save);
+
+private:
+ bool m_ignoreChange;
+ DBenchmarkRunConfiguration *m_runConfiguration;
+ QLabel *m_programLabel;
+ QSpinBox *m_iterationsSpinBox;
+ QSpinBox *m_warmUpSpinBox;
+ QDoubleSpinBox *m_thresholdSpinBox;
+ QCheckBox *m_saveBaselineCheck;
+};
+
+class DBenchmarkRunControl : public ProjectExplorer::RunControl
+{
+ Q_OBJECT
+
+public:
+ DBenchmarkRunControl(DBenchmarkRunConfiguration *rc, ProjectExplorer::RunMode mode);
+ ~DBenchmarkRunControl();
+
+ void start();
+ StopResult stop();
+ bool isRunning() const;
+ QIcon icon() const;
+
+private slots:
+ void sampleReady(int index);
+ void benchmarkFinished();
+
+private:
+ void report();
+ void message(const QString &text, bool error = false);
+
+ QSharedPointer<DBenchmarkProcess> m_process;
+ QFutureWatcher<DBenchmarkSample> m_watcher;
+ DBenchmark m_benchmark;
+ QString m_program;
+ int m_iterations;
+ int m_warmUpRuns;
+ double m_threshold;
+ bool m_saveBaseline;
+ QString m_baselineFileName;
+ bool m_failed;
+};
+
+class DBenchmarkRunControlFactory : public ProjectExplorer::IRunControlFactory
+{
+ Q_OBJECT
+
+public:
+ explicit DBenchmarkRunControlFactory(QObject *parent = 0);
+
+ QString displayName() const;
+ bool canRun(ProjectExplorer::RunConfiguration *runConfiguration, ProjectExplorer::RunMode mode) const;
+ ProjectExplorer::RunControl *create(ProjectExplorer::RunConfiguration *runConfiguration,
+                                     ProjectExplorer::RunMode mode, QString *errorMessage);
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DBENCHMARKRUNCONFIGURATION_H
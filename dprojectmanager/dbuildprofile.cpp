@@ -0,0 +1,242 @@
+#include "dbuildprofile.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+
+#include <algorithm>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const char PROFILE_FILE_NAME[] = "/dbuildprofile.json";
+const char MODULE_CATEGORY[] = "module";
+const int PROCESS_ID = 1;
+
+bool moreExpensive(const DBuildProfile::Template &a, const DBuildProfile::Template &b)
+{
+ if (a.duration != b.duration)
+  return a.duration > b.duration;
+ return a.instances > b.instances;
+}
+
+QJsonObject moduleEvent(const DBuildProfile::Module &module)
+{
+ QJsonObject args;
+ args.insert(QLatin1String("file"), module.source);
+ QJsonObject event;
+ event.insert(QLatin1String("name"), QFileInfo(module.source).fileName());
+ event.insert(QLatin1String("cat"), QLatin1String(MODULE_CATEGORY));
+ event.insert(QLatin1String("ph"), QLatin1String("X"));
+ event.insert(QLatin1String("ts"), double(module.start));
+ event.insert(QLatin1String("dur"), double(module.duration));
+ event.insert(QLatin1String("pid"), PROCESS_ID);
+ event.insert(QLatin1String("tid"), module.worker + 1);
+ event.insert(QLatin1String("args"), args);
+ return event;
+}
+
+QJsonObject threadNameEvent(int worker)
+{
+ QJsonObject args;
+ args.insert(QLatin1String("name"), QString::fromLatin1("Compiler %1").arg(worker + 1));
+ QJsonObject event;
+ event.insert(QLatin1String("name"), QLatin1String("thread_name"));
+ event.insert(QLatin1String("ph"), QLatin1String("M"));
+ event.insert(QLatin1String("pid"), PROCESS_ID);
+ event.insert(QLatin1String("tid"), worker + 1);
+ event.insert(QLatin1String("args"), args);
+ return event;
+}
+} // namespace
+
+QString DBuildProfile::fileName(const QString &buildDirectory)
+{
+ return buildDirectory + QLatin1String(PROFILE_FILE_NAME);
+}
+
+QStringList DBuildProfile::compilerArguments(const QString &command, const QString &traceFile)
+{
+ const QString compiler = QFileInfo(command).baseName().toLower();
+ QStringList args;
+ if (compiler.startsWith(QLatin1String("ldc")))
+  args << QLatin1String("-ftime-trace") << QLatin1String("-ftime-trace-file=") + traceFile;
+ else if (compiler.contains(QLatin1String("dmd"))) // and ldmd
+  args << QLatin1String("-vtemplates");
+ return args;
+}
+
+DBuildProfile::Template &DBuildProfile::templateEntry(const QString &name, const QString &location)
+{
+ const QString key = name + QLatin1Char('\n') + location;
+ QHash<QString, int>::ConstIterator it = m_templateIndex.constFind(key);
+ if (it != m_templateIndex.constEnd())
+  return m_templates[*it];
+ Template entry;
+ entry.name = name;
+ entry.location = location;
+ entry.instances = 0;
+ entry.distinct = 0;
+ entry.duration = 0;
+ m_templateIndex.insert(key, m_templates.size());
+ m_templates.append(entry);
+ return m_templates.last();
+}
+
+/**
+ * Adds a compiled module. The events of its time trace, if the compiler
+ * wrote one, are moved to the module's place in the build.
+ */
+void DBuildProfile::addModule(const QString &source, int worker, qint64 start, qint64 duration,
+                              const QString &traceFile)
+{
+ Module module;
+ module.source = source;
+ module.worker = worker;
+ module.start = start;
+ module.duration = duration;
+ m_modules.append(module);
+
+ QFile file(traceFile);
+ if (traceFile.isEmpty() || !file.open(QIODevice::ReadOnly))
+  return;
+ const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object()
+   .value(QLatin1String("traceEvents")).toArray();
+ file.close();
+ file.remove();
+ foreach (const QJsonValue &value, events)
+ {
+  QJsonObject event = value.toObject();
+  const QString name = event.value(QLatin1String("name")).toString();
+  // the totals of the whole compilation make no sense on the build's time line
+  if (event.value(QLatin1String("ph")).toString() != QLatin1String("X")
+    || name.startsWith(QLatin1String("Total ")))
+   continue;
+  const qint64 eventDuration = qint64(event.value(QLatin1String("dur")).toDouble());
+  if (name.contains(QLatin1String("template"), Qt::CaseInsensitive))
+  {
+   const QString detail = event.value(QLatin1String("args")).toObject()
+     .value(QLatin1String("detail")).toString();
+   Template &entry = templateEntry(detail.isEmpty() ? name : detail, QString());
+   ++entry.instances;
+   entry.duration += eventDuration;
+  }
+  event.insert(QLatin1String("ts"), double(start + qint64(event.value(QLatin1String("ts")).toDouble())));
+  event.insert(QLatin1String("pid"), PROCESS_ID);
+  event.insert(QLatin1String("tid"), worker + 1);
+  m_traceEvents.append(event);
+ }
+}
+
+/**
+ * dmd -vtemplates prints one line per template, at the end of the module's
+ * output:
+ *   file.d(12): vtemplate: 3 (2 distinct) instantiation(s) of template `foo(T)` found
+ */
+bool DBuildProfile::parseOutput(const QString &line)
+{
+ static const QRegularExpression vtemplate(QLatin1String(
+   "^(.*\\(\\d+(?:,\\d+)?\\)): vtemplate: (\\d+) \\((\\d+) distinct\\) instantiation\\(s\\) "
+   "of template `(.*)` found"));
+ const QRegularExpressionMatch match = vtemplate.match(line);
+ if (!match.hasMatch())
+  return false;
+ Template &entry = templateEntry(match.captured(4), match.captured(1));
+ entry.instances += match.captured(2).toInt();
+ entry.distinct += match.captured(3).toInt();
+ return true;
+}
+
+QList<DBuildProfile::Template> DBuildProfile::templates(int count) const
+{
+ QList<Template> result = m_templates;
+ std::sort(result.begin(), result.end(), moreExpensive);
+ return result.mid(0, count);
+}
+
+bool DBuildProfile::save(const QString &fileName) const
+{
+ QJsonArray events;
+ QSet<int> workers;
+ foreach (const Module &module, m_modules)
+ {
+  events.append(moduleEvent(module));
+  workers.insert(module.worker);
+ }
+ foreach (int worker, workers)
+  events.append(threadNameEvent(worker));
+ foreach (const QJsonValue &event, m_traceEvents)
+  events.append(event);
+
+ QJsonArray templates;
+ foreach (const Template &entry, m_templates)
+ {
+  QJsonObject object;
+  object.insert(QLatin1String("name"), entry.name);
+  object.insert(QLatin1String("location"), entry.location);
+  object.insert(QLatin1String("instances"), entry.instances);
+  object.insert(QLatin1String("distinct"), entry.distinct);
+  object.insert(QLatin1String("dur"), double(entry.duration));
+  templates.append(object);
+ }
+
+ QJsonObject root;
+ root.insert(QLatin1String("traceEvents"), events);
+ root.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+ // ignored by trace viewers
+ root.insert(QLatin1String("dTemplates"), templates);
+
+ QDir().mkpath(QFileInfo(fileName).absolutePath());
+ QSaveFile file(fileName);
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+ return file.commit();
+}
+
+bool DBuildProfile::load(const QString &fileName)
+{
+ m_modules.clear();
+ m_templates.clear();
+ m_templateIndex.clear();
+ m_traceEvents = QJsonArray();
+
+ QFile file(fileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return false;
+ const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+ if (root.isEmpty())
+  return false;
+
+ foreach (const QJsonValue &value, root.value(QLatin1String("traceEvents")).toArray())
+ {
+  const QJsonObject event = value.toObject();
+  if (event.value(QLatin1String("cat")).toString() != QLatin1String(MODULE_CATEGORY))
+   continue;
+  Module module;
+  module.source = event.value(QLatin1String("args")).toObject().value(QLatin1String("file")).toString();
+  module.worker = event.value(QLatin1String("tid")).toInt() - 1;
+  module.start = qint64(event.value(QLatin1String("ts")).toDouble());
+  module.duration = qint64(event.value(QLatin1String("dur")).toDouble());
+  m_modules.append(module);
+ }
+ foreach (const QJsonValue &value, root.value(QLatin1String("dTemplates")).toArray())
+ {
+  const QJsonObject object = value.toObject();
+  Template &entry = templateEntry(object.value(QLatin1String("name")).toString(),
+                                  object.value(QLatin1String("location")).toString());
+  entry.instances = object.value(QLatin1String("instances")).toInt();
+  entry.distinct = object.value(QLatin1String("distinct")).toInt();
+  entry.duration = qint64(object.value(QLatin1String("dur")).toDouble());
+ }
+ return true;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
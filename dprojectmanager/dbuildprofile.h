@@ -0,0 +1,65 @@
+#ifndef DBUILDPROFILE_H
+#define DBUILDPROFILE_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QStringList>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Compile times of the modules of a profiled build and the template
+ * instantiations that cost the most. dmd reports instantiation counts with
+ * -vtemplates, ldc writes a time trace per module with -ftime-trace; both
+ * are gathered here. The profile is saved in the Chrome trace format, with
+ * one thread per compiler process, so chrome://tracing can show it too.
+ */
+class DBuildProfile
+{
+public:
+ struct Module
+ {
+  QString source;
+  int worker;
+  qint64 start;    ///< in microseconds since the build began
+  qint64 duration; ///< in microseconds
+ };
+ struct Template
+ {
+  QString name;
+  QString location; ///< file(line) of the declaration, if known
+  int instances;
+  int distinct;
+  qint64 duration; ///< in microseconds, from time traces only
+ };
+
+ static QString fileName(const QString &buildDirectory);
+ /// Flags that make @a command report what a module's compilation spent its time on.
+ static QStringList compilerArguments(const QString &command, const QString &traceFile);
+
+ void addModule(const QString &source, int worker, qint64 start, qint64 duration,
+                const QString &traceFile);
+ /// Takes in a line of compiler output; returns true if it was part of the statistics.
+ bool parseOutput(const QString &line);
+
+ const QList<Module> &modules() const { return m_modules; }
+ /// The most expensive templates: by time if there is any, otherwise by instances.
+ QList<Template> templates(int count) const;
+
+ bool save(const QString &fileName) const;
+ bool load(const QString &fileName);
+
+private:
+ Template &templateEntry(const QString &name, const QString &location);
+
+ QList<Module> m_modules;
+ QList<Template> m_templates;
+ QHash<QString, int> m_templateIndex; ///< by name and location
+ QJsonArray m_traceEvents; ///< of the compilers' own time traces
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DBUILDPROFILE_H
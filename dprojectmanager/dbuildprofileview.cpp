@@ -0,0 +1,148 @@
+#include "dbuildprofileview.h"
+
+#include "dprojectmanagerconstants.h"
+#include "dproject.h"
+#include "dbuildprofile.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/session.h>
+#include <projectexplorer/target.h>
+
+#include <QDir>
+#include <QHeaderView>
+#include <QRegularExpression>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int FileNameRole = Qt::UserRole;
+const int LineRole = Qt::UserRole + 1;
+const int TEMPLATE_COUNT = 100;
+
+enum Column { NameColumn, TimeColumn, InstancesColumn, ColumnCount };
+
+double milliseconds(qint64 microseconds)
+{
+ return qRound64(microseconds / 100.0) / 10.0;
+}
+} // namespace
+
+DBuildProfileView::DBuildProfileView(QWidget *parent)
+ : QTreeWidget(parent)
+{
+ setColumnCount(ColumnCount);
+ setHeaderLabels(QStringList() << tr("Module / Template") << tr("Time (ms)") << tr("Instances"));
+ header()->setStretchLastSection(false);
+ header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+ setUniformRowHeights(true);
+ setSortingEnabled(true);
+ sortByColumn(TimeColumn, Qt::DescendingOrder);
+ connect(this, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(openItem(QTreeWidgetItem*)));
+ connect(SessionManager::instance(), SIGNAL(startupProjectChanged(ProjectExplorer::Project*)),
+         this, SLOT(setProject(ProjectExplorer::Project*)));
+ connect(BuildManager::instance(), SIGNAL(buildStateChanged(ProjectExplorer::Project*)),
+         this, SLOT(buildStateChanged(ProjectExplorer::Project*)));
+ setProject(SessionManager::startupProject());
+}
+
+void DBuildProfileView::setProject(Project *project)
+{
+ m_project = qobject_cast<DProject *>(project);
+ refresh();
+}
+
+void DBuildProfileView::buildStateChanged(Project *project)
+{
+ if (project == m_project && !BuildManager::isBuilding(project))
+  refresh();
+}
+
+void DBuildProfileView::refresh()
+{
+ clear();
+ if (!m_project || !m_project->activeTarget())
+  return;
+ BuildConfiguration *bc = m_project->activeTarget()->activeBuildConfiguration();
+ DBuildProfile profile;
+ if (!bc || !profile.load(DBuildProfile::fileName(bc->buildDirectory().toString())))
+  return;
+
+ QTreeWidgetItem *modulesItem = new QTreeWidgetItem(
+    QStringList(tr("Modules (%1)").arg(profile.modules().size())));
+ qint64 total = 0;
+ foreach (const DBuildProfile::Module &module, profile.modules())
+ {
+  QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(QDir::toNativeSeparators(module.source)));
+  item->setData(NameColumn, FileNameRole, module.source);
+  item->setData(TimeColumn, Qt::DisplayRole, milliseconds(module.duration));
+  modulesItem->addChild(item);
+  total += module.duration;
+ }
+ modulesItem->setData(TimeColumn, Qt::DisplayRole, milliseconds(total));
+ addTopLevelItem(modulesItem);
+
+ static const QRegularExpression location(QLatin1String("^(.*)\\((\\d+)(?:,\\d+)?\\)$"));
+ QTreeWidgetItem *templatesItem = new QTreeWidgetItem(QStringList(tr("Templates")));
+ foreach (const DBuildProfile::Template &entry, profile.templates(TEMPLATE_COUNT))
+ {
+  QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(entry.name));
+  const QRegularExpressionMatch match = location.match(entry.location);
+  if (match.hasMatch())
+  {
+   item->setToolTip(NameColumn, QDir::toNativeSeparators(entry.location));
+   item->setData(NameColumn, FileNameRole, match.captured(1));
+   item->setData(NameColumn, LineRole, match.captured(2).toInt());
+  }
+  if (entry.duration)
+   item->setData(TimeColumn, Qt::DisplayRole, milliseconds(entry.duration));
+  item->setData(InstancesColumn, Qt::DisplayRole, entry.instances);
+  templatesItem->addChild(item);
+ }
+ addTopLevelItem(templatesItem);
+
+ modulesItem->setExpanded(true);
+ templatesItem->setExpanded(true);
+}
+
+void DBuildProfileView::openItem(QTreeWidgetItem *item)
+{
+ QString fileName = item->data(NameColumn, FileNameRole).toString();
+ if (fileName.isEmpty() || !m_project || !m_project->activeTarget())
+  return;
+ // dmd reports locations relative to the directory it ran in
+ BuildConfiguration *bc = m_project->activeTarget()->activeBuildConfiguration();
+ if (bc)
+  fileName = QDir(bc->buildDirectory().toString()).absoluteFilePath(fileName);
+ const int line = item->data(NameColumn, LineRole).toInt();
+ if (line > 0)
+  Core::EditorManager::openEditorAt(fileName, line);
+ else
+  Core::EditorManager::openEditor(fileName);
+}
+
+//--------------------------------------------------------------------------------------
+
+QString DBuildProfileViewFactory::displayName() const
+{
+ return tr("D Build Profile");
+}
+
+Core::Id DBuildProfileViewFactory::id() const
+{
+ return Core::Id(Constants::D_BUILD_PROFILE_VIEW_ID);
+}
+
+Core::NavigationView DBuildProfileViewFactory::createWidget()
+{
+ Core::NavigationView view;
+ view.widget = new DBuildProfileView;
+ return view;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
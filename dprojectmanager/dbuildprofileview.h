@@ -0,0 +1,52 @@
+#ifndef DBUILDPROFILEVIEW_H
+#define DBUILDPROFILEVIEW_H
+
+#include <coreplugin/inavigationwidgetfactory.h>
+
+#include <QPointer>
+#include <QTreeWidget>
+
+namespace ProjectExplorer { class Project; }
+
+namespace DProjectManager {
+namespace Internal {
+
+class DProject;
+
+/**
+ * The module compile times and most expensive templates of the last
+ * profiled build of the startup D project, sortable by any column.
+ * An item opens its module or template declaration.
+ */
+class DBuildProfileView : public QTreeWidget
+{
+ Q_OBJECT
+
+public:
+ explicit DBuildProfileView(QWidget *parent = 0);
+
+private slots:
+ void setProject(ProjectExplorer::Project *project);
+ void buildStateChanged(ProjectExplorer::Project *project);
+ void refresh();
+ void openItem(QTreeWidgetItem *item);
+
+private:
+ QPointer<DProject> m_project;
+};
+
+class DBuildProfileViewFactory : public Core::INavigationWidgetFactory
+{
+ Q_OBJECT
+
+public:
+ QString displayName() const;
+ int priority() const { return 610; }
+ Core::Id id() const;
+ Core::NavigationView createWidget();
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DBUILDPROFILEVIEW_H
@@ -0,0 +1,299 @@
+#include "dcompilechecker.h"
+#include "dproject.h"
+#include "dmakestep.h"
+
+#include "deditor/deditorconstants.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
+#include <coreplugin/idocument.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/buildsteplist.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/session.h>
+#include <projectexplorer/target.h>
+#include <texteditor/basetexteditor.h>
+#include <texteditor/basetextmark.h>
+#include <utils/qtcprocess.h>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QTextBlock>
+#include <QTextDocument>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int CHECK_DELAY = 800;
+const int CACHE_SIZE = 32;
+}
+
+DCompileChecker::DCompileChecker(QObject *parent)
+ : QObject(parent),
+   m_process(new QProcess(this)),
+   m_pending(false)
+{
+ m_timer.setSingleShot(true);
+ m_timer.setInterval(CHECK_DELAY);
+ connect(&m_timer, SIGNAL(timeout()), this, SLOT(check()));
+
+ m_process->setProcessChannelMode(QProcess::MergedChannels);
+ connect(m_process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished()));
+
+ connect(Core::EditorManager::instance(), SIGNAL(currentEditorChanged(Core::IEditor*)),
+         this, SLOT(currentEditorChanged(Core::IEditor*)));
+ connect(BuildManager::instance(), SIGNAL(buildStateChanged(ProjectExplorer::Project*)),
+         this, SLOT(buildStateChanged(ProjectExplorer::Project*)));
+}
+
+DCompileChecker::~DCompileChecker()
+{
+ clearMarks();
+ if (m_process->state() != QProcess::NotRunning)
+ {
+  m_process->kill();
+  m_process->waitForFinished(1000);
+ }
+}
+
+/**
+ * Picks the messages about @a fileName out of the compiler output, e.g.
+ * "file.d(12): Error: ..." or "file.d(12,5): Deprecation: ..." with -vcolumns.
+ */
+QList<DDiagnostic> DCompileChecker::parseOutput(const QString &output, const QString &fileName)
+{
+ static QRegExp re(QLatin1String("^(.+)\\((\\d+)(?:,(\\d+))?\\): (Error|Warning|Deprecation): (.*)$"));
+
+ QList<DDiagnostic> diagnostics;
+ const QString cleanName = QDir::cleanPath(fileName);
+ foreach (const QString &line, output.split(QLatin1Char('\n')))
+ {
+  if (re.indexIn(line.trimmed()) == -1)
+   continue;
+  if (QDir::cleanPath(re.cap(1)) != cleanName)
+   continue;
+  DDiagnostic d;
+  d.line = re.cap(2).toInt();
+  d.column = re.cap(3).toInt();
+  if (re.cap(4) == QLatin1String("Warning"))
+   d.level = DDiagnostic::Warning;
+  else if (re.cap(4) == QLatin1String("Deprecation"))
+   d.level = DDiagnostic::Deprecation;
+  d.message = re.cap(5);
+  diagnostics.append(d);
+ }
+ return diagnostics;
+}
+
+void DCompileChecker::currentEditorChanged(Core::IEditor *editor)
+{
+ m_timer.stop();
+ clearMarks();
+ if (m_widget)
+ {
+  disconnect(m_widget->document(), SIGNAL(contentsChanged()), this, SLOT(documentChanged()));
+  m_widget->setExtraSelections(TextEditor::BaseTextEditorWidget::CodeWarningsSelection,
+                               QList<QTextEdit::ExtraSelection>());
+ }
+ m_widget = 0;
+ m_fileName.clear();
+
+ if (!editor || editor->id() != Core::Id(DEditor::Constants::C_DEDITOR_ID))
+  return;
+ m_widget = qobject_cast<TextEditor::BaseTextEditorWidget *>(editor->widget());
+ if (!m_widget)
+  return;
+ m_fileName = editor->document()->filePath();
+ connect(m_widget->document(), SIGNAL(contentsChanged()), this, SLOT(documentChanged()));
+ m_timer.start();
+}
+
+void DCompileChecker::documentChanged()
+{
+ m_timer.start();
+}
+
+bool DCompileChecker::commandFor(const QString &fileName, QString *program, QStringList *arguments,
+                                 QString *workingDirectory, QProcessEnvironment *environment) const
+{
+ DProject *project = qobject_cast<DProject *>(SessionManager::projectForFile(fileName));
+ if (!project || !project->activeTarget())
+  return false;
+ BuildConfiguration *bc = project->activeTarget()->activeBuildConfiguration();
+ if (!bc)
+  return false;
+ BuildStepList *bsl = bc->stepList(ProjectExplorer::Constants::BUILDSTEPS_BUILD);
+ if (!bsl)
+  return false;
+
+ foreach (BuildStep *step, bsl->steps())
+ {
+  DMakeStep *makeStep = qobject_cast<DMakeStep *>(step);
+  if (!makeStep)
+   continue;
+  const Utils::Environment env = bc->environment();
+  *program = makeStep->makeCommand(env);
+  *arguments = Utils::QtcProcess::splitArgs(makeStep->checkArguments());
+  *workingDirectory = bc->buildDirectory().toString();
+  *environment = env.toProcessEnvironment();
+  return true;
+ }
+ return false;
+}
+
+void DCompileChecker::check()
+{
+ if (!m_widget)
+  return;
+ if (BuildManager::isBuilding() || m_process->state() != QProcess::NotRunning)
+ {
+  // Picked up again by processFinished() or once the build is done.
+  m_pending = true;
+  return;
+ }
+ m_pending = false;
+
+ QString program;
+ QStringList arguments;
+ QString workingDirectory;
+ QProcessEnvironment environment;
+ if (!commandFor(m_fileName, &program, &arguments, &workingDirectory, &environment))
+  return;
+
+ const QByteArray text = m_widget->document()->toPlainText().toUtf8();
+ QCryptographicHash hash(QCryptographicHash::Sha1);
+ hash.addData(text);
+ hash.addData(program.toUtf8());
+ hash.addData(arguments.join(QLatin1String("\n")).toUtf8());
+ hash.addData(workingDirectory.toUtf8());
+ const QByteArray key = hash.result();
+
+ if (m_cache.contains(key))
+ {
+  showDiagnostics(m_cache.value(key));
+  return;
+ }
+
+ if (!m_snapshotDir.isValid())
+  return;
+ // Keep the file name, so the module name dmd infers stays the same.
+ m_snapshotFileName = m_snapshotDir.path() + QLatin1Char('/') + QFileInfo(m_fileName).fileName();
+ QFile snapshot(m_snapshotFileName);
+ if (!snapshot.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  return;
+ snapshot.write(text);
+ snapshot.close();
+
+ m_runningKey = key;
+ m_process->setWorkingDirectory(workingDirectory);
+ m_process->setProcessEnvironment(environment);
+ m_process->start(program, arguments << m_snapshotFileName);
+}
+
+void DCompileChecker::processFinished()
+{
+ // A check killed for a build is not a result.
+ if (m_process->exitStatus() == QProcess::NormalExit)
+ {
+  const QString output = QString::fromLocal8Bit(m_process->readAll());
+  insertIntoCache(m_runningKey, parseOutput(output, m_snapshotFileName));
+ }
+ m_runningKey.clear();
+
+ // Shows the result from the cache, or checks the text typed meanwhile.
+ if (m_widget && !BuildManager::isBuilding())
+  check();
+}
+
+void DCompileChecker::buildStateChanged(ProjectExplorer::Project *project)
+{
+ Q_UNUSED(project)
+ if (BuildManager::isBuilding())
+ {
+  if (m_process->state() != QProcess::NotRunning)
+  {
+   m_pending = true;
+   m_process->kill();
+  }
+ }
+ else if (m_pending)
+  m_timer.start();
+}
+
+void DCompileChecker::insertIntoCache(const QByteArray &key, const QList<DDiagnostic> &diagnostics)
+{
+ if (m_cache.contains(key))
+  return;
+ m_cache.insert(key, diagnostics);
+ m_cacheOrder.append(key);
+ if (m_cacheOrder.size() > CACHE_SIZE)
+  m_cache.remove(m_cacheOrder.takeFirst());
+}
+
+void DCompileChecker::showDiagnostics(const QList<DDiagnostic> &diagnostics)
+{
+ clearMarks();
+
+ QTextCharFormat errorFormat;
+ errorFormat.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+ errorFormat.setUnderlineColor(Qt::red);
+ QTextCharFormat warningFormat = errorFormat;
+ warningFormat.setUnderlineColor(Qt::darkYellow);
+ const QIcon errorIcon(QLatin1String(":/projectexplorer/images/compile_error.png"));
+ const QIcon warningIcon(QLatin1String(":/projectexplorer/images/compile_warning.png"));
+
+ QList<QTextEdit::ExtraSelection> selections;
+ QTextDocument *document = m_widget->document();
+ foreach (const DDiagnostic &d, diagnostics)
+ {
+  const QTextBlock block = document->findBlockByNumber(d.line - 1);
+  if (!block.isValid())
+   continue;
+
+  QTextCursor cursor(block);
+  if (d.column > 0 && d.column < block.length())
+  {
+   cursor.setPosition(block.position() + d.column - 1);
+   cursor.movePosition(QTextCursor::EndOfWord, QTextCursor::KeepAnchor);
+  }
+  if (!cursor.hasSelection())
+  {
+   const QString text = block.text();
+   int indent = 0;
+   while (indent < text.length() && text.at(indent).isSpace())
+    ++indent;
+   cursor.setPosition(block.position() + indent);
+   cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+  }
+
+  const bool isError = d.level == DDiagnostic::Error;
+  QTextEdit::ExtraSelection sel;
+  sel.cursor = cursor;
+  sel.format = isError ? errorFormat : warningFormat;
+  sel.format.setToolTip(d.message);
+  selections.append(sel);
+
+  TextEditor::BaseTextMark *mark = new TextEditor::BaseTextMark(m_fileName, d.line);
+  mark->setIcon(isError ? errorIcon : warningIcon);
+  mark->setPriority(TextEditor::ITextMark::HighPriority);
+  mark->init();
+  m_marks.append(mark);
+ }
+ m_widget->setExtraSelections(TextEditor::BaseTextEditorWidget::CodeWarningsSelection, selections);
+}
+
+void DCompileChecker::clearMarks()
+{
+ qDeleteAll(m_marks);
+ m_marks.clear();
+}
+
+} // namespace Internal
+} // namespace DProjectManager
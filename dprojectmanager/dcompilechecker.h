@@ -0,0 +1,88 @@
+#ifndef DCOMPILECHECKER_H
+#define DCOMPILECHECKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace Core { class IEditor; }
+namespace ProjectExplorer { class Project; }
+namespace TextEditor {
+class BaseTextEditorWidget;
+class ITextMark;
+}
+
+namespace DProjectManager {
+namespace Internal {
+
+struct DDiagnostic
+{
+ enum Level
+ {
+  Error,
+  Warning,
+  Deprecation
+ };
+
+ DDiagnostic() : level(Error), line(0), column(0) {}
+
+ Level level;
+ int line;
+ int column; ///< 1-based, 0 when the compiler did not report one
+ QString message;
+};
+
+/**
+ * Checks the current D editor in the background: once typing settles the
+ * document snapshot is compiled with DMakeStep::checkArguments() and the
+ * messages are shown as text marks and squiggles. Results are cached by a
+ * hash of the text and the command line, and at most one check runs at a
+ * time, never while a build is in progress.
+ */
+class DCompileChecker : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DCompileChecker(QObject *parent = 0);
+ ~DCompileChecker();
+
+ static QList<DDiagnostic> parseOutput(const QString &output, const QString &fileName);
+
+private slots:
+ void currentEditorChanged(Core::IEditor *editor);
+ void documentChanged();
+ void check();
+ void processFinished();
+ void buildStateChanged(ProjectExplorer::Project *project);
+
+private:
+ bool commandFor(const QString &fileName, QString *program, QStringList *arguments,
+                 QString *workingDirectory, QProcessEnvironment *environment) const;
+ void showDiagnostics(const QList<DDiagnostic> &diagnostics);
+ void clearMarks();
+ void insertIntoCache(const QByteArray &key, const QList<DDiagnostic> &diagnostics);
+
+ QTimer m_timer;
+ QPointer<TextEditor::BaseTextEditorWidget> m_widget;
+ QString m_fileName;
+
+ QProcess *m_process;
+ QTemporaryDir m_snapshotDir;
+ QString m_snapshotFileName;
+ QByteArray m_runningKey;
+ bool m_pending;
+
+ QHash<QByteArray, QList<DDiagnostic> > m_cache;
+ QList<QByteArray> m_cacheOrder;
+ QList<TextEditor::ITextMark *> m_marks;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DCOMPILECHECKER_H
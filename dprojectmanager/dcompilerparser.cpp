@@ -0,0 +1,232 @@
+#include "dcompilerparser.h"
+
+#include <projectexplorer/projectexplorerconstants.h>
+
+#include <QDir>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+/** Reads the digits at @a pos; returns -1 if there are none. */
+int readNumber(const QString &text, int *pos, int end)
+{
+ int number = -1;
+ for (; *pos < end && text.at(*pos).isDigit(); ++*pos)
+  number = qMax(number, 0) * 10 + text.at(*pos).digitValue();
+ return number;
+}
+
+/** The follow-up of dmd for every template instance on the way to an error. */
+bool isInstantiationError(const QString &message)
+{
+ return message.endsWith(QLatin1String("error instantiating"));
+}
+} // namespace
+
+DCompilerParser::DCompilerParser()
+{
+ setObjectName(QLatin1String("DCompilerParser"));
+}
+
+void DCompilerParser::stdOutput(const QString &line)
+{
+ if (parseLine(line))
+  return;
+ doFlush();
+ IOutputParser::stdOutput(line);
+}
+
+void DCompilerParser::stdError(const QString &line)
+{
+ if (parseLine(line))
+  return;
+ doFlush();
+ IOutputParser::stdError(line);
+}
+
+void DCompilerParser::setWorkingDirectory(const QString &workingDirectory)
+{
+ m_workingDirectory = workingDirectory;
+ IOutputParser::setWorkingDirectory(workingDirectory);
+}
+
+void DCompilerParser::doFlush()
+{
+ if (m_currentTask.isNull())
+  return;
+ Task task = m_currentTask;
+ m_currentTask.clear();
+ const QString key = QString::number(task.type) + task.file.toString()
+   + QLatin1Char(':') + QString::number(task.line) + QLatin1Char(':') + task.description;
+ if (m_reported.contains(key))
+  return;
+ m_reported.insert(key);
+ emit addTask(task);
+}
+
+/** Returns false for a line that is none of the compiler's diagnostics. */
+bool DCompilerParser::parseLine(const QString &line)
+{
+ const Diagnostic diagnostic = parseDiagnostic(line);
+ if (diagnostic.kind == NoDiagnostic)
+ {
+  // the source line and caret of ldc's -verrors-context
+  if (m_currentTask.isNull() || !line.startsWith(QLatin1Char(' ')) || line.trimmed().isEmpty())
+   return false;
+  QString context = line;
+  while (context.endsWith(QLatin1Char('\n')) || context.endsWith(QLatin1Char('\r')))
+   context.chop(1);
+  amendTask(context);
+  return true;
+ }
+
+ QString location;
+ if (!diagnostic.file.isEmpty())
+  location = QDir::toNativeSeparators(diagnostic.file)
+    + QString::fromLatin1("(%1): ").arg(diagnostic.line);
+ if (diagnostic.kind == Supplemental
+   || (diagnostic.kind == Error && isInstantiationError(diagnostic.message)))
+ {
+  if (m_currentTask.isNull())
+   return false;
+  amendTask(location + diagnostic.message);
+  return true;
+ }
+
+ doFlush();
+ QString file = diagnostic.file;
+ if (!file.isEmpty() && !m_workingDirectory.isEmpty())
+  file = QDir::cleanPath(QDir(m_workingDirectory).absoluteFilePath(file));
+ m_currentTask = Task(diagnostic.kind == Error ? Task::Error : Task::Warning,
+                      diagnostic.message, Utils::FileName::fromUserInput(file),
+                      diagnostic.file.isEmpty() ? -1 : diagnostic.line,
+                      Core::Id(ProjectExplorer::Constants::TASK_CATEGORY_COMPILE));
+ return true;
+}
+
+void DCompilerParser::amendTask(const QString &text)
+{
+ m_currentTask.description += QLatin1Char('\n') + text;
+}
+
+/**
+ * Splits off the location and the kind of a diagnostic. A line without a
+ * location is one only if it starts with the kind, e.g.
+ * "Error: cannot find source code for runtime library file 'object.d'".
+ */
+DCompilerParser::Diagnostic DCompilerParser::parseDiagnostic(const QString &line)
+{
+ Diagnostic diagnostic;
+ diagnostic.line = -1;
+ diagnostic.kind = NoDiagnostic;
+
+ int end = line.size();
+ while (end > 0 && (line.at(end - 1) == QLatin1Char('\n') || line.at(end - 1) == QLatin1Char('\r')))
+  --end;
+ const QString text = line.left(end);
+
+ int pos = 0;
+ const bool located = parseDmdLocation(text, &diagnostic, &pos)
+   || parseGccLocation(text, &diagnostic, &pos);
+ const QString rest = text.mid(pos);
+ int messageStart = 0;
+ const Kind kind = parseKind(rest, &messageStart);
+ if (kind == NoDiagnostic || (!located && kind == Supplemental))
+  return diagnostic;
+ diagnostic.kind = kind;
+ diagnostic.message = rest.mid(messageStart);
+ return diagnostic;
+}
+
+/** file(line): or file(line,column): */
+bool DCompilerParser::parseDmdLocation(const QString &line, Diagnostic *diagnostic, int *end)
+{
+ const QLatin1String separator("): ");
+ for (int close = line.indexOf(separator); close > 0; close = line.indexOf(separator, close + 1))
+ {
+  const int open = line.lastIndexOf(QLatin1Char('('), close);
+  if (open <= 0)
+   continue;
+  int pos = open + 1;
+  const int number = readNumber(line, &pos, close);
+  if (number < 0)
+   continue;
+  if (pos < close && line.at(pos) == QLatin1Char(','))
+  {
+   ++pos;
+   if (readNumber(line, &pos, close) < 0)
+    continue;
+  }
+  if (pos != close)
+   continue;
+  diagnostic->file = line.left(open);
+  diagnostic->line = number;
+  *end = close + separator.size();
+  return true;
+ }
+ return false;
+}
+
+/** file:line: or file:line:column: followed by a space */
+bool DCompilerParser::parseGccLocation(const QString &line, Diagnostic *diagnostic, int *end)
+{
+ for (int colon = line.indexOf(QLatin1Char(':')); colon > 0; colon = line.indexOf(QLatin1Char(':'), colon + 1))
+ {
+  int pos = colon + 1;
+  const int number = readNumber(line, &pos, line.size());
+  if (number < 0 || pos >= line.size() || line.at(pos) != QLatin1Char(':'))
+   continue;
+  ++pos;
+  int column = pos;
+  if (readNumber(line, &column, line.size()) >= 0 && column < line.size()
+    && line.at(column) == QLatin1Char(':'))
+   pos = column + 1;
+  if (pos >= line.size() || line.at(pos) != QLatin1Char(' '))
+   continue;
+  diagnostic->file = line.left(colon);
+  diagnostic->line = number;
+  *end = pos + 1;
+  return true;
+ }
+ return false;
+}
+
+/** dmd indents supplemental lines, gdc calls them notes. */
+DCompilerParser::Kind DCompilerParser::parseKind(const QString &text, int *end)
+{
+ // case matters: the dmd front end capitalizes, gdc does not
+ static const struct { const char *prefix; Kind kind; } prefixes[] = {
+  { "Error: ", Error },
+  { "Warning: ", Warning },
+  { "Deprecation: ", Deprecation },
+  { "error: ", Error },
+  { "fatal error: ", Error },
+  { "warning: ", Warning },
+  { "deprecation: ", Deprecation },
+  { "note: ", Supplemental }
+ };
+ for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); ++i)
+ {
+  const QLatin1String prefix(prefixes[i].prefix);
+  if (text.startsWith(prefix))
+  {
+   *end = prefix.size();
+   return prefixes[i].kind;
+  }
+ }
+ if (!text.startsWith(QLatin1Char(' ')))
+  return NoDiagnostic;
+ int pos = 0;
+ while (pos < text.size() && text.at(pos).isSpace())
+  ++pos;
+ if (pos == text.size())
+  return NoDiagnostic;
+ *end = pos;
+ return Supplemental;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,61 @@
+#ifndef DCOMPILERPARSER_H
+#define DCOMPILERPARSER_H
+
+#include <projectexplorer/ioutputparser.h>
+#include <projectexplorer/task.h>
+
+#include <QSet>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Turns the diagnostics of dmd, ldc and gdc into tasks. Both the
+ * file(line,column): Error: form of the dmd front end and the
+ * file:line:column: error: form of gdc are read. Supplemental lines such as
+ * "instantiated from here", the follow-up errors of failed template
+ * instances and source context go into the description of the diagnostic
+ * they belong to, so a template chain is one task. A diagnostic already
+ * reported, e.g. by another module of an incremental build, is dropped.
+ */
+class DCompilerParser : public ProjectExplorer::IOutputParser
+{
+ Q_OBJECT
+
+public:
+ DCompilerParser();
+
+ void stdOutput(const QString &line);
+ void stdError(const QString &line);
+ void setWorkingDirectory(const QString &workingDirectory);
+
+protected:
+ void doFlush();
+
+private:
+ enum Kind { Error, Warning, Deprecation, Supplemental, NoDiagnostic };
+
+ struct Diagnostic
+ {
+  QString file;
+  int line;
+  Kind kind;
+  QString message;
+ };
+
+ bool parseLine(const QString &line);
+ static Diagnostic parseDiagnostic(const QString &line);
+ static bool parseDmdLocation(const QString &line, Diagnostic *diagnostic, int *end);
+ static bool parseGccLocation(const QString &line, Diagnostic *diagnostic, int *end);
+ static Kind parseKind(const QString &text, int *end);
+ void amendTask(const QString &text);
+
+ QString m_workingDirectory;
+ ProjectExplorer::Task m_currentTask;
+ QSet<QString> m_reported;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DCOMPILERPARSER_H
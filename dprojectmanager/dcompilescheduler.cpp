@@ -0,0 +1,247 @@
+#include "dcompilescheduler.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QThread>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int CANCEL_CHECK_INTERVAL = 100;
+
+/// Splits process output into lines that keep their line end.
+QStringList splitLines(const QByteArray &data)
+{
+ QStringList lines;
+ int start = 0;
+ while (start < data.size())
+ {
+  int end = data.indexOf('\n', start);
+  end = end < 0 ? data.size() : end + 1;
+  lines.append(QString::fromLocal8Bit(data.constData() + start, end - start));
+  start = end;
+ }
+ return lines;
+}
+} // namespace
+
+DCompileScheduler::DCompileScheduler(const QList<DCompileJob> &jobs, const QString &command,
+                                     const QString &workingDirectory,
+                                     const QProcessEnvironment &environment, QObject *parent)
+ : QObject(parent),
+   m_jobs(jobs),
+   m_command(command),
+   m_workingDirectory(workingDirectory),
+   m_environment(environment),
+   m_workerCount(0),
+   m_stopOnError(true),
+   m_reported(0),
+   m_failed(false),
+   m_canceled(false),
+   m_finishing(false),
+   m_future(0)
+{
+ connect(&m_cancelTimer, SIGNAL(timeout()), this, SLOT(checkCanceled()));
+}
+
+DCompileScheduler::~DCompileScheduler()
+{
+ foreach (QProcess *process, m_running.keys())
+ {
+  process->disconnect(this);
+  process->kill();
+  process->waitForFinished();
+  delete process;
+ }
+}
+
+void DCompileScheduler::setWorkerCount(int count)
+{
+ m_workerCount = count;
+}
+
+void DCompileScheduler::start(QFutureInterface<bool> &fi)
+{
+ int workers = m_workerCount > 0 ? m_workerCount : QThread::idealThreadCount();
+ workers = qBound(1, workers, qMax(1, m_jobs.size()));
+ m_queues = QVector<QList<int> >(workers);
+ for (int i = 0; i < m_jobs.size(); ++i)
+  m_queues[i % workers].append(i);
+ m_states = QVector<JobState>(m_jobs.size(), Pending);
+ m_outputs = QVector<JobOutput>(m_jobs.size());
+ m_timings = QVector<JobTiming>(m_jobs.size());
+ m_clock.start();
+ m_reported = 0;
+ m_failed = false;
+ m_canceled = false;
+ m_finishing = false;
+ m_future = &fi;
+ m_cancelTimer.start(CANCEL_CHECK_INTERVAL);
+
+ startJobs();
+ finishWhenDone();
+}
+
+/** The front of the own queue, or else the back of the longest other one. */
+int DCompileScheduler::takeJob(int worker)
+{
+ if (!m_queues.at(worker).isEmpty())
+  return m_queues[worker].takeFirst();
+ int victim = -1;
+ for (int i = 0; i < m_queues.size(); ++i)
+  if (!m_queues.at(i).isEmpty() && (victim < 0 || m_queues.at(i).size() > m_queues.at(victim).size()))
+   victim = i;
+ return victim < 0 ? -1 : m_queues[victim].takeLast();
+}
+
+void DCompileScheduler::startJobs()
+{
+ if (m_canceled || (m_failed && m_stopOnError))
+ {
+  for (int i = 0; i < m_queues.size(); ++i)
+   foreach (int job, m_queues.at(i))
+    m_states[job] = Skipped;
+  m_queues.fill(QList<int>());
+  return;
+ }
+
+ QVector<bool> busy(m_queues.size(), false);
+ foreach (const RunningJob &running, m_running)
+  busy[running.worker] = true;
+ for (int worker = 0; worker < m_queues.size(); ++worker)
+ {
+  if (busy.at(worker))
+   continue;
+  const int job = takeJob(worker);
+  if (job < 0)
+   break;
+  const DCompileJob &compile = m_jobs.at(job);
+  QDir().mkpath(QFileInfo(compile.object).absolutePath());
+
+  QProcess *process = new QProcess;
+  process->setWorkingDirectory(m_workingDirectory);
+  process->setProcessEnvironment(m_environment);
+  connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(readOutput()));
+  connect(process, SIGNAL(readyReadStandardError()), this, SLOT(readOutput()));
+  connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished()));
+  connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processError()));
+  RunningJob running;
+  running.worker = worker;
+  running.job = job;
+  m_running.insert(process, running);
+  m_states[job] = Running;
+  m_timings[job].worker = worker;
+  m_timings[job].start = m_clock.nsecsElapsed() / 1000;
+  process->start(m_command, compile.arguments);
+ }
+}
+
+void DCompileScheduler::readOutput()
+{
+ QProcess *process = qobject_cast<QProcess *>(sender());
+ if (!process || !m_running.contains(process))
+  return;
+ JobOutput &output = m_outputs[m_running.value(process).job];
+ output.out += process->readAllStandardOutput();
+ output.err += process->readAllStandardError();
+}
+
+void DCompileScheduler::processFinished()
+{
+ QProcess *process = qobject_cast<QProcess *>(sender());
+ if (!process || !m_running.contains(process))
+  return;
+ JobOutput &output = m_outputs[m_running.value(process).job];
+ output.out += process->readAllStandardOutput();
+ output.err += process->readAllStandardError();
+ if (process->exitStatus() == QProcess::NormalExit && process->exitCode() != 0)
+  output.err += tr("The process \"%1\" exited with code %2.\n")
+    .arg(QDir::toNativeSeparators(m_command), QString::number(process->exitCode())).toLocal8Bit();
+ finishJob(process, process->exitStatus() == QProcess::NormalExit && process->exitCode() == 0);
+}
+
+void DCompileScheduler::processError()
+{
+ QProcess *process = qobject_cast<QProcess *>(sender());
+ // other errors are followed by finished()
+ if (!process || process->error() != QProcess::FailedToStart || !m_running.contains(process))
+  return;
+ m_outputs[m_running.value(process).job].err +=
+   tr("Could not start process \"%1\".\n").arg(QDir::toNativeSeparators(m_command)).toLocal8Bit();
+ finishJob(process, false);
+}
+
+void DCompileScheduler::finishJob(QProcess *process, bool success)
+{
+ const RunningJob running = m_running.take(process);
+ process->disconnect(this);
+ process->deleteLater();
+ m_states[running.job] = success ? Succeeded : Failed;
+ m_timings[running.job].finish = m_clock.nsecsElapsed() / 1000;
+ if (!success)
+  m_failed = true;
+
+ report(false);
+ startJobs();
+ finishWhenDone();
+}
+
+void DCompileScheduler::checkCanceled()
+{
+ if (!m_future || !m_future->isCanceled() || m_canceled)
+  return;
+ m_canceled = true;
+ startJobs();
+ foreach (QProcess *process, m_running.keys())
+  process->kill();
+ finishWhenDone();
+}
+
+void DCompileScheduler::finishWhenDone()
+{
+ // queued, so finished() never comes from inside start() or a process signal
+ if (m_running.isEmpty() && m_future && !m_finishing)
+ {
+  m_finishing = true;
+  QMetaObject::invokeMethod(this, "finish", Qt::QueuedConnection);
+ }
+}
+
+void DCompileScheduler::finish()
+{
+ m_cancelTimer.stop();
+ report(true);
+ m_future = 0;
+ emit finished(!m_failed && !m_canceled);
+}
+
+/**
+ * Hands on the output of the jobs that are done, in job order. Standard
+ * output of a job comes before its errors. At the end, jobs that never
+ * started are passed over.
+ */
+void DCompileScheduler::report(bool final)
+{
+ for (; m_reported < m_jobs.size(); ++m_reported)
+ {
+  const JobState state = m_states.at(m_reported);
+  if (state == Running || (state == Pending && !final))
+   break;
+  if (state == Pending || state == Skipped)
+   continue;
+  emit jobStarted(m_reported);
+  foreach (const QString &line, splitLines(m_outputs.at(m_reported).out))
+   emit stdOutput(line);
+  foreach (const QString &line, splitLines(m_outputs.at(m_reported).err))
+   emit stdError(line);
+  m_outputs[m_reported] = JobOutput();
+  emit jobFinished(m_reported, state == Succeeded);
+  if (m_future)
+   m_future->setProgressValue(m_reported + 1);
+ }
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,121 @@
+#ifndef DCOMPILESCHEDULER_H
+#define DCOMPILESCHEDULER_H
+
+#include "dincrementalbuild.h"
+
+#include <QElapsedTimer>
+#include <QFutureInterface>
+#include <QHash>
+#include <QObject>
+#include <QProcessEnvironment>
+#include <QTimer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QProcess;
+QT_END_NAMESPACE
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Runs compile jobs on a number of compiler processes at once. Every worker
+ * has its own queue, filled round-robin in the given order, and takes from
+ * its front; a worker with an empty queue steals from the back of the
+ * longest other one. The output of a job is reported when it and all jobs
+ * before it are done, so the log reads as if the jobs ran one after another.
+ * Lives in the GUI thread with the build step that starts it; start() returns
+ * at once and finished() comes when the last compiler has ended, so no event
+ * loop is spun while the step waits.
+ */
+class DCompileScheduler : public QObject
+{
+ Q_OBJECT
+
+public:
+ DCompileScheduler(const QList<DCompileJob> &jobs, const QString &command,
+                   const QString &workingDirectory, const QProcessEnvironment &environment,
+                   QObject *parent = 0);
+ ~DCompileScheduler();
+
+ /// @a count 0 or less uses one worker per core.
+ void setWorkerCount(int count);
+ /// Whether a failed job keeps further jobs from being started.
+ void setStopOnError(bool stop) { m_stopOnError = stop; }
+
+ /// Starts the jobs; @a fi is watched for cancellation and gets the progress.
+ void start(QFutureInterface<bool> &fi);
+ bool isRunning() const { return m_future != 0; }
+ const DCompileJob &job(int index) const { return m_jobs.at(index); }
+ /// The worker that ran a job, and when, in microseconds since run() began.
+ int jobWorker(int index) const { return m_timings.at(index).worker; }
+ qint64 jobStartTime(int index) const { return m_timings.at(index).start; }
+ qint64 jobDuration(int index) const { return m_timings.at(index).finish - m_timings.at(index).start; }
+
+signals:
+ void jobStarted(int job);
+ void stdOutput(const QString &line);
+ void stdError(const QString &line);
+ void jobFinished(int job, bool success);
+ /// Whether all jobs succeeded; false as well when the build got canceled.
+ void finished(bool success);
+
+private slots:
+ void readOutput();
+ void processFinished();
+ void processError();
+ void checkCanceled();
+ void finish();
+
+private:
+ enum JobState { Pending, Running, Succeeded, Failed, Skipped };
+
+ struct JobOutput
+ {
+  QByteArray out;
+  QByteArray err;
+ };
+ struct RunningJob
+ {
+  int worker;
+  int job;
+ };
+ struct JobTiming
+ {
+  JobTiming() : worker(-1), start(0), finish(0) {}
+  int worker;
+  qint64 start;
+  qint64 finish;
+ };
+
+ int takeJob(int worker);
+ void startJobs();
+ void finishJob(QProcess *process, bool success);
+ void report(bool final);
+ void finishWhenDone();
+
+ const QList<DCompileJob> m_jobs;
+ const QString m_command;
+ const QString m_workingDirectory;
+ const QProcessEnvironment m_environment;
+ int m_workerCount;
+ bool m_stopOnError;
+
+ QVector<QList<int> > m_queues;
+ QVector<JobState> m_states;
+ QVector<JobOutput> m_outputs;
+ QVector<JobTiming> m_timings;
+ QElapsedTimer m_clock;
+ QHash<QProcess *, RunningJob> m_running;
+ int m_reported;
+ bool m_failed;
+ bool m_canceled;
+ bool m_finishing;
+ QFutureInterface<bool> *m_future;
+ QTimer m_cancelTimer;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DCOMPILESCHEDULER_H
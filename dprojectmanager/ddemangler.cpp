@@ -0,0 +1,110 @@
+#include "ddemangler.h"
+
+#include "deditor/dsymboldemangler.h"
+
+#include <QCoreApplication>
+#include <QProcess>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int START_TIMEOUT = 3000;
+const int ANSWER_TIMEOUT = 5000;
+const int MAX_PENDING = 200; ///< lines held back before a batch is sent anyway
+} // namespace
+
+DDemangler::DDemangler()
+ : m_disabled(false)
+{
+}
+
+QStringList DDemangler::demangle(const QString &line)
+{
+ bool complete;
+ const QString demangled = DEditor::DSymbolDemangler::demangleText(line, &complete);
+ if (m_disabled || (complete && m_pending.isEmpty()))
+  return QStringList(demangled);
+
+ // what is left for ddemangle, and whatever follows it
+ m_pending.append(demangled);
+ if (m_pending.size() < MAX_PENDING)
+  return QStringList();
+ return flush();
+}
+
+QStringList DDemangler::flush()
+{
+ const QStringList lines = m_pending;
+ m_pending.clear();
+ if (lines.isEmpty() || m_disabled)
+  return lines;
+
+ // a piece of output may hold several lines or end without a line break
+ QByteArray data;
+ QList<bool> terminated;
+ int lineCount = 0;
+ foreach (const QString &line, lines)
+ {
+  terminated.append(line.endsWith(QLatin1Char('\n')));
+  data.append(line.toUtf8());
+  if (!terminated.last())
+   data.append('\n');
+  lineCount += line.count(QLatin1Char('\n')) + (terminated.last() ? 0 : 1);
+ }
+
+ QProcess process;
+ process.start(QLatin1String("ddemangle"));
+ if (!process.waitForStarted(START_TIMEOUT))
+ {
+  m_disabled = true;
+  m_error = QCoreApplication::translate("DProjectManager::Internal::DDemangler",
+                                        "Could not start ddemangle, some symbols stay mangled.");
+  return lines;
+ }
+ // the answer only comes in full when ddemangle sees the end of its input
+ process.write(data);
+ process.closeWriteChannel();
+ if (!process.waitForFinished(ANSWER_TIMEOUT))
+ {
+  process.kill();
+  process.waitForFinished();
+  m_disabled = true;
+  m_error = QCoreApplication::translate("DProjectManager::Internal::DDemangler",
+                                        "ddemangle does not answer, some symbols stay mangled.");
+  return lines;
+ }
+
+ QStringList answer = QString::fromUtf8(process.readAllStandardOutput()).split(QLatin1Char('\n'));
+ // the text after the last line break
+ answer.removeLast();
+ if (answer.size() != lineCount)
+ {
+  m_disabled = true;
+  m_error = QCoreApplication::translate("DProjectManager::Internal::DDemangler",
+                                        "ddemangle gave an unexpected answer, some symbols stay mangled.");
+  return lines;
+ }
+ QStringList result;
+ int next = 0;
+ for (int i = 0; i < lines.size(); ++i)
+ {
+  const int count = lines.at(i).count(QLatin1Char('\n')) + (terminated.at(i) ? 0 : 1);
+  QString text = QStringList(answer.mid(next, count)).join(QLatin1String("\n"));
+  if (terminated.at(i))
+   text.append(QLatin1Char('\n'));
+  result.append(text);
+  next += count;
+ }
+ return result;
+}
+
+QString DDemangler::takeError()
+{
+ const QString error = m_error;
+ m_error.clear();
+ return error;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
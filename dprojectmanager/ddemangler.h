@@ -0,0 +1,39 @@
+#ifndef DDEMANGLER_H
+#define DDEMANGLER_H
+
+#include <QStringList>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Demangles the D symbols in compiler output with DEditor::DSymbolDemangler.
+ * Lines with symbols it cannot decode are held back, with the lines after
+ * them to keep the order, and fed through ddemangle in batches: its output is
+ * block-buffered on a pipe, so a batch is written, the write channel closed
+ * and the answer read when ddemangle exits. If it cannot be started or does
+ * not finish in time, it is not used any more and takeError() says why, once.
+ * All calls have to come from the same thread.
+ */
+class DDemangler
+{
+public:
+ DDemangler();
+
+ /// The lines ready for output, none while lines are held back.
+ QStringList demangle(const QString &line);
+ /// Demangles and returns the lines held back; call it when the output ends.
+ QStringList flush();
+ /// The reason demangling stopped; empty after it was taken once.
+ QString takeError();
+
+private:
+ QStringList m_pending; ///< already demangled as far as DSymbolDemangler can
+ bool m_disabled;
+ QString m_error;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DDEMANGLER_H
@@ -0,0 +1,936 @@
+#include "ddubpackage.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const quint32 CACHE_MAGIC = 0x43425544; // "DUBC"
+const quint32 CACHE_VERSION = 2;
+
+//--------------------------------------------------------------------------------------
+// Recipes
+//--------------------------------------------------------------------------------------
+
+/**
+ * Reads the SDL flavour of a recipe into the same map the JSON one gives,
+ * as far as a build needs it: configurations and build types are skipped.
+ */
+class SdlReader
+{
+public:
+ explicit SdlReader(const QString &text) : m_text(text) {}
+
+ QVariantMap read()
+ {
+  tokenize();
+  int i = 0;
+  QVariantMap map;
+  readTags(i, &map);
+  return map;
+ }
+
+private:
+ enum TokenType { Identifier, Value, Equals, Open, Close, LineEnd };
+ struct Token
+ {
+  Token(TokenType t, const QVariant &v = QVariant()) : type(t), value(v) {}
+  TokenType type;
+  QVariant value;
+ };
+
+ void tokenize();
+ void readTags(int &i, QVariantMap *out);
+ void apply(const QString &name, const QVariantList &values, const QVariantMap &attributes,
+            const QVariantMap &children, bool hasChildren, QVariantMap *out);
+
+ const QString m_text;
+ QList<Token> m_tokens;
+};
+
+void SdlReader::tokenize()
+{
+ const int n = m_text.size();
+ int pos = 0;
+ while (pos < n)
+ {
+  const QChar c = m_text.at(pos);
+  const QChar next = pos + 1 < n ? m_text.at(pos + 1) : QChar();
+  if (c == QLatin1Char('\n') || c == QLatin1Char(';'))
+  {
+   m_tokens.append(Token(LineEnd));
+   ++pos;
+  }
+  else if (c.isSpace())
+   ++pos;
+  else if (c == QLatin1Char('\\'))
+  {
+   // line continuation
+   pos = m_text.indexOf(QLatin1Char('\n'), pos);
+   pos = pos < 0 ? n : pos + 1;
+  }
+  else if (c == QLatin1Char('#') || (c == QLatin1Char('/') && next == QLatin1Char('/'))
+           || (c == QLatin1Char('-') && next == QLatin1Char('-')))
+  {
+   pos = m_text.indexOf(QLatin1Char('\n'), pos);
+   if (pos < 0)
+    pos = n;
+  }
+  else if (c == QLatin1Char('/') && next == QLatin1Char('*'))
+  {
+   pos = m_text.indexOf(QLatin1String("*/"), pos + 2);
+   pos = pos < 0 ? n : pos + 2;
+  }
+  else if (c == QLatin1Char('"'))
+  {
+   QString value;
+   for (++pos; pos < n && m_text.at(pos) != QLatin1Char('"'); ++pos)
+   {
+    QChar ch = m_text.at(pos);
+    if (ch == QLatin1Char('\\') && pos + 1 < n)
+    {
+     ch = m_text.at(++pos);
+     if (ch == QLatin1Char('n'))
+      ch = QLatin1Char('\n');
+     else if (ch == QLatin1Char('t'))
+      ch = QLatin1Char('\t');
+    }
+    value.append(ch);
+   }
+   m_tokens.append(Token(Value, value));
+   ++pos;
+  }
+  else if (c == QLatin1Char('`'))
+  {
+   int end = m_text.indexOf(QLatin1Char('`'), pos + 1);
+   if (end < 0)
+    end = n;
+   m_tokens.append(Token(Value, m_text.mid(pos + 1, end - pos - 1)));
+   pos = end + 1;
+  }
+  else if (c == QLatin1Char('{'))
+  {
+   m_tokens.append(Token(Open));
+   ++pos;
+  }
+  else if (c == QLatin1Char('}'))
+  {
+   m_tokens.append(Token(Close));
+   ++pos;
+  }
+  else if (c == QLatin1Char('='))
+  {
+   m_tokens.append(Token(Equals));
+   ++pos;
+  }
+  else
+  {
+   const int start = pos;
+   while (pos < n && !m_text.at(pos).isSpace()
+          && !QString::fromLatin1("{}=;\"`").contains(m_text.at(pos)))
+    ++pos;
+   const QString word = m_text.mid(start, pos - start);
+   if (word == QLatin1String("true") || word == QLatin1String("on"))
+    m_tokens.append(Token(Value, true));
+   else if (word == QLatin1String("false") || word == QLatin1String("off"))
+    m_tokens.append(Token(Value, false));
+   else if (word.at(0).isDigit())
+    m_tokens.append(Token(Value, word));
+   else
+    m_tokens.append(Token(Identifier, word));
+  }
+ }
+}
+
+void SdlReader::readTags(int &i, QVariantMap *out)
+{
+ const int n = m_tokens.size();
+ while (i < n)
+ {
+  const Token &token = m_tokens.at(i);
+  if (token.type == LineEnd)
+  {
+   ++i;
+   continue;
+  }
+  if (token.type == Close)
+  {
+   ++i;
+   return;
+  }
+  if (token.type != Identifier)
+  {
+   // anonymous tags are not part of a recipe
+   while (i < n && m_tokens.at(i).type != LineEnd)
+    ++i;
+   continue;
+  }
+
+  const QString name = token.value.toString();
+  QVariantList values;
+  QVariantMap attributes;
+  for (++i; i < n; )
+  {
+   const TokenType type = m_tokens.at(i).type;
+   if (type == LineEnd || type == Open || type == Close)
+    break;
+   if (type == Identifier && i + 2 < n && m_tokens.at(i + 1).type == Equals)
+   {
+    attributes.insert(m_tokens.at(i).value.toString(), m_tokens.at(i + 2).value);
+    i += 3;
+   }
+   else
+    values.append(m_tokens.at(i++).value);
+  }
+
+  QVariantMap children;
+  const bool hasChildren = i < n && m_tokens.at(i).type == Open;
+  if (hasChildren)
+   readTags(++i, &children);
+  apply(name, values, attributes, children, hasChildren, out);
+ }
+}
+
+void SdlReader::apply(const QString &name, const QVariantList &values,
+                      const QVariantMap &attributes, const QVariantMap &children,
+                      bool hasChildren, QVariantMap *out)
+{
+ if (name == QLatin1String("dependency"))
+ {
+  if (values.isEmpty())
+   return;
+  QVariantMap dependencies = out->value(QLatin1String("dependencies")).toMap();
+  dependencies.insert(values.first().toString(), attributes);
+  out->insert(QLatin1String("dependencies"), dependencies);
+ }
+ else if (name == QLatin1String("subPackage"))
+ {
+  QVariantList subPackages = out->value(QLatin1String("subPackages")).toList();
+  subPackages.append(hasChildren ? QVariant(children) : values.value(0));
+  out->insert(QLatin1String("subPackages"), subPackages);
+ }
+ else if (hasChildren)
+  return; // configuration, buildType, ...
+ else if (name == QLatin1String("sourcePaths") || name == QLatin1String("importPaths")
+          || name == QLatin1String("sourceFiles") || name == QLatin1String("excludedSourceFiles")
+          || name == QLatin1String("versions") || name == QLatin1String("libs"))
+ {
+  QString key = name;
+  const QString platform = attributes.value(QLatin1String("platform")).toString();
+  if (!platform.isEmpty())
+   key += QLatin1Char('-') + platform;
+  QVariantList list = out->value(key).toList();
+  list += values;
+  out->insert(key, list);
+ }
+ else if (values.size() == 1)
+  out->insert(name, values.first());
+ else if (!values.isEmpty())
+  out->insert(name, values);
+}
+
+bool loadRecipe(const QString &fileName, QVariantMap *recipe)
+{
+ QFile file(fileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return false;
+ const QByteArray text = file.readAll();
+ if (fileName.endsWith(QLatin1String(".sdl")))
+  *recipe = SdlReader(QString::fromUtf8(text)).read();
+ else
+ {
+  QJsonParseError error;
+  const QJsonDocument document = QJsonDocument::fromJson(text, &error);
+  if (error.error != QJsonParseError::NoError)
+   return false;
+  *recipe = document.toVariant().toMap();
+ }
+ return true;
+}
+
+QString recipeIn(const QString &directory)
+{
+ static const char *names[] = { "dub.json", "dub.sdl", "package.json" };
+ for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+ {
+  const QString fileName = directory + QLatin1Char('/') + QLatin1String(names[i]);
+  if (QFileInfo(fileName).isFile())
+   return fileName;
+ }
+ return QString();
+}
+
+/// The compiler name of platform specific keys like "dflags-ldc" for the @a command of a build.
+QString compilerSuffix(const QString &command)
+{
+ const QString compiler = QFileInfo(command).baseName().toLower();
+ if (compiler.startsWith(QLatin1String("ldc")) || compiler.startsWith(QLatin1String("ldmd")))
+  return QLatin1String("ldc");
+ if (compiler.startsWith(QLatin1String("gdc")) || compiler.startsWith(QLatin1String("gdmd")))
+  return QLatin1String("gdc");
+ return QLatin1String("dmd");
+}
+
+/// Suffixes of platform specific keys like "libs-posix" that apply to this host and @a compiler.
+QStringList platformSuffixes(const QString &compiler)
+{
+ QStringList suffixes;
+#if defined(Q_OS_WIN)
+ suffixes << QLatin1String("windows");
+#else
+ suffixes << QLatin1String("posix");
+#endif
+#if defined(Q_OS_LINUX)
+ suffixes << QLatin1String("linux");
+#elif defined(Q_OS_MAC)
+ suffixes << QLatin1String("osx");
+#elif defined(Q_OS_FREEBSD)
+ suffixes << QLatin1String("freebsd");
+#endif
+#if QT_POINTER_SIZE == 8
+ suffixes << QLatin1String("x86_64");
+#else
+ suffixes << QLatin1String("x86");
+#endif
+ suffixes << compilerSuffix(compiler);
+ return suffixes;
+}
+
+QStringList platformList(const QVariantMap &recipe, const QString &key, const QStringList &suffixes)
+{
+ QStringList values = recipe.value(key).toStringList();
+ const QString prefix = key + QLatin1Char('-');
+ for (QVariantMap::ConstIterator it = recipe.constBegin(); it != recipe.constEnd(); ++it)
+ {
+  if (!it.key().startsWith(prefix))
+   continue;
+  bool applies = true;
+  foreach (const QString &suffix, it.key().mid(prefix.size()).split(QLatin1Char('-')))
+   applies = applies && suffixes.contains(suffix);
+  if (applies)
+   values += it.value().toStringList();
+ }
+ return values;
+}
+
+QStringList absolutePaths(const QString &directory, const QStringList &paths)
+{
+ QStringList result;
+ foreach (const QString &path, paths)
+  result.append(QDir::cleanPath(QDir(directory).absoluteFilePath(path)));
+ return result;
+}
+
+/// The default source directory of a package: "source", or else "src".
+QStringList defaultSourcePaths(const QString &directory)
+{
+ if (QFileInfo(directory + QLatin1String("/source")).isDir())
+  return QStringList(QLatin1String("source"));
+ if (QFileInfo(directory + QLatin1String("/src")).isDir())
+  return QStringList(QLatin1String("src"));
+ return QStringList();
+}
+
+QStringList collectSources(const DDubPackage &package)
+{
+ QStringList files;
+ foreach (const QString &path, package.sourcePaths)
+ {
+  QDirIterator it(path, QStringList(QLatin1String("*.d")), QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext())
+   files.append(it.next());
+ }
+ files += package.listedSourceFiles;
+ if (!package.excludedSourceFiles.isEmpty())
+ {
+  QStringList kept;
+  foreach (const QString &file, files)
+   if (!QDir::match(package.excludedSourceFiles, file))
+    kept.append(file);
+  files = kept;
+ }
+ files.removeDuplicates();
+ files.sort();
+ return files;
+}
+
+//--------------------------------------------------------------------------------------
+// Versions
+//--------------------------------------------------------------------------------------
+
+struct Version
+{
+ Version() : valid(false), branch(false), parts(0) { number[0] = number[1] = number[2] = 0; }
+
+ bool valid;
+ bool branch;   ///< "~master"
+ int parts;     ///< given numbers, for "~>1.2"
+ int number[3];
+ QString preRelease;
+ QString text;
+};
+
+Version parseVersion(const QString &text, bool partial = false)
+{
+ Version v;
+ v.text = text;
+ if (text.startsWith(QLatin1Char('~')))
+ {
+  v.branch = true;
+  v.valid = text.size() > 1;
+  return v;
+ }
+ QString core = text.section(QLatin1Char('+'), 0, 0);
+ const int dash = core.indexOf(QLatin1Char('-'));
+ if (dash >= 0)
+ {
+  v.preRelease = core.mid(dash + 1);
+  core.truncate(dash);
+ }
+ const QStringList numbers = core.split(QLatin1Char('.'));
+ if (numbers.size() > 3 || (!partial && numbers.size() != 3))
+  return v;
+ for (int i = 0; i < numbers.size(); ++i)
+ {
+  bool ok;
+  v.number[i] = numbers.at(i).toInt(&ok);
+  if (!ok)
+   return v;
+ }
+ v.parts = numbers.size();
+ v.valid = true;
+ return v;
+}
+
+int compareVersions(const Version &a, const Version &b)
+{
+ for (int i = 0; i < 3; ++i)
+  if (a.number[i] != b.number[i])
+   return a.number[i] < b.number[i] ? -1 : 1;
+ if (a.preRelease == b.preRelease)
+  return 0;
+ // a release is newer than its pre-releases
+ if (a.preRelease.isEmpty())
+  return 1;
+ if (b.preRelease.isEmpty())
+  return -1;
+ return a.preRelease < b.preRelease ? -1 : 1;
+}
+
+bool satisfies(const Version &v, const QString &constraint)
+{
+ QString op;
+ int i = 0;
+ while (i < constraint.size() && QString::fromLatin1("<>=").contains(constraint.at(i)))
+  op.append(constraint.at(i++));
+ const Version bound = parseVersion(constraint.mid(i), true);
+ if (!bound.valid || bound.branch)
+  return false;
+ const int c = compareVersions(v, bound);
+ if (op == QLatin1String(">="))
+  return c >= 0;
+ if (op == QLatin1String(">"))
+  return c > 0;
+ if (op == QLatin1String("<="))
+  return c <= 0;
+ if (op == QLatin1String("<"))
+  return c < 0;
+ return c == 0;
+}
+
+/// Whether @a version meets a dub version specification like "~>1.2" or ">=1.0 <2.0".
+bool matches(const QString &version, const QString &spec)
+{
+ const Version v = parseVersion(version);
+ const QString s = spec.trimmed();
+ if (!v.valid)
+  return false;
+ if (s.isEmpty() || s == QLatin1String("*"))
+  return !v.branch;
+ if (v.branch || (s.startsWith(QLatin1Char('~')) && !s.startsWith(QLatin1String("~>"))))
+  return s == version || s == QLatin1String("==") + version;
+ if (s.startsWith(QLatin1String("~>")) || s.startsWith(QLatin1Char('^')))
+ {
+  const Version base = parseVersion(s.mid(s.startsWith(QLatin1Char('^')) ? 1 : 2).trimmed(), true);
+  if (!base.valid || base.branch || compareVersions(v, base) < 0)
+   return false;
+  Version upper = base;
+  upper.preRelease.clear();
+  if (s.startsWith(QLatin1Char('^')))
+  {
+   const int i = base.number[0] > 0 ? 0 : 1;
+   upper.number[i] += 1;
+   for (int j = i + 1; j < 3; ++j)
+    upper.number[j] = 0;
+  }
+  else
+  {
+   const int i = base.parts > 1 ? base.parts - 2 : 0;
+   upper.number[i] += 1;
+   for (int j = i + 1; j < 3; ++j)
+    upper.number[j] = 0;
+  }
+  return v.number[0] < upper.number[0]
+    || (v.number[0] == upper.number[0] && (v.number[1] < upper.number[1]
+    || (v.number[1] == upper.number[1] && v.number[2] < upper.number[2])));
+ }
+ foreach (const QString &constraint, s.split(QLatin1Char(' '), QString::SkipEmptyParts))
+  if (!satisfies(v, constraint))
+   return false;
+ return true;
+}
+
+//--------------------------------------------------------------------------------------
+// Cache
+//--------------------------------------------------------------------------------------
+
+QByteArray stampValue(const QString &path)
+{
+ const QFileInfo fi(path);
+ if (fi.isDir())
+  return "dir:" + QByteArray::number(fi.lastModified().toMSecsSinceEpoch());
+ QFile file(path);
+ if (!file.open(QIODevice::ReadOnly))
+  return "-";
+ return QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1).toHex();
+}
+
+QDataStream &operator<<(QDataStream &out, const DDubPackage &p)
+{
+ return out << p.name << p.version << p.directory << p.recipeFile << p.fromPackageCache
+            << p.sourcePaths << p.importPaths << p.listedSourceFiles << p.excludedSourceFiles
+            << p.sourceFiles << p.versions << p.libs << p.dependencies;
+}
+
+QDataStream &operator>>(QDataStream &in, DDubPackage &p)
+{
+ return in >> p.name >> p.version >> p.directory >> p.recipeFile >> p.fromPackageCache
+           >> p.sourcePaths >> p.importPaths >> p.listedSourceFiles >> p.excludedSourceFiles
+           >> p.sourceFiles >> p.versions >> p.libs >> p.dependencies;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------
+//
+// DDubResolution
+//
+//--------------------------------------------------------------------------------------
+
+QStringList DDubResolution::sourceFiles() const
+{
+ return packages.isEmpty() ? QStringList() : packages.first().sourceFiles;
+}
+
+QStringList DDubResolution::dependencySourceFiles() const
+{
+ QStringList files;
+ for (int i = 1; i < packages.size(); ++i)
+  files += packages.at(i).sourceFiles;
+ return files;
+}
+
+QStringList DDubResolution::importPaths() const
+{
+ QStringList paths;
+ foreach (const DDubPackage &package, packages)
+  paths += package.importPaths;
+ paths.removeDuplicates();
+ return paths;
+}
+
+QStringList DDubResolution::versions() const
+{
+ QStringList versions;
+ foreach (const DDubPackage &package, packages)
+  versions += package.versions;
+ versions.removeDuplicates();
+ return versions;
+}
+
+QStringList DDubResolution::libs() const
+{
+ QStringList libs;
+ foreach (const DDubPackage &package, packages)
+  libs += package.libs;
+ libs.removeDuplicates();
+ return libs;
+}
+
+/** Whether a build with @a other would get the same arguments, apart from the package's own files. */
+bool DDubResolution::sameBuild(const DDubResolution &other) const
+{
+ return importPaths() == other.importPaths() && versions() == other.versions()
+   && libs() == other.libs() && dependencySourceFiles() == other.dependencySourceFiles()
+   && error == other.error;
+}
+
+//--------------------------------------------------------------------------------------
+//
+// DDubResolver
+//
+//--------------------------------------------------------------------------------------
+
+DDubResolver::DDubResolver(const QString &packageFile, const QString &compiler)
+ : m_packageFile(QFileInfo(packageFile).absoluteFilePath()),
+   m_rootDirectory(QFileInfo(packageFile).absolutePath()),
+   m_compiler(compilerSuffix(compiler)),
+   m_platformSuffixes(platformSuffixes(compiler))
+{
+ const QString name = QString::fromLatin1(
+    QCryptographicHash::hash(m_packageFile.toUtf8(), QCryptographicHash::Sha1).toHex());
+ m_cacheFileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+   + QLatin1String("/dub/") + name + QLatin1String(".cache");
+ m_packageCaches = packageCacheDirectories(m_rootDirectory);
+}
+
+bool DDubResolver::isPackageFile(const QString &fileName)
+{
+ const QString name = QFileInfo(fileName).fileName();
+ return name == QLatin1String("dub.json") || name == QLatin1String("dub.sdl")
+   || name == QLatin1String("package.json");
+}
+
+/** Where dub keeps fetched packages, in the order dub searches them. */
+QStringList DDubResolver::packageCacheDirectories(const QString &rootDirectory)
+{
+ QStringList dirs;
+ dirs << rootDirectory + QLatin1String("/.dub/packages");
+ const QString dubHome = QString::fromLocal8Bit(qgetenv("DUB_HOME"));
+ if (!dubHome.isEmpty())
+  dirs << dubHome + QLatin1String("/packages");
+ const QString dpath = QString::fromLocal8Bit(qgetenv("DPATH"));
+ if (!dpath.isEmpty())
+  dirs << dpath + QLatin1String("/dub/packages");
+#if defined(Q_OS_WIN)
+ dirs << QString::fromLocal8Bit(qgetenv("LOCALAPPDATA")) + QLatin1String("/dub/packages")
+      << QString::fromLocal8Bit(qgetenv("APPDATA")) + QLatin1String("/dub/packages");
+#else
+ dirs << QDir::homePath() + QLatin1String("/.dub/packages")
+      << QLatin1String("/var/lib/dub/packages");
+#endif
+ return dirs;
+}
+
+void DDubResolver::addStamp(const QString &path)
+{
+ foreach (const Stamp &stamp, m_stamps)
+  if (stamp.path == path)
+   return;
+ Stamp stamp;
+ stamp.path = path;
+ stamp.value = stampValue(path);
+ m_stamps.append(stamp);
+}
+
+DDubResolution DDubResolver::resolve()
+{
+ DDubResolution resolution;
+ if (loadCache(&resolution))
+  return resolution;
+
+ m_stamps.clear();
+ addStamp(m_packageFile);
+ QVariantMap recipe;
+ if (!loadRecipe(m_packageFile, &recipe))
+ {
+  resolution.error = tr("Cannot read the dub package %1.").arg(m_packageFile);
+  return resolution;
+ }
+
+ const QString selectionsFile = m_rootDirectory + QLatin1String("/dub.selections.json");
+ addStamp(selectionsFile);
+ QVariantMap selections;
+ if (loadRecipe(selectionsFile, &selections))
+  m_selections = selections.value(QLatin1String("versions")).toMap();
+ // a fetch adds directories here
+ foreach (const QString &dir, m_packageCaches)
+  addStamp(dir);
+
+ DDubPackage root;
+ QVariantMap rootDependencies;
+ readPackage(m_rootDirectory, m_packageFile, recipe, &root, &rootDependencies);
+ resolution.packages.append(root);
+ resolution.watchedFiles << m_packageFile << selectionsFile;
+
+ // breadth first: a package is taken in the first version asked for
+ QHash<QString, int> index;
+ index.insert(root.name, 0);
+ QList<QVariantMap> pending;
+ pending.append(rootDependencies);
+ QStringList errors;
+ for (int owner = 0; owner < pending.size(); ++owner)
+ {
+  const QVariantMap dependencies = pending.at(owner);
+  for (QVariantMap::ConstIterator it = dependencies.constBegin(); it != dependencies.constEnd(); ++it)
+  {
+   QString name = it.key();
+   if (name.startsWith(QLatin1Char(':')))
+    name.prepend(resolution.packages.at(owner).name.section(QLatin1Char(':'), 0, 0));
+   resolution.packages[owner].dependencies.append(name);
+   if (index.contains(name))
+    continue;
+
+   const QVariantMap specMap = it.value().toMap();
+   const bool optional = specMap.value(QLatin1String("optional")).toBool();
+   const QString base = name.section(QLatin1Char(':'), 0, 0);
+   if (optional && !m_selections.contains(base))
+    continue;
+
+   // a sub-package of a package already resolved comes from the same directory
+   QVariant spec = it.value();
+   if (index.contains(base))
+   {
+    QVariantMap pathSpec;
+    pathSpec.insert(QLatin1String("path"), resolution.packages.at(index.value(base)).directory);
+    spec = pathSpec;
+   }
+
+   DDubPackage package;
+   QVariantMap packageDependencies;
+   QString error;
+   if (!locate(name, spec, resolution.packages.at(owner).directory,
+               &package, &packageDependencies, &error))
+   {
+    if (!optional)
+     errors.append(error);
+    continue;
+   }
+   if (!package.fromPackageCache && !package.recipeFile.isEmpty())
+    resolution.watchedFiles.append(package.recipeFile);
+   index.insert(name, resolution.packages.size());
+   resolution.packages.append(package);
+   pending.append(packageDependencies);
+  }
+ }
+ resolution.watchedFiles.removeDuplicates();
+ resolution.error = errors.join(QLatin1String("\n"));
+ saveCache(resolution);
+ return resolution;
+}
+
+bool DDubResolver::readPackage(const QString &directory, const QString &recipeFile,
+                               const QVariantMap &recipe, DDubPackage *package,
+                               QVariantMap *dependencies)
+{
+ package->name = recipe.value(QLatin1String("name")).toString();
+ package->directory = directory;
+ package->recipeFile = recipeFile;
+
+ QStringList sourcePaths = platformList(recipe, QLatin1String("sourcePaths"), m_platformSuffixes);
+ if (!recipe.contains(QLatin1String("sourcePaths")))
+  sourcePaths += defaultSourcePaths(directory);
+ QStringList importPaths = platformList(recipe, QLatin1String("importPaths"), m_platformSuffixes);
+ if (!recipe.contains(QLatin1String("importPaths")))
+  importPaths += defaultSourcePaths(directory);
+
+ package->sourcePaths = absolutePaths(directory, sourcePaths);
+ package->importPaths = absolutePaths(directory, importPaths);
+ package->listedSourceFiles = absolutePaths(directory,
+    platformList(recipe, QLatin1String("sourceFiles"), m_platformSuffixes));
+ package->excludedSourceFiles = absolutePaths(directory,
+    platformList(recipe, QLatin1String("excludedSourceFiles"), m_platformSuffixes));
+ package->versions = platformList(recipe, QLatin1String("versions"), m_platformSuffixes);
+ package->libs = platformList(recipe, QLatin1String("libs"), m_platformSuffixes);
+ package->sourceFiles = collectSources(*package);
+ *dependencies = recipe.value(QLatin1String("dependencies")).toMap();
+ return !package->name.isEmpty();
+}
+
+bool DDubResolver::locate(const QString &name, const QVariant &spec, const QString &fromDirectory,
+                          DDubPackage *package, QVariantMap *dependencies, QString *error)
+{
+ const QString base = name.section(QLatin1Char(':'), 0, 0);
+ const QString sub = name.section(QLatin1Char(':'), 1);
+ const QVariantMap specMap = spec.toMap();
+ QString path = specMap.value(QLatin1String("path")).toString();
+ QString versionSpec = spec.type() == QVariant::Map
+   ? specMap.value(QLatin1String("version")).toString() : spec.toString();
+
+ const QVariant selected = m_selections.value(base);
+ if (path.isEmpty() && selected.type() == QVariant::Map)
+ {
+  const QVariantMap selectedMap = selected.toMap();
+  path = selectedMap.value(QLatin1String("path")).toString();
+  if (!path.isEmpty())
+   path = QDir(m_rootDirectory).absoluteFilePath(path);
+  else
+   versionSpec = QLatin1String("==") + selectedMap.value(QLatin1String("version")).toString();
+ }
+ else if (path.isEmpty() && selected.isValid())
+  versionSpec = QLatin1String("==") + selected.toString();
+
+ QString directory;
+ QString version;
+ if (!path.isEmpty())
+  directory = QDir::cleanPath(QDir(fromDirectory).absoluteFilePath(path));
+ else if (!locateVersion(base, versionSpec, &directory, &version))
+ {
+  *error = tr("The dub package %1 %2 is not in the package cache; run \"dub fetch %1\".")
+    .arg(base, versionSpec.isEmpty() ? QLatin1String("*") : versionSpec);
+  return false;
+ }
+
+ const QString recipeFile = recipeIn(directory);
+ QVariantMap recipe;
+ if (recipeFile.isEmpty() || !loadRecipe(recipeFile, &recipe))
+ {
+  *error = tr("No dub package recipe in %1.").arg(directory);
+  return false;
+ }
+ addStamp(recipeFile);
+
+ const bool found = sub.isEmpty()
+   ? readPackage(directory, recipeFile, recipe, package, dependencies)
+   : subPackage(directory, recipe, sub, package, dependencies);
+ if (!found)
+ {
+  *error = tr("The dub package %1 was not found in %2.").arg(name, directory);
+  return false;
+ }
+ package->name = name;
+ package->version = version;
+ package->fromPackageCache = path.isEmpty();
+ return true;
+}
+
+bool DDubResolver::locateVersion(const QString &name, const QString &spec, QString *directory,
+                                 QString *version)
+{
+ QString best;
+ foreach (const QString &cache, m_packageCaches)
+ {
+  // <name>-<version>/<name> before dub 1.34, <name>/<version>/<name> since
+  QStringList versions;
+  QStringList directories;
+  const QStringList oldLayout = QDir(cache).entryList(QStringList(name + QLatin1String("-*")),
+                                                      QDir::Dirs | QDir::NoDotAndDotDot);
+  foreach (const QString &entry, oldLayout)
+  {
+   versions.append(entry.mid(name.size() + 1));
+   directories.append(cache + QLatin1Char('/') + entry + QLatin1Char('/') + name);
+  }
+  const QString newLayout = cache + QLatin1Char('/') + name;
+  if (QFileInfo(newLayout).isDir())
+  {
+   addStamp(newLayout);
+   foreach (const QString &entry, QDir(newLayout).entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+   {
+    versions.append(entry);
+    directories.append(newLayout + QLatin1Char('/') + entry + QLatin1Char('/') + name);
+   }
+  }
+
+  for (int i = 0; i < versions.size(); ++i)
+   if (matches(versions.at(i), spec) && QFileInfo(directories.at(i)).isDir()
+       && (best.isEmpty() || compareVersions(parseVersion(versions.at(i)), parseVersion(best)) > 0))
+   {
+    best = versions.at(i);
+    *directory = directories.at(i);
+   }
+ }
+ *version = best;
+ return !best.isEmpty();
+}
+
+bool DDubResolver::subPackage(const QString &parentDirectory, const QVariantMap &parentRecipe,
+                              const QString &subName, DDubPackage *package,
+                              QVariantMap *dependencies)
+{
+ foreach (const QVariant &entry, parentRecipe.value(QLatin1String("subPackages")).toList())
+ {
+  if (entry.type() == QVariant::Map)
+  {
+   const QVariantMap recipe = entry.toMap();
+   if (recipe.value(QLatin1String("name")).toString() == subName)
+    return readPackage(parentDirectory, QString(), recipe, package, dependencies);
+   continue;
+  }
+  const QString directory = QDir::cleanPath(QDir(parentDirectory).absoluteFilePath(entry.toString()));
+  const QString recipeFile = recipeIn(directory);
+  QVariantMap recipe;
+  if (recipeFile.isEmpty() || !loadRecipe(recipeFile, &recipe)
+      || recipe.value(QLatin1String("name")).toString() != subName)
+   continue;
+  addStamp(recipeFile);
+  return readPackage(directory, recipeFile, recipe, package, dependencies);
+ }
+ return false;
+}
+
+/** Fills @a resolution only if the whole cache is valid. */
+bool DDubResolver::loadCache(DDubResolution *resolution) const
+{
+ QFile file(m_cacheFileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return false;
+ QDataStream in(&file);
+ in.setVersion(QDataStream::Qt_5_0);
+ quint32 magic, version;
+ QString packageFile;
+ QString compiler;
+ in >> magic >> version >> packageFile >> compiler;
+ if (magic != CACHE_MAGIC || version != CACHE_VERSION || packageFile != m_packageFile
+     || compiler != m_compiler)
+  return false;
+
+ quint32 stampCount;
+ in >> stampCount;
+ for (quint32 i = 0; i < stampCount && in.status() == QDataStream::Ok; ++i)
+ {
+  QString path;
+  QByteArray value;
+  in >> path >> value;
+  if (stampValue(path) != value)
+   return false;
+ }
+
+ DDubResolution cached;
+ quint32 packageCount;
+ in >> packageCount;
+ for (quint32 i = 0; i < packageCount && in.status() == QDataStream::Ok; ++i)
+ {
+  DDubPackage package;
+  in >> package;
+  // packages that can be edited are listed again
+  if (!package.fromPackageCache)
+   package.sourceFiles = collectSources(package);
+  cached.packages.append(package);
+ }
+ in >> cached.watchedFiles >> cached.error;
+ if (in.status() != QDataStream::Ok || cached.packages.isEmpty())
+  return false;
+ *resolution = cached;
+ return true;
+}
+
+void DDubResolver::saveCache(const DDubResolution &resolution) const
+{
+ QDir().mkpath(QFileInfo(m_cacheFileName).absolutePath());
+ QSaveFile file(m_cacheFileName);
+ if (!file.open(QIODevice::WriteOnly))
+  return;
+ QDataStream out(&file);
+ out.setVersion(QDataStream::Qt_5_0);
+ out << CACHE_MAGIC << CACHE_VERSION << m_packageFile << m_compiler;
+ out << quint32(m_stamps.size());
+ foreach (const Stamp &stamp, m_stamps)
+  out << stamp.path << stamp.value;
+ out << quint32(resolution.packages.size());
+ foreach (const DDubPackage &package, resolution.packages)
+  out << package;
+ out << resolution.watchedFiles << resolution.error;
+ file.commit();
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,106 @@
+#ifndef DDUBPACKAGE_H
+#define DDUBPACKAGE_H
+
+#include <QCoreApplication>
+#include <QList>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace DProjectManager {
+namespace Internal {
+
+/** A dub package as it takes part in a build, with absolute paths. */
+struct DDubPackage
+{
+ DDubPackage() : fromPackageCache(false) {}
+
+ QString name;
+ QString version;          ///< empty for packages given by path
+ QString directory;
+ QString recipeFile;       ///< dub.json or dub.sdl, empty for inline sub-packages
+ bool fromPackageCache;    ///< fetched by dub, so never edited
+ QStringList sourcePaths;
+ QStringList importPaths;
+ QStringList listedSourceFiles;   ///< the recipe's sourceFiles
+ QStringList excludedSourceFiles; ///< patterns
+ QStringList sourceFiles;         ///< found in sourcePaths and listed
+ QStringList versions;
+ QStringList libs;
+ QStringList dependencies; ///< names
+};
+
+/** A package and its resolved dependencies; the package itself comes first. */
+struct DDubResolution
+{
+ QList<DDubPackage> packages;
+ QStringList watchedFiles; ///< recipes and selections the result depends on
+ QString error;
+
+ bool isEmpty() const { return packages.isEmpty(); }
+ QStringList sourceFiles() const;           ///< of the package itself
+ QStringList dependencySourceFiles() const;
+ QStringList importPaths() const;
+ QStringList versions() const;
+ QStringList libs() const;
+ bool sameBuild(const DDubResolution &other) const;
+};
+
+/**
+ * Reads a dub.json or dub.sdl and resolves its dependencies against the
+ * local package cache, preferring the versions in dub.selections.json like
+ * dub does. Nothing is fetched: missing packages are reported in the error.
+ * Platform specific keys like "libs-linux-ldc" are taken for this host and
+ * the compiler of the build.
+ * The resolution is cached and reused while the recipes, the selections and
+ * the package cache directories are unchanged; only the sources of packages
+ * outside the package cache are listed again.
+ */
+class DDubResolver
+{
+ Q_DECLARE_TR_FUNCTIONS(DProjectManager::Internal::DDubResolver)
+
+public:
+ /** @a compiler is the command of the build, dmd if empty. */
+ explicit DDubResolver(const QString &packageFile, const QString &compiler = QString());
+
+ DDubResolution resolve();
+
+ static bool isPackageFile(const QString &fileName);
+ static QStringList packageCacheDirectories(const QString &rootDirectory);
+
+private:
+ struct Stamp
+ {
+  QString path;
+  QByteArray value;
+ };
+
+ bool loadCache(DDubResolution *resolution) const;
+ void saveCache(const DDubResolution &resolution) const;
+ void addStamp(const QString &path);
+
+ bool readPackage(const QString &directory, const QString &recipeFile,
+                  const QVariantMap &recipe, DDubPackage *package,
+                  QVariantMap *dependencies);
+ bool locate(const QString &name, const QVariant &spec, const QString &fromDirectory,
+             DDubPackage *package, QVariantMap *dependencies, QString *error);
+ bool locateVersion(const QString &name, const QString &spec, QString *directory,
+                    QString *version);
+ bool subPackage(const QString &parentDirectory, const QVariantMap &parentRecipe,
+                 const QString &subName, DDubPackage *package,
+                 QVariantMap *dependencies);
+
+ QString m_packageFile;
+ QString m_rootDirectory;
+ QString m_cacheFileName;
+ QString m_compiler; ///< "dmd", "ldc" or "gdc", as dub names them
+ QStringList m_platformSuffixes;
+ QStringList m_packageCaches;
+ QVariantMap m_selections;
+ QList<Stamp> m_stamps;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DDUBPACKAGE_H
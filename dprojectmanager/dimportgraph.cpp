@@ -0,0 +1,416 @@
+#include "dimportgraph.h"
+
+#include "deditor/dsourcescanner.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+using namespace DEditor;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+bool isPunctuation(const DSourceScanner &scanner, const DSourceScanner::Token &tk, char ch)
+{
+ return tk.is(DSourceScanner::Punctuation) && scanner.punctuation(tk) == QLatin1Char(ch);
+}
+
+/// Reads a dotted module name starting at @a tk and leaves @a tk after it.
+QString readModuleName(DSourceScanner &scanner, DSourceScanner::Token &tk)
+{
+ if (!tk.is(DSourceScanner::Identifier))
+  return QString();
+ QString name = scanner.text(tk).toString();
+ tk = scanner.next();
+ while (isPunctuation(scanner, tk, '.'))
+ {
+  tk = scanner.next();
+  if (!tk.is(DSourceScanner::Identifier))
+   break;
+  name += QLatin1Char('.') + scanner.text(tk).toString();
+  tk = scanner.next();
+ }
+ return name;
+}
+
+struct ScanImportsFile
+{
+ typedef QPair<QString, DModuleImports> result_type;
+
+ result_type operator()(const QString &fileName) const
+ {
+  DModuleImports imports;
+  QFile file(fileName);
+  if (file.open(QIODevice::ReadOnly))
+  {
+   const QByteArray data = file.readAll();
+   imports = DImportGraph::scanImports(QString::fromUtf8(data.constData(), data.size()));
+  }
+  if (imports.module.isEmpty())
+  {
+   // without a declaration the module is named after the file
+   const QFileInfo fi(fileName);
+   imports.module = fi.completeBaseName() == QLatin1String("package")
+     ? fi.dir().dirName() : fi.completeBaseName();
+  }
+  imports.mtime = QFileInfo(fileName).lastModified().toMSecsSinceEpoch();
+  return result_type(fileName, imports);
+ }
+};
+
+bool isSourceFile(const QString &fileName)
+{
+ return fileName.endsWith(QLatin1String(".d")) || fileName.endsWith(QLatin1String(".di"));
+}
+
+struct Frame
+{
+ QString module;
+ QStringList dependencies; ///< project modules only
+ int next;
+};
+
+bool moreImported(const QPair<QString, int> &a, const QPair<QString, int> &b)
+{
+ return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+} // namespace
+
+DImportGraph::DImportGraph(QObject *parent)
+ : QObject(parent),
+   m_pending(false)
+{
+ connect(&m_scan, SIGNAL(finished()), this, SLOT(scanFinished()));
+}
+
+DImportGraph::~DImportGraph()
+{
+ m_scan.waitForFinished();
+}
+
+/**
+ * Extracts the module declaration and all imports, including scoped and
+ * static ones. Renamed imports give the real module, selective imports the
+ * module only; import expressions are skipped.
+ */
+DModuleImports DImportGraph::scanImports(const QString &text)
+{
+ DModuleImports result;
+ DSourceScanner scanner(text);
+ bool moduleSeen = false;
+
+ DSourceScanner::Token tk = scanner.next();
+ while (!tk.is(DSourceScanner::EndOfFile))
+ {
+  if (!tk.is(DSourceScanner::Identifier))
+  {
+   tk = scanner.next();
+   continue;
+  }
+  const QStringRef word = scanner.text(tk);
+  if (word == QLatin1String("module") && !moduleSeen && result.imports.isEmpty())
+  {
+   moduleSeen = true;
+   tk = scanner.next();
+   result.module = readModuleName(scanner, tk);
+   continue;
+  }
+  if (word != QLatin1String("import"))
+  {
+   tk = scanner.next();
+   continue;
+  }
+
+  tk = scanner.next();
+  if (isPunctuation(scanner, tk, '('))
+   continue;
+  forever
+  {
+   int line = tk.line;
+   QString name = readModuleName(scanner, tk);
+   if (name.isEmpty())
+    break;
+   if (isPunctuation(scanner, tk, '='))
+   {
+    tk = scanner.next();
+    line = tk.line;
+    name = readModuleName(scanner, tk);
+    if (name.isEmpty())
+     break;
+   }
+   result.imports.append(DImport(name, line));
+   if (isPunctuation(scanner, tk, ':'))
+   {
+    while (!tk.is(DSourceScanner::EndOfFile) && !isPunctuation(scanner, tk, ';'))
+     tk = scanner.next();
+    break;
+   }
+   if (!isPunctuation(scanner, tk, ','))
+    break;
+   tk = scanner.next();
+  }
+ }
+ return result;
+}
+
+DImportGraph::FileTable DImportGraph::scan(const FileTable &old, const QStringList &files)
+{
+ FileTable table;
+ QStringList changed;
+ foreach (const QString &file, files)
+ {
+  if (!isSourceFile(file) || table.contains(file))
+   continue;
+  const qint64 mtime = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+  FileTable::ConstIterator it = old.constFind(file);
+  if (it != old.constEnd() && it->mtime == mtime)
+   table.insert(file, *it);
+  else
+   changed.append(file);
+ }
+ const QList<ScanImportsFile::result_type> scanned =
+   QtConcurrent::blockingMapped(changed, ScanImportsFile());
+ for (int i = 0; i < scanned.size(); ++i)
+  table.insert(scanned.at(i).first, scanned.at(i).second);
+ return table;
+}
+
+void DImportGraph::update(const QStringList &files)
+{
+ if (m_scan.isRunning())
+ {
+  m_pending = true;
+  m_pendingFiles = files;
+  return;
+ }
+ m_scan.setFuture(QtConcurrent::run(&DImportGraph::scan, m_files, files));
+}
+
+void DImportGraph::scanFinished()
+{
+ const FileTable table = m_scan.result();
+
+ QStringList removed;
+ for (FileTable::ConstIterator it = m_files.constBegin(); it != m_files.constEnd(); ++it)
+  if (!table.contains(it.key()))
+   removed.append(it.key());
+ foreach (const QString &file, removed)
+  removeFile(file);
+ for (FileTable::ConstIterator it = table.constBegin(); it != table.constEnd(); ++it)
+ {
+  // a file saved during the scan is already newer here
+  FileTable::ConstIterator current = m_files.constFind(it.key());
+  if (current == m_files.constEnd() || current->mtime < it->mtime)
+   setFile(it.key(), it.value());
+ }
+ emit changed();
+
+ if (m_pending)
+ {
+  m_pending = false;
+  update(m_pendingFiles);
+  m_pendingFiles.clear();
+ }
+}
+
+void DImportGraph::updateFiles(const QStringList &files)
+{
+ bool updated = false;
+ foreach (const QString &file, files)
+  if (m_files.contains(file))
+  {
+   setFile(file, ScanImportsFile()(file).second);
+   updated = true;
+  }
+ if (updated)
+  emit changed();
+}
+
+void DImportGraph::setFile(const QString &fileName, const DModuleImports &imports)
+{
+ removeFile(fileName);
+ m_files.insert(fileName, imports);
+ m_moduleFiles.insert(imports.module, fileName);
+ foreach (const DImport &import, imports.imports)
+  m_importers[import.module].insert(imports.module);
+}
+
+void DImportGraph::removeFile(const QString &fileName)
+{
+ FileTable::Iterator it = m_files.find(fileName);
+ if (it == m_files.end())
+  return;
+ const DModuleImports old = it.value();
+ m_files.erase(it);
+ if (m_moduleFiles.value(old.module) == fileName)
+  m_moduleFiles.remove(old.module);
+ foreach (const DImport &import, old.imports)
+ {
+  QHash<QString, QSet<QString> >::Iterator importers = m_importers.find(import.module);
+  if (importers == m_importers.end())
+   continue;
+  importers->remove(old.module);
+  if (importers->isEmpty())
+   m_importers.erase(importers);
+ }
+}
+
+QString DImportGraph::moduleForFile(const QString &fileName) const
+{
+ return m_files.value(fileName).module;
+}
+
+QList<DImport> DImportGraph::imports(const QString &module) const
+{
+ return m_files.value(fileForModule(module)).imports;
+}
+
+QStringList DImportGraph::importers(const QString &module) const
+{
+ QStringList modules = m_importers.value(module).toList();
+ modules.sort();
+ return modules;
+}
+
+QStringList DImportGraph::affectedModules(const QStringList &modules) const
+{
+ QSet<QString> seen = modules.toSet();
+ QStringList queue = modules;
+ for (int i = 0; i < queue.size(); ++i)
+  foreach (const QString &importer, m_importers.value(queue.at(i)))
+   if (!seen.contains(importer))
+   {
+    seen.insert(importer);
+    queue.append(importer);
+   }
+ return queue;
+}
+
+QStringList DImportGraph::affectedFiles(const QStringList &files) const
+{
+ QStringList modules;
+ foreach (const QString &file, files)
+  if (m_files.contains(file))
+   modules.append(moduleForFile(file));
+ QStringList result;
+ foreach (const QString &module, affectedModules(modules))
+ {
+  const QString file = fileForModule(module);
+  if (!file.isEmpty())
+   result.append(file);
+ }
+ return result;
+}
+
+/**
+ * Strongly connected components of the project modules (Tarjan, without
+ * recursion so deep import chains cannot overflow the stack). A component
+ * is completed after everything it imports, which is the build order.
+ */
+QList<QStringList> DImportGraph::buildOrder() const
+{
+ QList<QStringList> groups;
+ QHash<QString, int> index;
+ QHash<QString, int> low;
+ QSet<QString> onStack;
+ QStringList stack;
+ int counter = 0;
+
+ QStringList modules = m_moduleFiles.keys();
+ modules.sort();
+ foreach (const QString &root, modules)
+ {
+  if (index.contains(root))
+   continue;
+  QList<Frame> calls;
+  QString visit = root;
+  while (!visit.isEmpty() || !calls.isEmpty())
+  {
+   if (!visit.isEmpty())
+   {
+    index.insert(visit, counter);
+    low.insert(visit, counter);
+    ++counter;
+    stack.append(visit);
+    onStack.insert(visit);
+    Frame frame;
+    frame.module = visit;
+    frame.next = 0;
+    foreach (const DImport &import, imports(visit))
+     if (m_moduleFiles.contains(import.module) && !frame.dependencies.contains(import.module))
+      frame.dependencies.append(import.module);
+    calls.append(frame);
+    visit.clear();
+   }
+
+   Frame &frame = calls.last();
+   if (frame.next < frame.dependencies.size())
+   {
+    const QString dependency = frame.dependencies.at(frame.next++);
+    if (!index.contains(dependency))
+     visit = dependency;
+    else if (onStack.contains(dependency))
+     low[frame.module] = qMin(low.value(frame.module), index.value(dependency));
+    continue;
+   }
+
+   const QString module = frame.module;
+   calls.removeLast();
+   if (low.value(module) == index.value(module))
+   {
+    QStringList group;
+    QString member;
+    do
+    {
+     member = stack.takeLast();
+     onStack.remove(member);
+     group.append(member);
+    } while (member != module);
+    group.sort();
+    groups.append(group);
+   }
+   if (!calls.isEmpty())
+   {
+    const QString parent = calls.last().module;
+    low[parent] = qMin(low.value(parent), low.value(module));
+   }
+  }
+ }
+ return groups;
+}
+
+QList<QStringList> DImportGraph::cycles() const
+{
+ QList<QStringList> result;
+ foreach (const QStringList &group, buildOrder())
+ {
+  bool cyclic = group.size() > 1;
+  if (!cyclic)
+   foreach (const DImport &import, imports(group.first()))
+    cyclic = cyclic || import.module == group.first();
+  if (cyclic)
+   result.append(group);
+ }
+ return result;
+}
+
+QList<QPair<QString, int> > DImportGraph::hotSpots(int limit) const
+{
+ QList<QPair<QString, int> > modules;
+ typedef QHash<QString, QSet<QString> >::ConstIterator ImportersKeyValue;
+ for (ImportersKeyValue kv = m_importers.constBegin(); kv != m_importers.constEnd(); ++kv)
+  if (m_moduleFiles.contains(kv.key()))
+   modules.append(qMakePair(kv.key(), kv.value().size()));
+ std::sort(modules.begin(), modules.end(), moreImported);
+ return modules.mid(0, limit);
+}
+
+} // namespace Internal
+} // namespace DProjectManager
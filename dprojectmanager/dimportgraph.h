@@ -0,0 +1,94 @@
+#ifndef DIMPORTGRAPH_H
+#define DIMPORTGRAPH_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+
+namespace DProjectManager {
+namespace Internal {
+
+struct DImport
+{
+ DImport() : line(0) {}
+ DImport(const QString &m, int l) : module(m), line(l) {}
+
+ QString module;
+ int line;
+};
+
+/** The module declaration and the imports of one source file. */
+struct DModuleImports
+{
+ DModuleImports() : mtime(0) {}
+
+ QString module;      ///< declared, or the file's base name
+ QList<DImport> imports;
+ qint64 mtime;
+};
+
+/**
+ * Which module imports which, over the files of a project. Files are
+ * scanned in parallel and only again when their modification time changed;
+ * a saved file is rescanned on its own. Nodes are module names; imports of
+ * modules that are not in the project are kept but have no file.
+ * All queries are made on the GUI thread.
+ */
+class DImportGraph : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DImportGraph(QObject *parent = 0);
+ ~DImportGraph();
+
+ static DModuleImports scanImports(const QString &text);
+
+ /// Rescans changed files in the background and drops the ones not in @a files.
+ void update(const QStringList &files);
+ /// Rescans the given project files now, e.g. after they were saved.
+ void updateFiles(const QStringList &files);
+
+ QString moduleForFile(const QString &fileName) const;
+ QString fileForModule(const QString &module) const { return m_moduleFiles.value(module); }
+ QList<DImport> imports(const QString &module) const;
+ QStringList importers(const QString &module) const;
+ int fanIn(const QString &module) const { return m_importers.value(module).size(); }
+
+ /// @a modules and every project module importing them, directly or not.
+ QStringList affectedModules(const QStringList &modules) const;
+ QStringList affectedFiles(const QStringList &files) const;
+ /// Groups of modules, dependencies first; a group of several modules is a cycle.
+ QList<QStringList> buildOrder() const;
+ QList<QStringList> cycles() const;
+ /// Project modules with the most importers.
+ QList<QPair<QString, int> > hotSpots(int limit) const;
+
+signals:
+ void changed();
+
+private slots:
+ void scanFinished();
+
+private:
+ typedef QHash<QString, DModuleImports> FileTable;
+
+ static FileTable scan(const FileTable &old, const QStringList &files);
+ void setFile(const QString &fileName, const DModuleImports &imports);
+ void removeFile(const QString &fileName);
+
+ FileTable m_files;
+ QHash<QString, QString> m_moduleFiles;        ///< project module -> file
+ QHash<QString, QSet<QString> > m_importers;   ///< module -> importing project modules
+ QFutureWatcher<FileTable> m_scan;
+ QStringList m_pendingFiles;
+ bool m_pending;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DIMPORTGRAPH_H
@@ -0,0 +1,110 @@
+#include "dimportgraphview.h"
+
+#include "dprojectmanagerconstants.h"
+#include "dproject.h"
+#include "dimportgraph.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <projectexplorer/session.h>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int FileNameRole = Qt::UserRole;
+const int HOT_SPOT_COUNT = 50;
+} // namespace
+
+DImportGraphView::DImportGraphView(QWidget *parent)
+ : QTreeWidget(parent)
+{
+ setHeaderHidden(true);
+ setUniformRowHeights(true);
+ connect(this, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(openModule(QTreeWidgetItem*)));
+ connect(SessionManager::instance(), SIGNAL(startupProjectChanged(ProjectExplorer::Project*)),
+         this, SLOT(setProject(ProjectExplorer::Project*)));
+ setProject(SessionManager::startupProject());
+}
+
+void DImportGraphView::setProject(Project *project)
+{
+ if (m_project)
+  disconnect(m_project->importGraph(), 0, this, 0);
+ m_project = qobject_cast<DProject *>(project);
+ if (m_project)
+  connect(m_project->importGraph(), SIGNAL(changed()), this, SLOT(refresh()));
+ refresh();
+}
+
+QTreeWidgetItem *DImportGraphView::moduleItem(const QString &module, const QString &text)
+{
+ QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(text));
+ item->setData(0, FileNameRole, m_project->importGraph()->fileForModule(module));
+ return item;
+}
+
+void DImportGraphView::refresh()
+{
+ clear();
+ if (!m_project)
+  return;
+ const DImportGraph *graph = m_project->importGraph();
+
+ const QList<QStringList> cycles = graph->cycles();
+ QTreeWidgetItem *cyclesItem = new QTreeWidgetItem(
+    QStringList(tr("Import Cycles (%1)").arg(cycles.size())));
+ foreach (const QStringList &cycle, cycles)
+ {
+  QTreeWidgetItem *cycleItem = new QTreeWidgetItem(QStringList(cycle.join(QLatin1String(", "))));
+  foreach (const QString &module, cycle)
+   cycleItem->addChild(moduleItem(module, module));
+  cyclesItem->addChild(cycleItem);
+ }
+ addTopLevelItem(cyclesItem);
+
+ QTreeWidgetItem *hotSpotsItem = new QTreeWidgetItem(QStringList(tr("Most Imported")));
+ typedef QPair<QString, int> ModuleFanIn;
+ foreach (const ModuleFanIn &hotSpot, graph->hotSpots(HOT_SPOT_COUNT))
+ {
+  QTreeWidgetItem *item = moduleItem(hotSpot.first,
+                                     tr("%1 (%2)").arg(hotSpot.first).arg(hotSpot.second));
+  foreach (const QString &importer, graph->importers(hotSpot.first))
+   item->addChild(moduleItem(importer, importer));
+  hotSpotsItem->addChild(item);
+ }
+ addTopLevelItem(hotSpotsItem);
+
+ cyclesItem->setExpanded(true);
+ hotSpotsItem->setExpanded(true);
+}
+
+void DImportGraphView::openModule(QTreeWidgetItem *item)
+{
+ const QString fileName = item->data(0, FileNameRole).toString();
+ if (!fileName.isEmpty())
+  Core::EditorManager::openEditor(fileName);
+}
+
+//--------------------------------------------------------------------------------------
+
+QString DImportGraphViewFactory::displayName() const
+{
+ return tr("D Imports");
+}
+
+Core::Id DImportGraphViewFactory::id() const
+{
+ return Core::Id(Constants::D_IMPORT_GRAPH_VIEW_ID);
+}
+
+Core::NavigationView DImportGraphViewFactory::createWidget()
+{
+ Core::NavigationView view;
+ view.widget = new DImportGraphView;
+ return view;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
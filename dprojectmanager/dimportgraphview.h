@@ -0,0 +1,52 @@
+#ifndef DIMPORTGRAPHVIEW_H
+#define DIMPORTGRAPHVIEW_H
+
+#include <coreplugin/inavigationwidgetfactory.h>
+
+#include <QPointer>
+#include <QTreeWidget>
+
+namespace ProjectExplorer { class Project; }
+
+namespace DProjectManager {
+namespace Internal {
+
+class DProject;
+
+/**
+ * Import cycles and the most imported modules of the startup D project.
+ * A module item opens its file.
+ */
+class DImportGraphView : public QTreeWidget
+{
+ Q_OBJECT
+
+public:
+ explicit DImportGraphView(QWidget *parent = 0);
+
+private slots:
+ void setProject(ProjectExplorer::Project *project);
+ void refresh();
+ void openModule(QTreeWidgetItem *item);
+
+private:
+ QTreeWidgetItem *moduleItem(const QString &module, const QString &text);
+
+ QPointer<DProject> m_project;
+};
+
+class DImportGraphViewFactory : public Core::INavigationWidgetFactory
+{
+ Q_OBJECT
+
+public:
+ QString displayName() const;
+ int priority() const { return 600; }
+ Core::Id id() const;
+ Core::NavigationView createWidget();
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DIMPORTGRAPHVIEW_H
@@ -0,0 +1,204 @@
+#include "dincrementalbuild.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QSaveFile>
+#include <QSet>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const quint32 STATE_MAGIC = 0x53424444; // "DDBS"
+const quint32 STATE_VERSION = 1;
+const char STATE_FILE_NAME[] = "/.dbuildstate";
+
+#if defined(Q_OS_WIN)
+const char OBJECT_SUFFIX[] = ".obj";
+#else
+const char OBJECT_SUFFIX[] = ".o";
+#endif
+} // namespace
+
+DIncrementalBuild::DIncrementalBuild(const QString &objectDirectory)
+ : m_objectDirectory(objectDirectory)
+{
+}
+
+bool DIncrementalBuild::load()
+{
+ m_entries.clear();
+ QFile file(m_objectDirectory + QLatin1String(STATE_FILE_NAME));
+ if (!file.open(QIODevice::ReadOnly))
+  return false;
+ QDataStream in(&file);
+ in.setVersion(QDataStream::Qt_5_0);
+ quint32 magic, version, count;
+ in >> magic >> version >> count;
+ if (magic != STATE_MAGIC || version != STATE_VERSION)
+  return false;
+ for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+ {
+  QString output;
+  Entry entry;
+  in >> output >> entry.commandHash >> entry.inputs;
+  m_entries.insert(output, entry);
+ }
+ if (in.status() != QDataStream::Ok)
+ {
+  m_entries.clear();
+  return false;
+ }
+ return true;
+}
+
+bool DIncrementalBuild::save() const
+{
+ QDir().mkpath(m_objectDirectory);
+ QSaveFile file(m_objectDirectory + QLatin1String(STATE_FILE_NAME));
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ QDataStream out(&file);
+ out.setVersion(QDataStream::Qt_5_0);
+ out << STATE_MAGIC << STATE_VERSION << quint32(m_entries.size());
+ for (QHash<QString, Entry>::ConstIterator it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+  out << it.key() << it.value().commandHash << it.value().inputs;
+ return file.commit();
+}
+
+/**
+ * The object of a source below @a sourceRoot mirrors its path; sources from
+ * elsewhere, like dub dependencies, go to a directory named after a hash of
+ * their own, so equal names cannot collide.
+ */
+DCompileJob DIncrementalBuild::compileJob(const QString &source, const QString &sourceRoot,
+                                          const QString &command, const QStringList &arguments) const
+{
+ const QFileInfo fi(source);
+ QString relative = QDir(sourceRoot).relativeFilePath(fi.absolutePath());
+ if (relative.startsWith(QLatin1String("..")) || QDir::isAbsolutePath(relative))
+  relative = QLatin1String("_ext/") + QString::fromLatin1(QCryptographicHash::hash(
+    fi.absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(12));
+ else if (relative == QLatin1String("."))
+  relative.clear();
+
+ DCompileJob job;
+ job.source = source;
+ job.object = QDir::cleanPath(m_objectDirectory + QLatin1Char('/') + relative + QLatin1Char('/')
+                              + fi.completeBaseName() + QLatin1String(OBJECT_SUFFIX));
+ job.depsFile = job.object + QLatin1String(".deps");
+ job.arguments = arguments;
+ job.arguments << source
+               << QLatin1String("-of") + job.object
+               << QLatin1String("-deps=") + job.depsFile;
+ job.commandHash = commandHash(command, arguments);
+ return job;
+}
+
+QByteArray DIncrementalBuild::commandHash(const QString &command, const QStringList &arguments)
+{
+ QCryptographicHash hash(QCryptographicHash::Sha1);
+ hash.addData(command.toUtf8());
+ foreach (const QString &argument, arguments)
+ {
+  hash.addData("\0", 1);
+  hash.addData(argument.toUtf8());
+ }
+ return hash.result();
+}
+
+qint64 DIncrementalBuild::modificationTime(const QString &fileName) const
+{
+ QHash<QString, qint64>::ConstIterator it = m_mtimes.constFind(fileName);
+ if (it != m_mtimes.constEnd())
+  return it.value();
+ const QFileInfo fi(fileName);
+ const qint64 mtime = fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+ m_mtimes.insert(fileName, mtime);
+ return mtime;
+}
+
+bool DIncrementalBuild::isUpToDate(const QString &output, const QByteArray &commandHash) const
+{
+ QHash<QString, Entry>::ConstIterator it = m_entries.constFind(output);
+ if (it == m_entries.constEnd() || it->commandHash != commandHash)
+  return false;
+ const qint64 outputTime = modificationTime(output);
+ if (outputTime < 0)
+  return false;
+ foreach (const QString &input, it->inputs)
+ {
+  const qint64 inputTime = modificationTime(input);
+  if (inputTime < 0 || inputTime > outputTime)
+   return false;
+ }
+ return true;
+}
+
+QStringList DIncrementalBuild::recordCompiled(const DCompileJob &job, const QString &workingDirectory)
+{
+ QStringList inputs = readDepsFile(job.depsFile, workingDirectory);
+ inputs.prepend(job.source);
+ inputs.removeDuplicates();
+ record(job.object, job.commandHash, inputs);
+ return inputs;
+}
+
+void DIncrementalBuild::record(const QString &output, const QByteArray &commandHash,
+                               const QStringList &inputs)
+{
+ Entry entry;
+ entry.commandHash = commandHash;
+ entry.inputs = inputs;
+ m_entries.insert(output, entry);
+ m_mtimes.remove(output);
+}
+
+void DIncrementalBuild::forget(const QString &output)
+{
+ m_entries.remove(output);
+ m_mtimes.remove(output);
+}
+
+/**
+ * The files named in a dmd -deps listing: every analysed module with its
+ * imports, and the files read by import expressions.
+ *   std.stdio (/usr/include/dmd/phobos/std/stdio.d) : private : core.stdc.stdio (...)
+ *   depsFile app (app.d) : data.txt (/abs/data.txt)
+ * Relative paths are relative to the directory the compiler ran in.
+ */
+QStringList DIncrementalBuild::readDepsFile(const QString &fileName, const QString &workingDirectory)
+{
+ const QDir base(workingDirectory);
+ QStringList files;
+ QFile file(fileName);
+ if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  return files;
+ QSet<QString> seen;
+ QRegExp path(QLatin1String("\\(([^)]+)\\)"));
+ while (!file.atEnd())
+ {
+  const QString line = QString::fromUtf8(file.readLine());
+  if (line.startsWith(QLatin1String("depsVersion")) || line.startsWith(QLatin1String("depsDebug"))
+      || line.startsWith(QLatin1String("depsLib")))
+   continue;
+  for (int pos = path.indexIn(line); pos >= 0; pos = path.indexIn(line, pos + path.matchedLength()))
+  {
+   const QString dependency = QDir::cleanPath(base.absoluteFilePath(path.cap(1)));
+   if (!seen.contains(dependency))
+   {
+    seen.insert(dependency);
+    files.append(dependency);
+   }
+  }
+ }
+ return files;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,66 @@
+#ifndef DINCREMENTALBUILD_H
+#define DINCREMENTALBUILD_H
+
+#include <QHash>
+#include <QStringList>
+
+namespace DProjectManager {
+namespace Internal {
+
+/** Compilation of one module into its own object file. */
+struct DCompileJob
+{
+ QString source;
+ QString object;
+ QString depsFile;      ///< written by dmd -deps
+ QStringList arguments;
+ QByteArray commandHash;
+};
+
+/**
+ * What the last builds in an object directory produced: for each output,
+ * the hash of the command that made it and the files it was made from,
+ * which for an object are its source and everything dmd -deps reported.
+ * An output is up to date when the command is the same and none of those
+ * files is newer, so flag changes and changes of imported modules both
+ * cause a rebuild. The state lives in a file in the object directory.
+ */
+class DIncrementalBuild
+{
+public:
+ explicit DIncrementalBuild(const QString &objectDirectory);
+
+ bool load();
+ bool save() const;
+
+ DCompileJob compileJob(const QString &source, const QString &sourceRoot,
+                        const QString &command, const QStringList &arguments) const;
+ static QByteArray commandHash(const QString &command, const QStringList &arguments);
+
+ bool isUpToDate(const QString &output, const QByteArray &commandHash) const;
+ /// Records a finished compilation with the dependencies from its -deps file
+ /// and returns the files it was built from.
+ QStringList recordCompiled(const DCompileJob &job, const QString &workingDirectory);
+ void record(const QString &output, const QByteArray &commandHash, const QStringList &inputs);
+ void forget(const QString &output);
+
+ static QStringList readDepsFile(const QString &fileName, const QString &workingDirectory);
+
+private:
+ struct Entry
+ {
+  QByteArray commandHash;
+  QStringList inputs;
+ };
+
+ qint64 modificationTime(const QString &fileName) const;
+
+ const QString m_objectDirectory;
+ QHash<QString, Entry> m_entries;
+ mutable QHash<QString, qint64> m_mtimes; ///< a build stats each file once
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DINCREMENTALBUILD_H
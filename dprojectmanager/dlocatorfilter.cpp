@@ -0,0 +1,81 @@
+#include "dlocatorfilter.h"
+#include "dprojectmanager.h"
+#include "dsymbolindex.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+
+#include <QMetaObject>
+#include <QDir>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int MAX_MATCHES = 500;
+}
+
+DSymbolLocatorFilter::DSymbolLocatorFilter(Manager *manager)
+ : m_manager(manager),
+   m_functionIcon(QLatin1String(":/deditor/images/func.png")),
+   m_classIcon(QLatin1String(":/deditor/images/class.png")),
+   m_enumIcon(QLatin1String(":/deditor/images/enum.png")),
+   m_templateIcon(QLatin1String(":/deditor/images/namespace.png")),
+   m_aliasIcon(QLatin1String(":/deditor/images/var.png"))
+{
+ setId("D Symbols");
+ setDisplayName(tr("D Symbols"));
+ setShortcutString(QString(QLatin1Char('d')));
+ setIncludedByDefault(false);
+}
+
+DSymbolLocatorFilter::~DSymbolLocatorFilter() { }
+
+QList<Locator::FilterEntry> DSymbolLocatorFilter::matchesFor(QFutureInterface<Locator::FilterEntry> &future,
+                                                             const QString &entry)
+{
+ QList<Locator::FilterEntry> entries;
+ const QString prefix = entry.trimmed();
+ if (prefix.isEmpty())
+  return entries;
+
+ // the copy keeps the indexes alive while a project is closed on the GUI thread
+ foreach (const QSharedPointer<DSymbolIndex> &index, m_manager->symbolIndexes())
+ {
+  if (future.isCanceled())
+   break;
+  foreach (const DSymbolLocation &loc, index->find(prefix, MAX_MATCHES - entries.size()))
+  {
+   QIcon icon;
+   switch (loc.kind)
+   {
+    case DSymbol::Function: icon = m_functionIcon; break;
+    case DSymbol::Enum: icon = m_enumIcon; break;
+    case DSymbol::Template: icon = m_templateIcon; break;
+    case DSymbol::Alias: icon = m_aliasIcon; break;
+    default: icon = m_classIcon;
+   }
+   Locator::FilterEntry fe(this, loc.name, QVariant::fromValue(loc), icon);
+   fe.extraInfo = QDir::toNativeSeparators(loc.fileName) + QLatin1Char(':') + QString::number(loc.line);
+   entries.append(fe);
+  }
+  if (entries.size() >= MAX_MATCHES)
+   break;
+ }
+ return entries;
+}
+
+void DSymbolLocatorFilter::accept(Locator::FilterEntry selection) const
+{
+ const DSymbolLocation loc = qvariant_cast<DSymbolLocation>(selection.internalData);
+ Core::EditorManager::openEditorAt(loc.fileName, loc.line);
+}
+
+void DSymbolLocatorFilter::refresh(QFutureInterface<void> &future)
+{
+ Q_UNUSED(future)
+ // The projects own the file lists and live on the GUI thread, so let it start the updates.
+ QMetaObject::invokeMethod(m_manager, "updateSymbolIndexes", Qt::QueuedConnection);
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,39 @@
+#ifndef DLOCATORFILTER_H
+#define DLOCATORFILTER_H
+
+#include <locator/ilocatorfilter.h>
+
+#include <QIcon>
+
+namespace DProjectManager {
+namespace Internal {
+
+class Manager;
+
+/// Locator filter "d <prefix>" over the symbol indexes of the open D projects.
+class DSymbolLocatorFilter : public Locator::ILocatorFilter
+{
+ Q_OBJECT
+
+public:
+ explicit DSymbolLocatorFilter(Manager *manager);
+ ~DSymbolLocatorFilter();
+
+ QList<Locator::FilterEntry> matchesFor(QFutureInterface<Locator::FilterEntry> &future,
+                                        const QString &entry);
+ void accept(Locator::FilterEntry selection) const;
+ void refresh(QFutureInterface<void> &future);
+
+private:
+ Manager *m_manager;
+ QIcon m_functionIcon;
+ QIcon m_classIcon;
+ QIcon m_enumIcon;
+ QIcon m_templateIcon;
+ QIcon m_aliasIcon;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DLOCATORFILTER_H
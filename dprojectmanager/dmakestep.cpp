@@ -4,13 +4,20 @@
 #include "ui_dmakestep.h"
 #include "dbuildconfiguration.h"
 #include "drunconfiguration.h"
+#include "dcompilescheduler.h"
+#include "ddemangler.h"
+#include "dobjectcache.h"
+#include "dbuildprofile.h"
+#include "dcompilerparser.h"
+#include "dimportgraph.h"
 
 #include <extensionsystem/pluginmanager.h>
 #include <projectexplorer/buildsteplist.h>
-#include <projectexplorer/gnumakeparser.h>
+#include <projectexplorer/environmentaspect.h>
 #include <projectexplorer/kitinformation.h>
 #include <projectexplorer/projectexplorer.h>
 #include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/target.h>
 #include <projectexplorer/toolchain.h>
 #include <qtsupport/qtkitinformation.h>
 #include <qtsupport/qtparser.h>
@@ -19,6 +26,10 @@
 #include <utils/qtcassert.h>
 #include <utils/qtcprocess.h>
 
+#include <QMap>
+#include <QProcess>
+#include <QtConcurrentRun>
+#include <QSaveFile>
 #include <QSettings>
 
 using namespace Core;
@@ -28,16 +39,49 @@ using namespace DProjectManager;
 namespace DProjectManager {
 namespace Internal {
 
+namespace {
+/// Longer source lists go through a response file, as Windows limits command lines to 32k.
+const int MAX_INLINE_SOURCES_LENGTH = 8000;
+const int CANCEL_CHECK_INTERVAL = 200;
+
+QString traceFile(const DCompileJob &job)
+{
+	return job.object + QLatin1String(".time-trace");
+}
+
+/// @a args without the flags that name or shape an output, for a check that writes none.
+QString withoutOutputArguments(const QString &args)
+{
+	QStringList kept;
+	foreach(const QString& arg, Utils::QtcProcess::splitArgs(args))
+		if(!arg.startsWith(QLatin1String("-of")) && !arg.startsWith(QLatin1String("-od"))
+					&& arg != QLatin1String("-c") && arg != QLatin1String("-lib")
+					&& arg != QLatin1String("-shared") && arg != QLatin1String("-run"))
+			kept.append(arg);
+	return Utils::QtcProcess::joinArgs(kept);
+}
+} // namespace
+
 DMakeStep::DMakeStep(BuildStepList *parent) :
 		AbstractProcessStep(parent, Id(Constants::D_MS_ID)),
-		m_targetType(Executable), m_buildPreset(Debug)
+		m_targetType(Executable), m_buildPreset(Debug), m_incremental(false),
+		m_parallelJobs(0), m_stopOnError(true), m_build(0), m_objectCache(0), m_demangler(0),
+		m_futureInterface(0), m_scheduler(0), m_objectsChanged(false), m_compileCount(0),
+		m_stage(NoStage), m_stageProcess(0),
+		m_useObjectCache(true), m_profileBuild(false), m_buildProfile(0),
+		m_pgoInstrumenting(false), m_sourcesValid(false)
 {
 	ctor();
 }
 
 DMakeStep::DMakeStep(BuildStepList *parent, const Id id) :
 		AbstractProcessStep(parent, id),
-		m_targetType(Executable), m_buildPreset(Debug)
+		m_targetType(Executable), m_buildPreset(Debug), m_incremental(false),
+		m_parallelJobs(0), m_stopOnError(true), m_build(0), m_objectCache(0), m_demangler(0),
+		m_futureInterface(0), m_scheduler(0), m_objectsChanged(false), m_compileCount(0),
+		m_stage(NoStage), m_stageProcess(0),
+		m_useObjectCache(true), m_profileBuild(false), m_buildProfile(0),
+		m_pgoInstrumenting(false), m_sourcesValid(false)
 {
 	ctor();
 }
@@ -49,7 +93,24 @@ DMakeStep::DMakeStep(BuildStepList *parent, DMakeStep *bs) :
 		m_makeArguments(bs->m_makeArguments),
 		m_targetName(bs->m_targetName),
 		m_targetDirName(bs->m_targetDirName),
-		m_objDirName(bs->m_objDirName)
+		m_objDirName(bs->m_objDirName),
+		m_incremental(bs->m_incremental),
+		m_parallelJobs(bs->m_parallelJobs),
+		m_stopOnError(bs->m_stopOnError),
+		m_build(0),
+		m_objectCache(0),
+		m_demangler(0),
+		m_futureInterface(0),
+		m_scheduler(0),
+		m_objectsChanged(false),
+		m_compileCount(0),
+		m_stage(NoStage),
+		m_stageProcess(0),
+		m_useObjectCache(bs->m_useObjectCache),
+		m_profileBuild(bs->m_profileBuild),
+		m_buildProfile(0),
+		m_pgoInstrumenting(false),
+		m_sourcesValid(false)
 {
 	ctor();
 }
@@ -75,9 +136,29 @@ void DMakeStep::ctor()
 		if(abi.wordWidth() == 64)
 			m_makeArguments = QLatin1String("-m64");
 	}
+
+	m_cancelTimer.setInterval(CANCEL_CHECK_INTERVAL);
+	connect(&m_cancelTimer, SIGNAL(timeout()), this, SLOT(checkForCancel()));
+	connect(&m_identityWatcher, SIGNAL(finished()), this, SLOT(compilerIdentityReady()));
+	connect(project(), SIGNAL(fileListChanged()), this, SLOT(invalidateSources()));
+	connect(project(), SIGNAL(configurationChanged(int)), this, SLOT(invalidateSources()));
 }
 
-DMakeStep::~DMakeStep() { }
+DMakeStep::~DMakeStep()
+{
+	// the processes of a build that is still running go with it
+	if(m_stageProcess)
+	{
+		m_stageProcess->disconnect(this);
+		m_stageProcess->kill();
+		m_stageProcess->waitForFinished();
+	}
+	delete m_scheduler;
+	delete m_buildProfile;
+	delete m_objectCache;
+	delete m_build;
+	delete m_demangler;
+}
 
 bool DMakeStep::init()
 {
@@ -106,12 +187,63 @@ bool DMakeStep::init()
 	pp->setArguments(allArguments());
 	pp->resolveAll();
 
-	setOutputParser(new GnuMakeParser());
+	if(!isIncremental() && sourcesInResponseFile())
+	{
+		QDir().mkpath(objectDirectory());
+		if(!writeResponseFile(sourcesResponseFile(), sourceFiles()))
+			m_tasks.append(Task(Task::Error, tr("Could not write %1.")
+																							.arg(QDir::toNativeSeparators(sourcesResponseFile())),
+																							Utils::FileName(), -1,
+																							Core::Id(ProjectExplorer::Constants::TASK_CATEGORY_BUILDSYSTEM)));
+	}
+
+	setOutputParser(new DCompilerParser());
 	IOutputParser *parser = target()->kit()->createOutputParser();
 	if (parser)
 		appendOutputParser(parser);
 	outputParser()->setWorkingDirectory(pp->effectiveWorkingDirectory());
 
+	if(m_buildPreset == ReleaseLto || m_buildPreset == ReleasePgo)
+	{
+		const QString compiler = QFileInfo(pp->effectiveCommand()).baseName().toLower();
+		if(!compiler.startsWith(QLatin1String("ldc")) && !compiler.startsWith(QLatin1String("ldmd")))
+			m_tasks.append(Task(Task::Error, tr("Link-time and profile-guided optimization need LDC; "
+																																			"%1 is no LDC compiler.").arg(pp->effectiveCommand()),
+																							Utils::FileName(), -1,
+																							Core::Id(ProjectExplorer::Constants::TASK_CATEGORY_BUILDSYSTEM)));
+	}
+	if(m_buildPreset == ReleasePgo && !initPgo(pp->effectiveCommand()))
+		return true; // otherwise the tasks will not get reported
+
+	m_compileJobs.clear();
+	if (isIncremental())
+	{
+		m_objectDirectory = objectDirectory();
+		const QString command = pp->effectiveCommand();
+		const QStringList compileArgs = expandedArguments(compileArguments());
+		const DIncrementalBuild build(m_objectDirectory);
+		DProject* proj = static_cast<DProject*>(project());
+		QStringList sources = proj->files().files();
+		sources << proj->dubPackage().dependencySourceFiles();
+		sources.removeDuplicates();
+		// modules in dependency order, so the imported ones get compiled first
+		const DImportGraph *graph = proj->importGraph();
+		QHash<QString, int> rank;
+		foreach(const QStringList& group, graph->buildOrder())
+			foreach(const QString& module, group)
+				rank.insert(graph->fileForModule(module), rank.size());
+		QMap<int, QStringList> ordered;
+		foreach(const QString& file, sources)
+			if(file.endsWith(QLatin1String(".d")))
+				ordered[rank.value(file, rank.size())].append(file);
+		foreach(const QStringList& files, ordered)
+			foreach(const QString& file, files)
+				m_compileJobs.append(build.compileJob(file, proj->files().root(), command, compileArgs));
+		m_linkArguments = expandedArguments(linkArguments());
+		m_targetFile = QDir(pp->effectiveWorkingDirectory()).absoluteFilePath(
+					relativeTargetDir() + QLatin1Char('/') + outFileName());
+	}
+
 	return AbstractProcessStep::init();
 }
 
@@ -124,6 +256,11 @@ QVariantMap DMakeStep::toMap() const
 	map.insert(QLatin1String(Constants::INI_TARGET_DIRNAME_KEY), m_targetDirName);
 	map.insert(QLatin1String(Constants::INI_OBJ_DIRNAME_KEY), m_objDirName);
 	map.insert(QLatin1String(Constants::INI_MAKE_ARGUMENTS_KEY), m_makeArguments);
+	map.insert(QLatin1String(Constants::INI_INCREMENTAL_KEY), m_incremental);
+	map.insert(QLatin1String(Constants::INI_PARALLEL_JOBS_KEY), m_parallelJobs);
+	map.insert(QLatin1String(Constants::INI_STOP_ON_ERROR_KEY), m_stopOnError);
+	map.insert(QLatin1String(Constants::INI_OBJECT_CACHE_KEY), m_useObjectCache);
+	map.insert(QLatin1String(Constants::INI_PROFILE_BUILD_KEY), m_profileBuild);
 	return map;
 }
 
@@ -135,6 +272,11 @@ bool DMakeStep::fromMap(const QVariantMap &map)
 	m_targetDirName = map.value(QLatin1String(Constants::INI_TARGET_DIRNAME_KEY)).toString();
 	m_objDirName = map.value(QLatin1String(Constants::INI_OBJ_DIRNAME_KEY)).toString();
 	m_makeArguments = map.value(QLatin1String(Constants::INI_MAKE_ARGUMENTS_KEY)).toString();
+	m_incremental = map.value(QLatin1String(Constants::INI_INCREMENTAL_KEY), false).toBool();
+	m_parallelJobs = map.value(QLatin1String(Constants::INI_PARALLEL_JOBS_KEY), 0).toInt();
+	m_stopOnError = map.value(QLatin1String(Constants::INI_STOP_ON_ERROR_KEY), true).toBool();
+	m_useObjectCache = map.value(QLatin1String(Constants::INI_OBJECT_CACHE_KEY), true).toBool();
+	m_profileBuild = map.value(QLatin1String(Constants::INI_PROFILE_BUILD_KEY), false).toBool();
 	return BuildStep::fromMap(map);
 }
 
@@ -147,10 +289,8 @@ QString DMakeStep::makeCommand(const Utils::Environment &environment) const
 		return QLatin1String("dmd");
 }
 
-QString DMakeStep::allArguments() const
+QString DMakeStep::presetArguments() const
 {
-	QString bname = this->buildConfiguration()->displayName().toLower();
-
 	QString args;
 
 	if(m_buildPreset == Debug)
@@ -159,12 +299,20 @@ QString DMakeStep::allArguments() const
 		args += QLatin1String("-debug -gc -unittest");
 	else if(m_buildPreset == Release)
 		args += QLatin1String(" -release -O -inline");
+	else if(m_buildPreset == ReleaseLto)
+		args += QLatin1String("-release -O3 -flto=thin");
+	else if(m_buildPreset == ReleasePgo && m_pgoInstrumenting)
+		Utils::QtcProcess::addArgs(&args, QLatin1String("-release -O3 -fprofile-instr-generate=")
+																													+ pgoDirectory() + QLatin1String("/raw/%p.profraw"));
+	else if(m_buildPreset == ReleasePgo)
+		Utils::QtcProcess::addArgs(&args, QLatin1String("-release -O3 -flto=thin -fprofile-instr-use=")
+																													+ pgoDirectory() + QLatin1String("/merged.profdata"));
 
-	if(m_targetType == StaticLibrary)
-		args += QLatin1String(" -lib");
-	else if(m_targetType == SharedLibrary)
-		args += QLatin1String(" -shared -fPIC");
+	return args;
+}
 
+QString DMakeStep::relativeTargetDir() const
+{
 	QDir buildDir(this->buildConfiguration()->buildDirectory().toString());
 	QString projDir = project()->projectDirectory();
 	QString relTargetDir = m_targetDirName;
@@ -172,6 +320,66 @@ QString DMakeStep::allArguments() const
 		relTargetDir = buildDir.relativeFilePath(projDir + QDir::separator() + m_targetDirName);
 	if(relTargetDir.length() == 0)
 		relTargetDir = QLatin1String(".");
+	return relTargetDir;
+}
+
+QString DMakeStep::includeArguments(const QString &relTargetDir) const
+{
+	QString args;
+	DProject* proj = static_cast<DProject*>(project());
+	QStringList incs = proj->includes().split(QLatin1Char(' '), QString::SkipEmptyParts);
+	foreach(QString s, incs)
+	{
+		s = s.replace(QLatin1String("%{TargetDir}"),relTargetDir);
+		if(s.startsWith(QLatin1String("-I")))
+			Utils::QtcProcess::addArgs(&args, s);
+		else
+			Utils::QtcProcess::addArgs(&args, QLatin1String("-I") + s);
+	}
+	return args;
+}
+
+QString DMakeStep::dubArguments() const
+{
+	QString args;
+	const DDubResolution& dub = static_cast<DProject*>(project())->dubPackage();
+	foreach(const QString& dir, dub.importPaths())
+		Utils::QtcProcess::addArg(&args, QLatin1String("-I") + dir);
+	foreach(const QString& version, dub.versions())
+		Utils::QtcProcess::addArg(&args, QLatin1String("-version=") + version);
+	return args;
+}
+
+QString DMakeStep::libraryArguments(const QString &relTargetDir) const
+{
+	QString args;
+	DProject* proj = static_cast<DProject*>(project());
+	QStringList libs = proj->libraries().split(QLatin1Char(' '), QString::SkipEmptyParts);
+	foreach(QString s, libs)
+	{
+		s = s.replace(QLatin1String("%{TargetDir}"),relTargetDir);
+		if(s.startsWith(QLatin1String("-L")))
+			Utils::QtcProcess::addArgs(&args, s);
+		else
+			Utils::QtcProcess::addArgs(&args, QLatin1String("-L-l") + s);
+	}
+	foreach(const QString& lib, proj->dubPackage().libs())
+		Utils::QtcProcess::addArg(&args, QLatin1String("-L-l") + lib);
+	return args;
+}
+
+QString DMakeStep::allArguments() const
+{
+	QString args = presetArguments();
+
+	if(m_targetType == StaticLibrary)
+		args += QLatin1String(" -lib");
+	else if(m_targetType == SharedLibrary)
+		args += QLatin1String(" -shared -fPIC");
+
+	QDir buildDir(this->buildConfiguration()->buildDirectory().toString());
+	QString projDir = project()->projectDirectory();
+	QString relTargetDir = relativeTargetDir();
 
 	QString outFile = outFileName();
 	QString makargs = m_makeArguments;
@@ -188,41 +396,219 @@ QString DMakeStep::allArguments() const
 
 	DProject* proj = static_cast<DProject*>(project());
 	// Libs
-	QStringList libs = proj->libraries().split(QLatin1Char(' '), QString::SkipEmptyParts);
-		foreach(QString s, libs)
-	{
-		s = s.replace(QLatin1String("%{TargetDir}"),relTargetDir);
-		if(s.startsWith(QLatin1String("-L")))
-			Utils::QtcProcess::addArgs(&args, s);
-		else
-			Utils::QtcProcess::addArgs(&args, QLatin1String("-L-l") + s);
-	}
+	Utils::QtcProcess::addArgs(&args, libraryArguments(relTargetDir));
 	// Includes
-	QStringList incs = proj->includes().split(QLatin1Char(' '), QString::SkipEmptyParts);
-	foreach(QString s, incs)
-	{
-		s = s.replace(QLatin1String("%{TargetDir}"),relTargetDir);
-		if(s.startsWith(QLatin1String("-I")))
-			Utils::QtcProcess::addArgs(&args, s);
-		else
-			Utils::QtcProcess::addArgs(&args, QLatin1String("-I") + s);
-	}
+	Utils::QtcProcess::addArgs(&args, includeArguments(relTargetDir));
+	Utils::QtcProcess::addArgs(&args, dubArguments());
 	// Extra Args
 	makargs = proj->extraArgs();
 	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
 	// Files
-	static QLatin1String dotd(".d");
-	static QLatin1String dotdi(".di");
-	static QLatin1String space(" ");
-	QString srcs = QLatin1String(" ");
-	const QHash<QString,QString>& files = static_cast<DProject*>(project())->files();
-	foreach(QString file, files.values())
-		if(file.endsWith(dotd) || file.endsWith(dotdi))
-			srcs.append(file).append(space);
-	Utils::QtcProcess::addArgs(&args, srcs);
+	if(sourcesInResponseFile())
+		Utils::QtcProcess::addArg(&args, QLatin1Char('@') + sourcesResponseFile());
+	else
+		Utils::QtcProcess::addArgs(&args, sourceArguments());
 	return args;
 }
 
+/**
+ * The sources of a full build, including those of the dub dependencies.
+ * Listing them is costly for large projects, so the list is kept until the
+ * files or the configuration of the project change.
+ */
+const QStringList& DMakeStep::sourceFiles() const
+{
+	if(!m_sourcesValid)
+	{
+		static QLatin1String dotd(".d");
+		static QLatin1String dotdi(".di");
+		DProject* proj = static_cast<DProject*>(project());
+		const DPathTable& files = proj->files();
+		m_sourceFiles.clear();
+		foreach(const QString& file, files.files())
+			if(file.endsWith(dotd) || file.endsWith(dotdi))
+				m_sourceFiles.append(files.relativePath(file));
+		// dub dependencies are built together with the project
+		m_sourceFiles << proj->dubPackage().dependencySourceFiles();
+		m_sourceArguments = Utils::QtcProcess::joinArgs(m_sourceFiles);
+		m_sourcesValid = true;
+	}
+	return m_sourceFiles;
+}
+
+const QString& DMakeStep::sourceArguments() const
+{
+	sourceFiles();
+	return m_sourceArguments;
+}
+
+bool DMakeStep::sourcesInResponseFile() const
+{
+	return sourceArguments().size() > MAX_INLINE_SOURCES_LENGTH;
+}
+
+QString DMakeStep::sourcesResponseFile() const
+{
+	return objectDirectory() + QLatin1String("/sources.rsp");
+}
+
+void DMakeStep::invalidateSources()
+{
+	m_sourcesValid = false;
+	m_sourceFiles.clear();
+	m_sourceArguments.clear();
+}
+
+bool DMakeStep::writeResponseFile(const QString &fileName, const QStringList &arguments)
+{
+	QSaveFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly))
+		return false;
+	foreach(const QString& argument, arguments)
+		file.write("\"" + QDir::toNativeSeparators(argument).toLocal8Bit() + "\"\n");
+	return file.commit();
+}
+
+QString DMakeStep::checkArguments() const
+{
+	// Semantic analysis only: no object file and no linking.
+	QString args = QLatin1String("-o- -c ");
+	// the profile of a PGO build may not exist yet, and optimizing is no use here
+	if(m_buildPreset == ReleaseLto || m_buildPreset == ReleasePgo)
+		args += QLatin1String("-release");
+	else
+		args += presetArguments();
+	// the user's flags as compileArguments() passes them: versions, debug levels, -J, ...
+	const QString relTargetDir = relativeTargetDir();
+	QString makargs = m_makeArguments;
+	Utils::QtcProcess::addArgs(&args, withoutOutputArguments(makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir)));
+	Utils::QtcProcess::addArgs(&args, includeArguments(relTargetDir));
+	Utils::QtcProcess::addArgs(&args, dubArguments());
+	makargs = static_cast<DProject*>(project())->extraArgs();
+	Utils::QtcProcess::addArgs(&args, withoutOutputArguments(makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir)));
+	return args;
+}
+
+QString DMakeStep::compileArguments() const
+{
+	QString args = presetArguments();
+	if(m_targetType == SharedLibrary)
+		args += QLatin1String(" -fPIC");
+
+	const QString relTargetDir = relativeTargetDir();
+	QString makargs = m_makeArguments;
+	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
+	Utils::QtcProcess::addArgs(&args, includeArguments(relTargetDir));
+	Utils::QtcProcess::addArgs(&args, dubArguments());
+	makargs = static_cast<DProject*>(project())->extraArgs();
+	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
+	Utils::QtcProcess::addArg(&args, QLatin1String("-c"));
+	return args;
+}
+
+QString DMakeStep::linkArguments() const
+{
+	QString args;
+	if(m_targetType == StaticLibrary)
+		args += QLatin1String("-lib");
+	else if(m_targetType == SharedLibrary)
+		args += QLatin1String("-shared");
+	if(m_buildPreset == ReleaseLto)
+		args += QLatin1String(" -flto=thin");
+
+	const QString relTargetDir = relativeTargetDir();
+	QString makargs = m_makeArguments;
+	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
+	Utils::QtcProcess::addArgs(&args, QLatin1String("-of") + relTargetDir + QDir::separator() + outFileName());
+	Utils::QtcProcess::addArgs(&args, libraryArguments(relTargetDir));
+	return args;
+}
+
+QString DMakeStep::unittestArguments() const
+{
+	QString args = QLatin1String("-unittest -debug -gc");
+	// libraries have no main of their own
+	if(m_targetType != Executable)
+		args += QLatin1String(" -main");
+
+	const QString relTargetDir = relativeTargetDir();
+	QString makargs = m_makeArguments;
+	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
+	Utils::QtcProcess::addArgs(&args, libraryArguments(relTargetDir));
+	Utils::QtcProcess::addArgs(&args, includeArguments(relTargetDir));
+	Utils::QtcProcess::addArgs(&args, dubArguments());
+	makargs = static_cast<DProject*>(project())->extraArgs();
+	Utils::QtcProcess::addArgs(&args, makargs.replace(QLatin1String("%{TargetDir}"),relTargetDir));
+	return args;
+}
+
+QString DMakeStep::unittestDirectory() const
+{
+	return objectDirectory() + QLatin1String("/unittest");
+}
+
+QString DMakeStep::objectDirectory() const
+{
+	if(QDir(m_objDirName).isRelative())
+		return QDir::cleanPath(project()->projectDirectory() + QLatin1Char('/') + m_objDirName);
+	return QDir::cleanPath(m_objDirName);
+}
+
+QString DMakeStep::pgoDirectory() const
+{
+	return objectDirectory() + QLatin1String("/pgo");
+}
+
+/**
+ * Prepares in init() what the stages of a profile-guided build take from the
+ * project and the kit, as they may change while the build runs: the
+ * instrumented command line, the profile merger that comes with ldc and the
+ * training run, which is the active run configuration.
+ */
+bool DMakeStep::initPgo(const QString &command)
+{
+	m_pgoInstrumenting = true;
+	m_pgoInstrumentArguments = expandedArguments(allArguments());
+	m_pgoInstrumenting = false;
+
+	// preferably the one of the same ldc installation
+	m_profdataCommand = processParameters()->environment().searchInPath(QLatin1String("ldc-profdata"),
+																																																						QStringList(QFileInfo(command).absolutePath()));
+	if(m_profdataCommand.isEmpty())
+		m_tasks.append(Task(Task::Error, tr("Could not find ldc-profdata to merge the profiles "
+																																		"of the training run."),
+																						Utils::FileName(), -1,
+																						Core::Id(ProjectExplorer::Constants::TASK_CATEGORY_BUILDSYSTEM)));
+
+	DRunConfiguration *rc = qobject_cast<DRunConfiguration *>(target()->activeRunConfiguration());
+	if(!rc)
+	{
+		m_tasks.append(Task(Task::Error, tr("Profile-guided optimization trains with the active run "
+																																		"configuration, which must be a D application."),
+																						Utils::FileName(), -1,
+																						Core::Id(ProjectExplorer::Constants::TASK_CATEGORY_BUILDSYSTEM)));
+		return false;
+	}
+	m_trainingExecutable = rc->executable();
+	m_trainingArguments = Utils::QtcProcess::splitArgs(rc->commandLineArguments());
+	m_trainingDirectory = rc->workingDirectory();
+	EnvironmentAspect *aspect = rc->extraAspect<EnvironmentAspect>();
+	m_trainingEnvironment = aspect ? aspect->environment().toProcessEnvironment()
+																																: QProcessEnvironment::systemEnvironment();
+	return m_tasks.isEmpty();
+}
+
+QStringList DMakeStep::expandedArguments(const QString &args) const
+{
+	const ProcessParameters *pp = processParameters();
+	ProcessParameters params;
+	params.setMacroExpander(pp->macroExpander());
+	params.setEnvironment(pp->environment());
+	params.setWorkingDirectory(pp->workingDirectory());
+	params.setArguments(args);
+	return Utils::QtcProcess::splitArgs(params.effectiveArguments());
+}
+
 QString DMakeStep::outFileName() const
 {
 	QString outName = m_targetName;
@@ -260,39 +646,464 @@ void DMakeStep::run(QFutureInterface<bool> &fi)
 		return;
 	}
 	//processParameters()->setWorkingDirectory(project()->projectDirectory());
+	// one demangler for all error output of the build, until its last flush
+	delete m_demangler;
+	m_demangler = new DDemangler;
+	if (m_buildPreset == ReleasePgo)
+	{
+		m_futureInterface = &fi;
+		runPgo();
+		return;
+	}
+	if (isIncremental())
+	{
+		m_futureInterface = &fi;
+		runIncremental();
+		return;
+	}
+	// only starts the compiler, processFinished() comes when it is done
 	AbstractProcessStep::run(fi);
 }
 
-void DMakeStep::stdError(const QString &line)
+/**
+ * Compiles the modules whose object is missing or older than one of the
+ * files it was built from, or was built with other flags, then links the
+ * objects when any of them changed. A profiled build compiles all modules
+ * with the compiler's statistics turned on. The compilers run in the
+ * background; compileFinished() goes on from there.
+ */
+void DMakeStep::runIncremental()
 {
-	QString res = line;
-	try
+	m_runWorkingDirectory = processParameters()->effectiveWorkingDirectory();
+	m_runCommand = processParameters()->effectiveCommand();
+	m_runEnvironment = processParameters()->environment().toProcessEnvironment();
+	m_build = new DIncrementalBuild(m_objectDirectory);
+	m_build->load();
+
+	QList<DCompileJob> stale;
+	m_linkObjects.clear();
+	foreach(const DCompileJob& job, m_compileJobs)
 	{
-		QProcess proc;
-		proc.setProcessChannelMode(QProcess::MergedChannels);
-		proc.start(QLatin1String("ddemangle"));
-		if (!proc.waitForStarted(10000))
-			return;
-		proc.write(line.toUtf8());
-		proc.closeWriteChannel();
-		if(!proc.waitForFinished(2000))
+		m_linkObjects.append(job.object);
+		if(m_profileBuild)
 		{
-			proc.close();
-			return;
+			// the flags only add statistics, so they stay out of the command hash
+			DCompileJob profiled = job;
+			profiled.arguments << DBuildProfile::compilerArguments(m_runCommand, traceFile(job));
+			stale.append(profiled);
 		}
-		else if(proc.exitCode() != 0)
+		else if(!m_build->isUpToDate(job.object, job.commandHash))
 		{
-			proc.close();
-			return;
+			stale.append(job);
 		}
+	}
+
+	m_objectsChanged = !stale.isEmpty();
+	m_objectCache = m_useObjectCache ? new DObjectCache : 0;
+	if(m_objectCache && !m_profileBuild && m_objectsChanged)
+	{
+		// asking the compiler for its version may take a while, the first time
+		m_staleJobs = stale;
+		m_identityWatcher.setFuture(QtConcurrent::run(&DObjectCache::compilerIdentity, m_runCommand,
+																																																m_runWorkingDirectory, m_runEnvironment));
+		return;
+	}
+	startCompiling(stale);
+}
+
+void DMakeStep::compilerIdentityReady()
+{
+	const QList<DCompileJob> stale = m_staleJobs;
+	m_staleJobs.clear();
+	if(!m_futureInterface)
+		return;
+	if(m_futureInterface->isCanceled())
+	{
+		finishIncremental(false);
+		return;
+	}
+
+	m_objectCache->setCompilerIdentity(m_identityWatcher.result());
+	QList<DCompileJob> compile;
+	foreach(const DCompileJob& job, stale)
+	{
+		QStringList inputs;
+		if(m_objectCache->restore(job, &inputs))
+			m_build->record(job.object, job.commandHash, inputs);
 		else
+			compile.append(job);
+	}
+	if(compile.size() < stale.size())
+		emit addOutput(tr("Reused %n object(s) from the cache.", 0, stale.size() - compile.size()),
+																	BuildStep::MessageOutput);
+	startCompiling(compile);
+}
+
+void DMakeStep::startCompiling(const QList<DCompileJob> &jobs)
+{
+	m_compileCount = jobs.size();
+	m_futureInterface->setProgressRange(0, m_compileCount + 1);
+	m_buildProfile = m_profileBuild ? new DBuildProfile : 0;
+	m_scheduler = new DCompileScheduler(jobs, m_runCommand, m_runWorkingDirectory, m_runEnvironment, this);
+	m_scheduler->setWorkerCount(m_parallelJobs);
+	m_scheduler->setStopOnError(m_stopOnError);
+	connect(m_scheduler, SIGNAL(jobStarted(int)), this, SLOT(compileJobStarted(int)));
+	connect(m_scheduler, SIGNAL(stdOutput(QString)), this, SLOT(compileOutput(QString)));
+	connect(m_scheduler, SIGNAL(stdError(QString)), this, SLOT(compileError(QString)));
+	connect(m_scheduler, SIGNAL(jobFinished(int,bool)), this, SLOT(compileJobFinished(int,bool)));
+	connect(m_scheduler, SIGNAL(finished(bool)), this, SLOT(compileFinished(bool)));
+	m_scheduler->start(*m_futureInterface);
+}
+
+void DMakeStep::compileFinished(bool success)
+{
+	m_scheduler->deleteLater();
+	m_scheduler = 0;
+
+	if(m_buildProfile)
+	{
+		const QString profileFile = DBuildProfile::fileName(m_runWorkingDirectory);
+		if(m_buildProfile->save(profileFile))
+			emit addOutput(tr("Wrote the build profile to %1.").arg(QDir::toNativeSeparators(profileFile)),
+																		BuildStep::MessageOutput);
+		else
+			emit addOutput(tr("Could not write %1.").arg(QDir::toNativeSeparators(profileFile)),
+																		BuildStep::ErrorMessageOutput);
+		delete m_buildProfile;
+		m_buildProfile = 0;
+	}
+
+	if(success)
+	{
+		// the objects go through a response file to stay clear of command line limits
+		const QString responseFile = m_objectDirectory + QLatin1String("/link.rsp");
+		QStringList linkArgs = m_linkArguments;
+		linkArgs << m_linkObjects;
+		m_linkHash = DIncrementalBuild::commandHash(m_runCommand, linkArgs);
+		if(!m_objectsChanged && m_build->isUpToDate(m_targetFile, m_linkHash))
+		{
+			emit addOutput(tr("The target is up to date."), BuildStep::MessageOutput);
+		}
+		else
+		{
+			QDir().mkpath(m_objectDirectory);
+			if(!writeResponseFile(responseFile, m_linkObjects))
+			{
+				emit addOutput(tr("Could not write %1.").arg(QDir::toNativeSeparators(responseFile)),
+																			BuildStep::ErrorMessageOutput);
+				success = false;
+			}
+			else
+			{
+				emit addOutput(tr("Linking %1").arg(QDir::toNativeSeparators(m_targetFile)),
+																			BuildStep::MessageOutput);
+				QDir().mkpath(QFileInfo(m_targetFile).absolutePath());
+				m_stage = Linking;
+				startProcess(m_runCommand, QStringList(m_linkArguments) << QLatin1Char('@') + responseFile,
+																	m_runWorkingDirectory, m_runEnvironment);
+				return;
+			}
+		}
+	}
+	finishIncremental(success);
+}
+
+void DMakeStep::linkFinished(bool success)
+{
+	if(success)
+		m_build->record(m_targetFile, m_linkHash, m_linkObjects);
+	else
+		m_build->forget(m_targetFile);
+	finishIncremental(success);
+}
+
+/**
+ * Starts a process of the build; its output goes through the parsers as it
+ * comes and stageFinished() goes on when it has ended.
+ */
+void DMakeStep::startProcess(const QString &command, const QStringList &arguments,
+																													const QString &workingDirectory, const QProcessEnvironment &environment)
+{
+	m_stageCommand = command;
+	m_stageArguments = arguments;
+	m_stageProcess = new QProcess(this);
+	m_stageProcess->setWorkingDirectory(workingDirectory);
+	m_stageProcess->setProcessEnvironment(environment);
+	connect(m_stageProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(readStageOutput()));
+	connect(m_stageProcess, SIGNAL(readyReadStandardError()), this, SLOT(readStageOutput()));
+	connect(m_stageProcess, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(stageProcessFinished()));
+	connect(m_stageProcess, SIGNAL(error(QProcess::ProcessError)), this, SLOT(stageProcessError()));
+	m_cancelTimer.start();
+	m_stageProcess->start(command, arguments);
+}
+
+void DMakeStep::readStageOutput()
+{
+	if(m_stageProcess)
+		readProcessOutput(m_stageProcess, false);
+}
+
+void DMakeStep::stageProcessFinished()
+{
+	QProcess *process = m_stageProcess;
+	readProcessOutput(process, true);
+	const bool canceled = m_futureInterface->isCanceled();
+	const bool success = process->exitStatus() == QProcess::NormalExit && process->exitCode() == 0;
+	if(!success && !canceled)
+		emit addOutput(tr("The process \"%1\" exited with code %2.")
+																	.arg(QDir::toNativeSeparators(m_stageCommand), QString::number(process->exitCode())),
+																	BuildStep::ErrorMessageOutput);
+	endStageProcess();
+	stageFinished(success && !canceled);
+}
+
+void DMakeStep::stageProcessError()
+{
+	// other errors are followed by finished()
+	if(!m_stageProcess || m_stageProcess->error() != QProcess::FailedToStart)
+		return;
+	emit addOutput(tr("Could not start process \"%1\" %2")
+																.arg(QDir::toNativeSeparators(m_stageCommand),
+																					Utils::QtcProcess::joinArgs(m_stageArguments)),
+																BuildStep::ErrorMessageOutput);
+	endStageProcess();
+	stageFinished(false);
+}
+
+void DMakeStep::endStageProcess()
+{
+	m_cancelTimer.stop();
+	m_stageProcess->disconnect(this);
+	m_stageProcess->deleteLater();
+	m_stageProcess = 0;
+}
+
+void DMakeStep::checkForCancel()
+{
+	if(m_stageProcess && m_futureInterface && m_futureInterface->isCanceled())
+		m_stageProcess->kill();
+}
+
+void DMakeStep::stageFinished(bool success)
+{
+	const Stage stage = m_stage;
+	m_stage = NoStage;
+	switch(stage)
+	{
+		case Linking: linkFinished(success); break;
+		case PgoInstrumenting:
+		case PgoTraining:
+		case PgoMerging:
+		case PgoOptimizing: pgoStageFinished(stage, success); break;
+		default: break;
+	}
+}
+
+void DMakeStep::finishIncremental(bool success)
+{
+	m_futureInterface->setProgressValue(m_compileCount + 1);
+	flushDemangler();
+	if(outputParser())
+		outputParser()->flush();
+	if(m_objectCache)
+		m_objectCache->trim();
+	if(!m_build->save())
+		emit addOutput(tr("Could not save the build state in %1.")
+																	.arg(QDir::toNativeSeparators(m_objectDirectory)), BuildStep::ErrorMessageOutput);
+	delete m_objectCache;
+	m_objectCache = 0;
+	delete m_build;
+	m_build = 0;
+	finishRun(success);
+}
+
+/** Reports the result of a build that did not go through AbstractProcessStep::run(). */
+void DMakeStep::finishRun(bool success)
+{
+	flushDemangler();
+	deleteDemangler();
+	QFutureInterface<bool> *fi = m_futureInterface;
+	m_futureInterface = 0;
+	fi->reportResult(success);
+	emit finished();
+}
+
+void DMakeStep::compileJobStarted(int job)
+{
+	const DCompileScheduler *scheduler = qobject_cast<DCompileScheduler *>(sender());
+	emit addOutput(tr("Compiling %1").arg(QDir::toNativeSeparators(scheduler->job(job).source)),
+																BuildStep::MessageOutput);
+}
+
+void DMakeStep::compileJobFinished(int job, bool success)
+{
+	const DCompileScheduler *scheduler = qobject_cast<DCompileScheduler *>(sender());
+	if(m_buildProfile)
+		m_buildProfile->addModule(scheduler->job(job).source, scheduler->jobWorker(job),
+																												scheduler->jobStartTime(job), scheduler->jobDuration(job),
+																												traceFile(scheduler->job(job)));
+	if(success)
+	{
+		const QStringList inputs = m_build->recordCompiled(scheduler->job(job), m_runWorkingDirectory);
+		if(m_objectCache)
+			m_objectCache->store(scheduler->job(job), inputs);
+	}
+	else
+		m_build->forget(scheduler->job(job).object);
+}
+
+void DMakeStep::compileOutput(const QString &line)
+{
+	if(m_buildProfile && m_buildProfile->parseOutput(line))
+		return;
+	stdOutput(line);
+}
+
+void DMakeStep::compileError(const QString &line)
+{
+	stdError(line);
+}
+
+/**
+ * Builds with instrumentation, runs the training workload, merges the
+ * profiles it wrote and builds again, optimized with them. Each stage is a
+ * process started when the one before has ended, see pgoStageFinished().
+ */
+void DMakeStep::runPgo()
+{
+	m_runCommand = processParameters()->effectiveCommand();
+	m_runWorkingDirectory = processParameters()->effectiveWorkingDirectory();
+	m_runEnvironment = processParameters()->environment().toProcessEnvironment();
+	m_pgoOptimizeArguments = Utils::QtcProcess::splitArgs(processParameters()->effectiveArguments());
+	QDir rawDir(pgoDirectory() + QLatin1String("/raw"));
+	rawDir.removeRecursively();
+	QDir().mkpath(rawDir.path());
+	m_futureInterface->setProgressRange(0, 4);
+
+	emit addOutput(tr("Building the instrumented binary"), BuildStep::MessageOutput);
+	m_stage = PgoInstrumenting;
+	startProcess(m_runCommand, m_pgoInstrumentArguments, m_runWorkingDirectory, m_runEnvironment);
+}
+
+void DMakeStep::pgoStageFinished(Stage stage, bool success)
+{
+	if(!success)
+	{
+		finishRun(false);
+		return;
+	}
+	switch(stage)
+	{
+		case PgoInstrumenting:
 		{
-			res = QString::fromUtf8(proc.readAllStandardOutput());
-			proc.close();
+			m_futureInterface->setProgressValue(1);
+			emit addOutput(tr("Training with %1").arg(QDir::toNativeSeparators(m_trainingExecutable)),
+																		BuildStep::MessageOutput);
+			m_stage = PgoTraining;
+			startProcess(m_trainingExecutable, m_trainingArguments, m_trainingDirectory, m_trainingEnvironment);
+			break;
 		}
+		case PgoTraining:
+		{
+			m_futureInterface->setProgressValue(2);
+			const QDir rawDir(pgoDirectory() + QLatin1String("/raw"));
+			QStringList mergeArgs;
+			mergeArgs << QLatin1String("merge") << QLatin1String("-output=") + pgoDirectory()
+														+ QLatin1String("/merged.profdata");
+			foreach(const QString& raw, rawDir.entryList(QStringList(QLatin1String("*.profraw")), QDir::Files))
+				mergeArgs << rawDir.filePath(raw);
+			if(mergeArgs.size() == 2)
+			{
+				emit addOutput(tr("The training run wrote no profile."), BuildStep::ErrorMessageOutput);
+				finishRun(false);
+				break;
+			}
+			emit addOutput(tr("Merging %n profile(s)", 0, mergeArgs.size() - 2), BuildStep::MessageOutput);
+			m_stage = PgoMerging;
+			startProcess(m_profdataCommand, mergeArgs, m_runWorkingDirectory, m_runEnvironment);
+			break;
+		}
+		case PgoMerging:
+		{
+			m_futureInterface->setProgressValue(3);
+			emit addOutput(tr("Building the optimized binary"), BuildStep::MessageOutput);
+			m_stage = PgoOptimizing;
+			startProcess(m_runCommand, m_pgoOptimizeArguments, m_runWorkingDirectory, m_runEnvironment);
+			break;
+		}
+		default:
+		{
+			m_futureInterface->setProgressValue(4);
+			finishRun(true);
+		}
+	}
+}
+
+void DMakeStep::readProcessOutput(QProcess *process, bool flush)
+{
+	process->setReadChannel(QProcess::StandardOutput);
+	while(process->canReadLine())
+		stdOutput(QString::fromLocal8Bit(process->readLine()));
+	if(flush && process->bytesAvailable())
+		stdOutput(QString::fromLocal8Bit(process->readAll()));
+	process->setReadChannel(QProcess::StandardError);
+	while(process->canReadLine())
+		stdError(QString::fromLocal8Bit(process->readLine()));
+	if(flush && process->bytesAvailable())
+		stdError(QString::fromLocal8Bit(process->readAll()));
+	if(flush)
+		flushDemangler();
+}
+
+void DMakeStep::stdError(const QString &line)
+{
+	if(!m_demangler)
+	{
+		AbstractProcessStep::stdError(line);
+		return;
 	}
-	catch(...){}
-	AbstractProcessStep::stdError(res);
+	const QStringList lines = m_demangler->demangle(line);
+	const QString error = m_demangler->takeError();
+	if(!error.isEmpty())
+		emit addOutput(error, BuildStep::MessageOutput);
+	foreach(const QString &res, lines)
+		AbstractProcessStep::stdError(res);
+}
+
+/**
+ * Writes the error output the demangler held back, at the end of a process's
+ * output, while the output parsers still take it.
+ */
+void DMakeStep::flushDemangler()
+{
+	if(!m_demangler)
+		return;
+	const QStringList lines = m_demangler->flush();
+	const QString error = m_demangler->takeError();
+	if(!error.isEmpty())
+		emit addOutput(error, BuildStep::MessageOutput);
+	foreach(const QString &res, lines)
+		AbstractProcessStep::stdError(res);
+}
+
+void DMakeStep::deleteDemangler()
+{
+	delete m_demangler;
+	m_demangler = 0;
+}
+
+void DMakeStep::processStartupFailed()
+{
+	deleteDemangler();
+	AbstractProcessStep::processStartupFailed();
+}
+
+void DMakeStep::processFinished(int exitCode, QProcess::ExitStatus status)
+{
+	// AbstractProcessStep has read the rest of the output, the parsers still take it
+	flushDemangler();
+	deleteDemangler();
+	AbstractProcessStep::processFinished(exitCode, status);
 }
 
 BuildStepConfigWidget *DMakeStep::createConfigWidget()
@@ -324,6 +1135,8 @@ DMakeStepConfigWidget::DMakeStepConfigWidget(DMakeStep *makeStep)
 	m_ui->buildPresetComboBox->addItem(QLatin1String("Release"));
 	m_ui->buildPresetComboBox->addItem(QLatin1String("Unittest"));
 	m_ui->buildPresetComboBox->addItem(QLatin1String("None"));
+	m_ui->buildPresetComboBox->addItem(QLatin1String("Release, LTO (LDC)"));
+	m_ui->buildPresetComboBox->addItem(QLatin1String("Release, PGO and LTO (LDC)"));
 
 	m_ui->targetTypeComboBox->setCurrentIndex((int)m_makeStep->m_targetType);
 	m_ui->buildPresetComboBox->setCurrentIndex((int)m_makeStep->m_buildPreset);
@@ -331,6 +1144,15 @@ DMakeStepConfigWidget::DMakeStepConfigWidget(DMakeStep *makeStep)
 	m_ui->targetNameLineEdit->setText(m_makeStep->m_targetName);
 	m_ui->targetDirLineEdit->setText(m_makeStep->m_targetDirName);
 	m_ui->objDirLineEdit->setText(m_makeStep->m_objDirName);
+	m_ui->incrementalCheckBox->setChecked(m_makeStep->m_incremental);
+	m_ui->parallelJobsSpinBox->setValue(m_makeStep->m_parallelJobs);
+	m_ui->stopOnErrorCheckBox->setChecked(m_makeStep->m_stopOnError);
+	m_ui->objectCacheCheckBox->setChecked(m_makeStep->m_useObjectCache);
+	m_ui->profileCheckBox->setChecked(m_makeStep->m_profileBuild);
+	m_ui->parallelJobsSpinBox->setEnabled(m_makeStep->m_incremental);
+	m_ui->stopOnErrorCheckBox->setEnabled(m_makeStep->m_incremental);
+	m_ui->objectCacheCheckBox->setEnabled(m_makeStep->m_incremental);
+	m_ui->profileCheckBox->setEnabled(m_makeStep->m_incremental);
 
 	updateDetails();
 
@@ -346,11 +1168,25 @@ DMakeStepConfigWidget::DMakeStepConfigWidget(DMakeStep *makeStep)
 									this, SLOT(objDirLineEditTextEdited()));
 	connect(m_ui->makeArgumentsLineEdit, SIGNAL(textChanged()),
 									this, SLOT(makeArgumentsLineEditTextEdited()));
+	connect(m_ui->incrementalCheckBox, SIGNAL(toggled(bool)),
+									this, SLOT(incrementalCheckBoxToggled(bool)));
+	connect(m_ui->parallelJobsSpinBox, SIGNAL(valueChanged(int)),
+									this, SLOT(parallelJobsSpinBoxValueChanged(int)));
+	connect(m_ui->stopOnErrorCheckBox, SIGNAL(toggled(bool)),
+									this, SLOT(stopOnErrorCheckBoxToggled(bool)));
+	connect(m_ui->objectCacheCheckBox, SIGNAL(toggled(bool)),
+									this, SLOT(objectCacheCheckBoxToggled(bool)));
+	connect(m_ui->profileCheckBox, SIGNAL(toggled(bool)),
+									this, SLOT(profileCheckBoxToggled(bool)));
 
 	connect(ProjectExplorerPlugin::instance(), SIGNAL(settingsChanged()),
 									this, SLOT(updateDetails()));
 	connect(pro, SIGNAL(environmentChanged()),
 									this, SLOT(updateDetails()));
+	connect(pro, SIGNAL(configurationChanged(int)),
+									this, SLOT(updateDetails()));
+	connect(pro, SIGNAL(filesChanged(QStringList,QStringList)),
+									this, SLOT(updateDetails()));
 	connect(m_makeStep->buildConfiguration(), SIGNAL(buildDirectoryChanged()),
 									this, SLOT(updateDetails()));
 	connect(m_makeStep->buildConfiguration(), SIGNAL(configurationChanged()),
@@ -378,7 +1214,8 @@ void DMakeStepConfigWidget::updateDetails()
 	param.setWorkingDirectory(bc->buildDirectory().toString());
 	param.setEnvironment(bc->environment());
 	param.setCommand(m_makeStep->makeCommand(bc->environment()));
-	param.setArguments(m_makeStep->allArguments());
+	param.setArguments(m_makeStep->isIncremental() ? m_makeStep->compileArguments()
+																															: m_makeStep->allArguments());
 	m_summaryText = param.summary(displayName());
 	emit updateSummary();
 
@@ -425,6 +1262,31 @@ void DMakeStepConfigWidget::objDirLineEditTextEdited()
 	m_makeStep->m_objDirName = m_ui->objDirLineEdit->text();
 	updateDetails();
 }
+void DMakeStepConfigWidget::incrementalCheckBoxToggled(bool checked)
+{
+	m_makeStep->m_incremental = checked;
+	m_ui->parallelJobsSpinBox->setEnabled(checked);
+	m_ui->stopOnErrorCheckBox->setEnabled(checked);
+	m_ui->objectCacheCheckBox->setEnabled(checked);
+	m_ui->profileCheckBox->setEnabled(checked);
+	updateDetails();
+}
+void DMakeStepConfigWidget::parallelJobsSpinBoxValueChanged(int value)
+{
+	m_makeStep->m_parallelJobs = value;
+}
+void DMakeStepConfigWidget::stopOnErrorCheckBoxToggled(bool checked)
+{
+	m_makeStep->m_stopOnError = checked;
+}
+void DMakeStepConfigWidget::objectCacheCheckBoxToggled(bool checked)
+{
+	m_makeStep->m_useObjectCache = checked;
+}
+void DMakeStepConfigWidget::profileCheckBoxToggled(bool checked)
+{
+	m_makeStep->m_profileBuild = checked;
+}
 
 //--------------------------------------------------------------------------
 //-- DMakeStepFactory
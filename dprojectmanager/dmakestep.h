@@ -1,15 +1,26 @@
 #ifndef DMAKESTEP_H
 #define DMAKESTEP_H
 
+#include "dincrementalbuild.h"
+
 #include <projectexplorer/abstractprocessstep.h>
 
+#include <QFutureWatcher>
+#include <QProcessEnvironment>
+#include <QTimer>
+
 QT_BEGIN_NAMESPACE
 class QListWidgetItem;
+class QProcess;
 QT_END_NAMESPACE
 
 namespace DProjectManager {
 namespace Internal {
 
+class DBuildProfile;
+class DCompileScheduler;
+class DDemangler;
+class DObjectCache;
 class DMakeStepConfigWidget;
 class DMakeStepFactory;
 namespace Ui { class DMakeStep; }
@@ -35,7 +46,9 @@ public:
 		Debug = 0,
 		Release = 1,
 		Unittest = 2,
-		None = 3
+		None = 3,
+		ReleaseLto = 4, ///< ldc only
+		ReleasePgo = 5  ///< ldc only, instrumented build, training run and optimized build
 	};
 
 public:
@@ -51,26 +64,141 @@ public:
 	void stdError(const QString &line);
 
 	QString allArguments() const;
+	/** Flags for a syntax and semantic check of a single file, without output. */
+	QString checkArguments() const;
+	/** Flags shared by the per-module compilations of an incremental build. */
+	QString compileArguments() const;
+	/** Flags for linking the objects of an incremental build. */
+	QString linkArguments() const;
+	/** Flags for the unittest binary of the test runner, without sources and output. */
+	QString unittestArguments() const;
+	QString unittestDirectory() const;
+	/** Writes @a arguments one per line, quoted, for an @file argument of the compiler. */
+	static bool writeResponseFile(const QString &fileName, const QStringList &arguments);
 	QString outFileName() const;
 	QString targetDirName() const { return m_targetDirName; }
 	QString makeCommand(const Utils::Environment &environment) const;
 	void setMakeArguments(const QString val) { m_makeArguments = val; }
 	void setBuildPreset(BuildPreset pres) { m_buildPreset = pres; }
+	/** Whether modules get compiled separately; never for profile-guided optimization. */
+	bool isIncremental() const { return m_incremental && m_buildPreset != ReleasePgo; }
 
 protected:
 	DMakeStep(ProjectExplorer::BuildStepList *parent, DMakeStep *bs);
 	DMakeStep(ProjectExplorer::BuildStepList *parent, const Core::Id id);
+	void processStartupFailed();
+	void processFinished(int exitCode, QProcess::ExitStatus status);
 
 private:
+	enum Stage
+	{
+		NoStage,
+		Linking,
+		PgoInstrumenting,
+		PgoTraining,
+		PgoMerging,
+		PgoOptimizing
+	};
+
 	void ctor();
+	QString presetArguments() const;
+	QString relativeTargetDir() const;
+	QString includeArguments(const QString &relTargetDir) const;
+	QString dubArguments() const;
+	QString libraryArguments(const QString &relTargetDir) const;
+	QString objectDirectory() const;
+	QString pgoDirectory() const;
+	bool initPgo(const QString &command);
+	QStringList expandedArguments(const QString &args) const;
+	const QStringList& sourceFiles() const;
+	const QString& sourceArguments() const;
+	bool sourcesInResponseFile() const;
+	QString sourcesResponseFile() const;
+	void runIncremental();
+	void startCompiling(const QList<DCompileJob> &jobs);
+	void linkFinished(bool success);
+	void finishIncremental(bool success);
+	void finishRun(bool success);
+	void runPgo();
+	void pgoStageFinished(Stage stage, bool success);
+	void startProcess(const QString &command, const QStringList &arguments,
+																			const QString &workingDirectory, const QProcessEnvironment &environment);
+	void endStageProcess();
+	void stageFinished(bool success);
+	void readProcessOutput(QProcess *process, bool flush);
+	void flushDemangler();
+	void deleteDemangler();
+
+private slots:
+	void invalidateSources();
+	void compileJobStarted(int job);
+	void compileJobFinished(int job, bool success);
+	void compileOutput(const QString &line);
+	void compileError(const QString &line);
+	void compileFinished(bool success);
+	void compilerIdentityReady();
+	void readStageOutput();
+	void stageProcessFinished();
+	void stageProcessError();
+	void checkForCancel();
 
+private:
 	TargetType m_targetType;
 	BuildPreset m_buildPreset;
 	QString m_makeArguments;
 	QString m_targetName;
 	QString m_targetDirName;
 	QString m_objDirName;
+	bool m_incremental;
+	int m_parallelJobs; ///< 0 for one compiler per core
+	bool m_stopOnError;
 	QList<ProjectExplorer::Task> m_tasks;
+
+	// incremental build, prepared by init() for run()
+	QString m_objectDirectory;
+	QList<DCompileJob> m_compileJobs;
+	QStringList m_linkArguments;
+	QString m_targetFile;
+	DIncrementalBuild *m_build; ///< while an incremental build runs
+	DObjectCache *m_objectCache; ///< while an incremental build runs
+	DDemangler *m_demangler; ///< from run() until the compiler's output has ended
+	QFutureInterface<bool> *m_futureInterface; ///< of a build run by the step itself
+	DCompileScheduler *m_scheduler; ///< while modules are compiled
+	QString m_runCommand;
+	QString m_runWorkingDirectory;
+	QProcessEnvironment m_runEnvironment;
+	QStringList m_linkObjects;
+	QList<DCompileJob> m_staleJobs; ///< while the compiler identity is asked for
+	QFutureWatcher<QByteArray> m_identityWatcher;
+	QByteArray m_linkHash;
+	bool m_objectsChanged;
+	int m_compileCount;
+
+	// the process a stage of a build runs, with what comes after it
+	Stage m_stage;
+	QProcess *m_stageProcess;
+	QString m_stageCommand;
+	QStringList m_stageArguments;
+	QTimer m_cancelTimer;
+
+	bool m_useObjectCache;
+	bool m_profileBuild;
+	DBuildProfile *m_buildProfile; ///< while a profiled build compiles
+
+	// profile-guided optimization, prepared by init() for run()
+	bool m_pgoInstrumenting; ///< while init() builds the instrumented arguments
+	QStringList m_pgoInstrumentArguments;
+	QStringList m_pgoOptimizeArguments; ///< taken when the build starts
+	QString m_profdataCommand;
+	QString m_trainingExecutable;
+	QStringList m_trainingArguments;
+	QString m_trainingDirectory;
+	QProcessEnvironment m_trainingEnvironment;
+
+	// sources of a full build, until the project changes
+	mutable QStringList m_sourceFiles;
+	mutable QString m_sourceArguments;
+	mutable bool m_sourcesValid;
 };
 
 class DMakeStepConfigWidget : public ProjectExplorer::BuildStepConfigWidget
@@ -93,6 +221,11 @@ private slots:
 	void targetNameLineEditTextEdited();
 	void targetDirNameLineEditTextEdited();
 	void objDirLineEditTextEdited();
+	void incrementalCheckBoxToggled(bool checked);
+	void parallelJobsSpinBoxValueChanged(int value);
+	void stopOnErrorCheckBoxToggled(bool checked);
+	void objectCacheCheckBoxToggled(bool checked);
+	void profileCheckBoxToggled(bool checked);
 
 private:
 	Ui::DMakeStep *m_ui;
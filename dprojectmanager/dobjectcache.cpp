@@ -0,0 +1,275 @@
+#include "dobjectcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const quint32 MANIFEST_MAGIC = 0x4d434f44; // "DOCM"
+const quint32 MANIFEST_VERSION = 1;
+const int MAX_MANIFEST_ENTRIES = 8;
+const qint64 DEFAULT_MAXIMUM_SIZE = Q_INT64_C(2) * 1024 * 1024 * 1024;
+const int VERSION_TIMEOUT = 10000;
+
+const char MANIFEST_FILE_NAME[] = "/manifest";
+const char USED_FILE_NAME[] = "/used";
+
+struct CompilerIdentity
+{
+ QDateTime modified;
+ qint64 size;
+ QByteArray identity;
+};
+
+QMutex identityMutex;
+QHash<QString, CompilerIdentity> identities; ///< by command
+
+QString objectFileName(const QString &directory, const QByteArray &object)
+{
+ return directory + QLatin1Char('/') + QString::fromLatin1(object) + QLatin1String(".o");
+}
+} // namespace
+
+DObjectCache::DObjectCache(const QString &directory)
+ : m_directory(directory),
+   m_maximumSize(DEFAULT_MAXIMUM_SIZE),
+   m_stored(false)
+{
+}
+
+QString DObjectCache::defaultDirectory()
+{
+ return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/dobjects");
+}
+
+QByteArray DObjectCache::compilerIdentity(const QString &command, const QString &workingDirectory,
+                                          const QProcessEnvironment &environment)
+{
+ const QFileInfo binary(command);
+ {
+  QMutexLocker lock(&identityMutex);
+  QHash<QString, CompilerIdentity>::ConstIterator it = identities.constFind(command);
+  if (it != identities.constEnd() && binary.exists()
+    && it->modified == binary.lastModified() && it->size == binary.size())
+   return it->identity;
+ }
+
+ QProcess process;
+ process.setWorkingDirectory(workingDirectory);
+ process.setProcessEnvironment(environment);
+ process.start(command, QStringList(QLatin1String("--version")));
+ if (!process.waitForFinished(VERSION_TIMEOUT))
+ {
+  process.kill();
+  process.waitForFinished();
+  return QByteArray();
+ }
+ const QByteArray output = process.readAllStandardOutput() + process.readAllStandardError();
+ if (output.isEmpty())
+  return QByteArray();
+ CompilerIdentity id;
+ id.modified = binary.lastModified();
+ id.size = binary.size();
+ id.identity = command.toUtf8() + '\n' + output;
+ QMutexLocker lock(&identityMutex);
+ identities.insert(command, id);
+ return id.identity;
+}
+
+QByteArray DObjectCache::fileHash(const QString &fileName)
+{
+ const QFileInfo fi(fileName);
+ if (!fi.exists())
+  return QByteArray();
+ const qint64 mtime = fi.lastModified().toMSecsSinceEpoch();
+ QHash<QString, QPair<qint64, QByteArray> >::ConstIterator it = m_fileHashes.constFind(fileName);
+ if (it != m_fileHashes.constEnd() && it->first == mtime)
+  return it->second;
+
+ QFile file(fileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return QByteArray();
+ QCryptographicHash hash(QCryptographicHash::Sha1);
+ while (!file.atEnd())
+  hash.addData(file.read(64 * 1024));
+ const QByteArray result = hash.result();
+ m_fileHashes.insert(fileName, qMakePair(mtime, result));
+ return result;
+}
+
+QString DObjectCache::entryDirectory(const DCompileJob &job)
+{
+ const QByteArray source = fileHash(job.source);
+ if (source.isEmpty())
+  return QString();
+ QCryptographicHash hash(QCryptographicHash::Sha1);
+ hash.addData(m_compiler);
+ hash.addData(job.commandHash);
+ hash.addData(job.source.toUtf8());
+ hash.addData(source);
+ const QString key = QString::fromLatin1(hash.result().toHex());
+ return m_directory + QLatin1Char('/') + key.left(2) + QLatin1Char('/') + key;
+}
+
+QList<DObjectCache::Entry> DObjectCache::readManifest(const QString &directory) const
+{
+ QList<Entry> entries;
+ QFile file(directory + QLatin1String(MANIFEST_FILE_NAME));
+ if (!file.open(QIODevice::ReadOnly))
+  return entries;
+ QDataStream in(&file);
+ in.setVersion(QDataStream::Qt_5_0);
+ quint32 magic, version, count;
+ in >> magic >> version >> count;
+ if (magic != MANIFEST_MAGIC || version != MANIFEST_VERSION)
+  return entries;
+ for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+ {
+  Entry entry;
+  in >> entry.object >> entry.inputs >> entry.hashes;
+  if (entry.inputs.size() == entry.hashes.size())
+   entries.append(entry);
+ }
+ if (in.status() != QDataStream::Ok)
+  entries.clear();
+ return entries;
+}
+
+bool DObjectCache::writeManifest(const QString &directory, const QList<Entry> &entries) const
+{
+ QSaveFile file(directory + QLatin1String(MANIFEST_FILE_NAME));
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ QDataStream out(&file);
+ out.setVersion(QDataStream::Qt_5_0);
+ out << MANIFEST_MAGIC << MANIFEST_VERSION << quint32(entries.size());
+ foreach (const Entry &entry, entries)
+  out << entry.object << entry.inputs << entry.hashes;
+ return file.commit();
+}
+
+void DObjectCache::touch(const QString &directory)
+{
+ QFile file(directory + QLatin1String(USED_FILE_NAME));
+ if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  file.write(QByteArray::number(QDateTime::currentMSecsSinceEpoch()));
+}
+
+bool DObjectCache::restore(const DCompileJob &job, QStringList *inputs)
+{
+ if (m_compiler.isEmpty())
+  return false;
+ const QString directory = entryDirectory(job);
+ if (directory.isEmpty())
+  return false;
+ foreach (const Entry &entry, readManifest(directory))
+ {
+  bool matches = true;
+  for (int i = 0; i < entry.inputs.size() && matches; ++i)
+   matches = fileHash(entry.inputs.at(i)) == entry.hashes.at(i);
+  if (!matches)
+   continue;
+  // a copy gets a new time, which keeps the object newer than its inputs
+  QFile::remove(job.object);
+  QDir().mkpath(QFileInfo(job.object).absolutePath());
+  if (!QFile::copy(objectFileName(directory, entry.object), job.object))
+   return false;
+  touch(directory);
+  *inputs = entry.inputs;
+  return true;
+ }
+ return false;
+}
+
+void DObjectCache::store(const DCompileJob &job, const QStringList &inputs)
+{
+ if (m_compiler.isEmpty())
+  return;
+ const QString directory = entryDirectory(job);
+ if (directory.isEmpty())
+  return;
+
+ Entry entry;
+ entry.inputs = inputs;
+ QCryptographicHash objectHash(QCryptographicHash::Sha1);
+ foreach (const QString &input, inputs)
+ {
+  const QByteArray hash = fileHash(input);
+  if (hash.isEmpty())
+   return;
+  entry.hashes.append(hash);
+  objectHash.addData(hash);
+ }
+ entry.object = objectHash.result().toHex();
+
+ QDir().mkpath(directory);
+ const QString object = objectFileName(directory, entry.object);
+ if (!QFile::exists(object))
+ {
+  const QString temporary = object + QLatin1String(".tmp");
+  QFile::remove(temporary);
+  if (!QFile::copy(job.object, temporary) || !QFile::rename(temporary, object))
+  {
+   QFile::remove(temporary);
+   return;
+  }
+ }
+
+ QList<Entry> entries = readManifest(directory);
+ for (int i = entries.size() - 1; i >= 0; --i)
+  if (entries.at(i).object == entry.object)
+   entries.removeAt(i);
+ entries.prepend(entry);
+ while (entries.size() > MAX_MANIFEST_ENTRIES)
+  QFile::remove(objectFileName(directory, entries.takeLast().object));
+ if (writeManifest(directory, entries))
+ {
+  touch(directory);
+  m_stored = true;
+ }
+}
+
+void DObjectCache::trim()
+{
+ if (!m_stored)
+  return;
+ m_stored = false;
+
+ typedef QPair<qint64, QPair<qint64, QString> > UsedEntry; // used, size, directory
+ QList<UsedEntry> entries;
+ qint64 total = 0;
+ const QDir root(m_directory);
+ foreach (const QFileInfo &bucket, root.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  foreach (const QFileInfo &entry, QDir(bucket.filePath()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+   qint64 size = 0;
+   foreach (const QFileInfo &file, QDir(entry.filePath()).entryInfoList(QDir::Files))
+    size += file.size();
+   const QFileInfo used(entry.filePath() + QLatin1String(USED_FILE_NAME));
+   entries.append(qMakePair(used.lastModified().toMSecsSinceEpoch(), qMakePair(size, entry.filePath())));
+   total += size;
+  }
+
+ std::sort(entries.begin(), entries.end());
+ for (int i = 0; i < entries.size() && total > m_maximumSize; ++i)
+ {
+  QDir(entries.at(i).second.second).removeRecursively();
+  total -= entries.at(i).second.first;
+ }
+}
+
+} // namespace Internal
+} // namespace DProjectManager
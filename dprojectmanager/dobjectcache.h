@@ -0,0 +1,69 @@
+#ifndef DOBJECTCACHE_H
+#define DOBJECTCACHE_H
+
+#include "dincrementalbuild.h"
+
+#include <QHash>
+#include <QPair>
+#include <QProcessEnvironment>
+#include <QStringList>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Objects of earlier compilations, shared by all projects and build
+ * configurations. A compilation is looked up by its compiler, command,
+ * source path and source content; each such entry lists the objects built
+ * for it together with the content hashes of all files the compiler read,
+ * so an object is only reused when every imported module is unchanged too.
+ * The least recently used entries go when the cache outgrows its size.
+ */
+class DObjectCache
+{
+public:
+ explicit DObjectCache(const QString &directory = defaultDirectory());
+
+ static QString defaultDirectory();
+ /**
+  * What identifies the compiler, its version output; empty if it did not run.
+  * Kept per command while the compiler binary is unchanged. Blocks the first
+  * time, so it is meant for a worker thread.
+  */
+ static QByteArray compilerIdentity(const QString &command, const QString &workingDirectory,
+                                    const QProcessEnvironment &environment);
+
+ void setCompilerIdentity(const QByteArray &identity) { m_compiler = identity; }
+ void setMaximumSize(qint64 bytes) { m_maximumSize = bytes; }
+
+ /// Puts the cached object of @a job in place and returns the files it was built from.
+ bool restore(const DCompileJob &job, QStringList *inputs);
+ void store(const DCompileJob &job, const QStringList &inputs);
+ /// Removes least recently used entries until the cache fits its size.
+ void trim();
+
+private:
+ struct Entry
+ {
+  QByteArray object;
+  QStringList inputs;
+  QList<QByteArray> hashes;
+ };
+
+ QByteArray fileHash(const QString &fileName);
+ QString entryDirectory(const DCompileJob &job);
+ QList<Entry> readManifest(const QString &directory) const;
+ bool writeManifest(const QString &directory, const QList<Entry> &entries) const;
+ static void touch(const QString &directory);
+
+ const QString m_directory;
+ QByteArray m_compiler;
+ qint64 m_maximumSize;
+ bool m_stored;
+ QHash<QString, QPair<qint64, QByteArray> > m_fileHashes; ///< by path, with mtime
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DOBJECTCACHE_H
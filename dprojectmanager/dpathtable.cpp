@@ -0,0 +1,192 @@
+#include "dpathtable.h"
+
+#include <QDir>
+
+#include <algorithm>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+void splitPath(const QString &filePath, QString *dir, QString *name)
+{
+ const int slash = filePath.lastIndexOf(QLatin1Char('/'));
+ *dir = slash < 0 ? QString() : filePath.left(slash);
+ *name = filePath.mid(slash + 1);
+}
+} // namespace
+
+/// Orders ids by their paths.
+struct DPathTable::PathLess
+{
+ explicit PathLess(const DPathTable *table) : m_table(table) {}
+ bool operator()(int a, int b) const { return m_table->compare(a, b) < 0; }
+
+ const DPathTable *m_table;
+};
+
+/** Compares the paths of two files as filePath() spells them, without building them. */
+int DPathTable::compare(int a, int b) const
+{
+ const File &fa = m_files.at(a);
+ const File &fb = m_files.at(b);
+ if (fa.dir == fb.dir)
+  return fa.name.compare(fb.name);
+ const QString &da = m_dirs.at(fa.dir).path;
+ const QString &db = m_dirs.at(fb.dir).path;
+ const int la = da.size() + 1 + fa.name.size();
+ const int lb = db.size() + 1 + fb.name.size();
+ for (int i = 0; i < la && i < lb; ++i)
+ {
+  const QChar ca = i < da.size() ? da.at(i) : i == da.size() ? QLatin1Char('/') : fa.name.at(i - da.size() - 1);
+  const QChar cb = i < db.size() ? db.at(i) : i == db.size() ? QLatin1Char('/') : fb.name.at(i - db.size() - 1);
+  if (ca != cb)
+   return ca.unicode() < cb.unicode() ? -1 : 1;
+ }
+ return la - lb;
+}
+
+QString DPathTable::relativeDirectory(const QString &path) const
+{
+ const QString rel = QDir(m_root).relativeFilePath(path);
+ return rel == QLatin1String(".") ? QString() : rel;
+}
+
+void DPathTable::setRoot(const QString &root)
+{
+ if (root == m_root)
+  return;
+ m_root = root;
+ for (int i = 0; i < m_dirs.size(); ++i)
+  m_dirs[i].relativePath = relativeDirectory(m_dirs.at(i).path);
+}
+
+int DPathTable::insert(const QString &filePath)
+{
+ bool added;
+ const int id = insertEntry(filePath, &added);
+ if (added)
+ {
+  m_order.insert(std::lower_bound(m_order.begin(), m_order.end(), id, PathLess(this)), id);
+ }
+ return id;
+}
+
+void DPathTable::insert(const QStringList &filePaths)
+{
+ const int oldCount = m_order.size();
+ foreach (const QString &filePath, filePaths)
+ {
+  bool added;
+  const int id = insertEntry(filePath, &added);
+  if (added)
+   m_order.append(id);
+ }
+ std::sort(m_order.begin() + oldCount, m_order.end(), PathLess(this));
+ std::inplace_merge(m_order.begin(), m_order.begin() + oldCount, m_order.end(), PathLess(this));
+}
+
+int DPathTable::insertEntry(const QString &filePath, bool *added)
+{
+ *added = false;
+ QString dirPath, name;
+ splitPath(filePath, &dirPath, &name);
+
+ int dir = m_dirIds.value(dirPath, -1);
+ if (dir < 0)
+ {
+  dir = m_dirs.size();
+  Directory d;
+  d.path = dirPath;
+  d.relativePath = relativeDirectory(dirPath);
+  m_dirs.append(d);
+  m_dirIds.insert(dirPath, dir);
+ }
+ else
+ {
+  const int existing = m_dirs.at(dir).names.value(name, -1);
+  if (existing >= 0)
+   return existing;
+ }
+
+ int id;
+ if (m_freeIds.isEmpty())
+ {
+  id = m_files.size();
+  m_files.append(File());
+ }
+ else
+ {
+  id = m_freeIds.last();
+  m_freeIds.removeLast();
+ }
+ m_files[id].dir = dir;
+ m_files[id].name = name;
+ m_dirs[dir].names.insert(name, id);
+ ++m_count;
+ *added = true;
+ return id;
+}
+
+bool DPathTable::remove(const QString &filePath)
+{
+ const int fileId = id(filePath);
+ if (fileId < 0)
+  return false;
+ m_order.erase(std::lower_bound(m_order.begin(), m_order.end(), fileId, PathLess(this)));
+ File &file = m_files[fileId];
+ // emptied directories are kept: there are few of them and they come back
+ m_dirs[file.dir].names.remove(file.name);
+ file.dir = -1;
+ file.name.clear();
+ m_freeIds.append(fileId);
+ --m_count;
+ return true;
+}
+
+void DPathTable::clear()
+{
+ m_dirs.clear();
+ m_dirIds.clear();
+ m_files.clear();
+ m_freeIds.clear();
+ m_count = 0;
+ m_order.clear();
+}
+
+int DPathTable::id(const QString &filePath) const
+{
+ QString dirPath, name;
+ splitPath(filePath, &dirPath, &name);
+ const int dir = m_dirIds.value(dirPath, -1);
+ return dir < 0 ? -1 : m_dirs.at(dir).names.value(name, -1);
+}
+
+QString DPathTable::filePath(int id) const
+{
+ if (id < 0 || id >= m_files.size() || m_files.at(id).dir < 0)
+  return QString();
+ const File &file = m_files.at(id);
+ return m_dirs.at(file.dir).path + QLatin1Char('/') + file.name;
+}
+
+QString DPathTable::relativePath(int id) const
+{
+ if (id < 0 || id >= m_files.size() || m_files.at(id).dir < 0)
+  return QString();
+ const File &file = m_files.at(id);
+ const QString &dir = m_dirs.at(file.dir).relativePath;
+ return dir.isEmpty() ? file.name : dir + QLatin1Char('/') + file.name;
+}
+
+QStringList DPathTable::files() const
+{
+ QStringList files;
+ files.reserve(m_order.size());
+ foreach (int id, m_order)
+  files.append(filePath(id));
+ return files;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,77 @@
+#ifndef DPATHTABLE_H
+#define DPATHTABLE_H
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * The files of a project. Each directory is stored once, with its path
+ * relative to the root; a file is a directory id plus a name and is known by
+ * a compact id. The ids are kept in the order of their paths, so files()
+ * lists the paths sorted without storing them a second time. Not thread-safe.
+ */
+class DPathTable
+{
+public:
+ DPathTable() : m_count(0) {}
+
+ /// Directory the relative paths are computed against.
+ void setRoot(const QString &root);
+ const QString &root() const { return m_root; }
+
+ /// Returns the id of @a filePath, adding it if needed.
+ int insert(const QString &filePath);
+ /// Adds many files at once, sorting the new ones once instead of one by one.
+ void insert(const QStringList &filePaths);
+ bool remove(const QString &filePath);
+ void clear();
+
+ int id(const QString &filePath) const;
+ bool contains(const QString &filePath) const { return id(filePath) >= 0; }
+ int size() const { return m_count; }
+ bool isEmpty() const { return m_count == 0; }
+
+ QString filePath(int id) const;
+ QString relativePath(int id) const;
+ QString relativePath(const QString &filePath) const { return relativePath(id(filePath)); }
+
+ /// All absolute paths, sorted.
+ QStringList files() const;
+
+private:
+ struct Directory
+ {
+  QString path;
+  QString relativePath; ///< empty for the root itself
+  QHash<QString, int> names;
+ };
+ struct File
+ {
+  File() : dir(-1) {}
+  int dir;     ///< -1 for a free id
+  QString name;
+ };
+
+ struct PathLess;
+
+ QString relativeDirectory(const QString &path) const;
+ int insertEntry(const QString &filePath, bool *added);
+ int compare(int a, int b) const;
+
+ QString m_root;
+ QVector<Directory> m_dirs;
+ QHash<QString, int> m_dirIds;
+ QVector<File> m_files;
+ QVector<int> m_freeIds;
+ int m_count;
+ QVector<int> m_order; ///< ids of the files, sorted by path
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DPATHTABLE_H
@@ -4,11 +4,18 @@
 #include "dbuildconfiguration.h"
 #include "dmakestep.h"
 #include "drunconfiguration.h"
+#include "dsymbolindex.h"
+#include "dimportgraph.h"
+#include "dsourcetree.h"
+
+#include "deditor/qcdassist.h"
 
 #include <coreplugin/documentmanager.h>
 #include <coreplugin/icontext.h>
 #include <coreplugin/icore.h>
+#include <coreplugin/messagemanager.h>
 #include <coreplugin/mimedatabase.h>
+#include <coreplugin/progressmanager/progressmanager.h>
 #include <cpptools/cpptoolsconstants.h>
 #include <cpptools/cppmodelmanagerinterface.h>
 #include <extensionsystem/pluginmanager.h>
@@ -22,10 +29,15 @@
 #include <qtsupport/customexecutablerunconfiguration.h>
 #include <utils/fileutils.h>
 #include <utils/qtcassert.h>
+#include <qtconcurrent/runextensions.h>
 
+#include <QCryptographicHash>
 #include <QDir>
+#include <QFileSystemWatcher>
 #include <QProcessEnvironment>
 #include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
 
 using namespace Core;
 using namespace ProjectExplorer;
@@ -41,6 +53,167 @@ const char PLUGIN_SETTINGS_KEY[] = "ProjectExplorer.Project.PluginSettings";
 namespace DProjectManager {
 namespace Internal {
 
+namespace {
+struct DProjectParseRequest
+{
+ int options;
+ QString projectFileName;
+ QString projectDirectory;
+ QString buildDirectory;
+ QString compiler; ///< of the active build, for the dub package
+ DPathTable oldFiles;
+ QStringList discovered;
+ QByteArray filesHash;
+ bool hadDubFiles;
+ int filesRevision;
+};
+
+bool readProjectFile(QFutureInterface<DProjectParseResult> &future,
+                     const DProjectParseRequest &request, DProjectCache::Data *data)
+{
+	// What the list was read from last time, to skip the walk below when only
+	// the configuration changed.
+	const DProjectCache cache(request.projectFileName);
+	DProjectCache::Data previous;
+	const bool hasPrevious = cache.loadStale(&previous);
+
+	cache.stampProject(data);
+	data->filesHash = DProjectCache::filesSectionHash(request.projectFileName);
+	QSettings sets(request.projectFileName, QSettings::IniFormat);
+
+ data->libraries = sets.value(QLatin1String(Constants::INI_LIBRARIES_KEY)).toString();
+ data->includes = sets.value(QLatin1String(Constants::INI_INCLUDES_KEY)).toString();
+ data->extraArgs = sets.value(QLatin1String(Constants::INI_EXTRA_ARGS_KEY)).toString();
+ data->autoDiscover = sets.value(QLatin1String(Constants::INI_AUTO_DISCOVER_KEY), false).toBool();
+ data->dubPackage = sets.value(QLatin1String(Constants::INI_DUB_PACKAGE_KEY)).toString();
+
+ QString bds = sets.value(QLatin1String(Constants::INI_SOURCE_ROOT_KEY)).toString();
+	Utils::FileName dir = Utils::FileName::fromString(request.projectDirectory);
+	if(bds.length() > 0 && bds != QLatin1String("."))
+		dir.appendPath(bds);
+	data->buildDirectory = dir.toString();
+	const bool needRebuild = data->buildDirectory != request.buildDirectory;
+	const QDir old(request.buildDirectory);
+	const QDir current(data->buildDirectory);
+
+	if(!needRebuild && hasPrevious && previous.filesHash == data->filesHash
+	   && previous.buildDirectory == data->buildDirectory)
+	{
+		data->files = previous.files;
+		return false;
+	}
+
+	data->files.clear();
+	sets.beginGroup(QLatin1String("Files"));
+	const QStringList keys = sets.allKeys();
+	future.setProgressRange(0, keys.size());
+	for(int i = 0; i < keys.size(); ++i)
+ {
+		QString rel = keys.at(i);
+		QString abs;
+		if(needRebuild)
+		{
+			// not cancellable: the keys are being rewritten
+			abs = old.absoluteFilePath(rel);
+			sets.remove(rel);
+			rel = current.relativeFilePath(abs);
+			sets.setValue(rel,0);
+		}
+		else
+		{
+			if(future.isCanceled())
+				return needRebuild;
+			abs = current.absoluteFilePath(rel);
+		}
+		data->files[abs] = rel;
+		if((i & 1023) == 0)
+			future.setProgressValue(i);
+ }
+	sets.endGroup();
+	sets.sync();
+	if(needRebuild)
+	{
+		// the rewrite is what the cache describes now
+		cache.stampProject(data);
+		data->filesHash = DProjectCache::filesSectionHash(request.projectFileName);
+	}
+	return needRebuild;
+}
+
+void parseProjectHelper(QFutureInterface<DProjectParseResult> &future, const DProjectParseRequest request)
+{
+ DProjectParseResult result;
+ result.options = request.options;
+ result.filesRevision = request.filesRevision;
+
+ // The cache is only valid for an unchanged .qcd, so a SourceRoot change,
+ // which needs the INI rewritten, always takes the INI path.
+ DProjectCache cache(request.projectFileName);
+ DProjectCache::Data data;
+ if(!cache.load(&data) || data.buildDirectory != request.buildDirectory)
+ {
+  result.needRebuild = readProjectFile(future, request, &data);
+  if(future.isCanceled() && !result.needRebuild)
+   return;
+  cache.save(data);
+ }
+
+ result.buildDirectory = data.buildDirectory;
+ result.libraries = data.libraries;
+ result.includes = data.includes;
+ result.extraArgs = data.extraArgs;
+ result.autoDiscover = data.autoDiscover;
+ result.dubPackage = data.dubPackage;
+ result.filesHash = data.filesHash;
+ if(!data.dubPackage.isEmpty())
+  result.dub = DDubResolver(QDir(request.projectDirectory).absoluteFilePath(data.dubPackage),
+                            request.compiler).resolve();
+
+ // Keys rebased for a new SourceRoot name the same files, so only an edited
+ // [Files] section gives a file delta; dub sources are compared every time.
+ result.filesChanged = result.needRebuild || ((request.options & DProject::Files)
+   && (data.filesHash != request.filesHash || request.filesHash.isEmpty()
+       || !result.dub.isEmpty() || request.hadDubFiles));
+ if(result.filesChanged)
+ {
+  result.files.setRoot(data.buildDirectory);
+  result.files.insert(data.files.keys());
+  QStringList unlisted;
+  foreach(const QString &filePath, request.discovered + result.dub.sourceFiles())
+   if(result.files.contains(filePath) == false && result.unlisted.contains(filePath) == false)
+   {
+    unlisted.append(filePath);
+    result.unlisted.insert(filePath);
+   }
+  result.files.insert(unlisted);
+
+  // both lists are sorted; the new one is then already built for files()
+  const QStringList newFiles = result.files.files();
+  const QStringList oldFiles = request.oldFiles.files();
+  int i = 0, j = 0;
+  while(i < newFiles.size() || j < oldFiles.size())
+  {
+   if(j == oldFiles.size() || (i < newFiles.size() && newFiles.at(i) < oldFiles.at(j)))
+    result.added.append(newFiles.at(i++));
+   else if(i == newFiles.size() || oldFiles.at(j) < newFiles.at(i))
+    result.removed.append(oldFiles.at(j++));
+   else
+    ++i, ++j;
+  }
+ }
+ future.reportResult(result);
+}
+
+void deleteSymbolIndex(DSymbolIndex *index)
+{
+ // the last reference may be dropped by a locator thread
+ if (index->thread() == QThread::currentThread())
+  delete index;
+ else
+  index->deleteLater();
+}
+} // namespace
+
 //--------------------------------------------------------------------------------------
 //
 // DProject
@@ -50,7 +223,13 @@ namespace Internal {
 DProject::DProject(Manager *manager, const QString &fileName)
  : m_manager(manager),
 			m_projectName(QFileInfo(fileName).completeBaseName()),
-   m_projectFileName(fileName)
+   m_projectFileName(fileName),
+   m_cache(fileName),
+   m_autoDiscover(false),
+   m_configurationLoaded(false),
+   m_filesRevision(0),
+   m_dubWatcher(new QFileSystemWatcher(this)),
+   m_pendingOptions(0)
 {
  setProjectContext(Context(DProjectManager::Constants::DPROJECTCONTEXT));
  setProjectLanguages(Context(ProjectExplorer::Constants::LANG_CXX));
@@ -59,113 +238,355 @@ DProject::DProject(Manager *manager, const QString &fileName)
 
 	DocumentManager::addDocument(m_projectIDocument);
 	m_rootNode = new DProjectNode(this, m_projectIDocument);
- m_manager->registerProject(this);
 
- QSettings sets(m_projectFileName, QSettings::IniFormat);
- QString bds = sets.value(QLatin1String(Constants::INI_SOURCE_ROOT_KEY)).toString();
- Utils::FileName dir = Utils::FileName::fromString(projectDirectory());
- if(bds.length() > 0 && bds != QLatin1String("."))
-  dir.appendPath(bds);
- m_buildDir.setPath(dir.toString());
+ DProjectCache::Data cached;
+ if(m_cache.load(&cached))
+  m_buildDir.setPath(cached.buildDirectory);
+ else
+ {
+  QSettings sets(m_projectFileName, QSettings::IniFormat);
+  QString bds = sets.value(QLatin1String(Constants::INI_SOURCE_ROOT_KEY)).toString();
+  Utils::FileName dir = Utils::FileName::fromString(projectDirectory());
+  if(bds.length() > 0 && bds != QLatin1String("."))
+   dir.appendPath(bds);
+  m_buildDir.setPath(dir.toString());
+ }
+ {
+  QWriteLocker lock(&m_filesLock);
+  m_files.setRoot(m_buildDir.path());
+ }
+
+ const QString indexName = QString::fromLatin1(
+    QCryptographicHash::hash(m_projectFileName.toUtf8(), QCryptographicHash::Sha1).toHex());
+ m_symbolIndex = QSharedPointer<DSymbolIndex>(
+    new DSymbolIndex(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                     + QLatin1String("/dsymbols/") + indexName + QLatin1String(".idx")),
+    deleteSymbolIndex);
+ connect(this, SIGNAL(fileListChanged()), this, SLOT(updateSymbolIndex()));
+
+ m_importGraph = new DImportGraph(this);
+ connect(this, SIGNAL(fileListChanged()), this, SLOT(updateImportGraph()));
+ connect(DocumentManager::instance(), SIGNAL(filesChangedInternally(QStringList)),
+         this, SLOT(filesSaved(QStringList)));
+
+ m_sourceTree = new DSourceTree(this);
+ connect(m_sourceTree, SIGNAL(filesChanged(QStringList,QStringList)),
+         this, SLOT(applyDiscoveredFiles(QStringList,QStringList)));
+ connect(&m_parseWatcher, SIGNAL(finished()), this, SLOT(parseFinished()));
+ connect(m_dubWatcher, SIGNAL(fileChanged(QString)), this, SLOT(dubPackageChanged()));
 
+ m_manager->registerProject(this);
 }
 
 DProject::~DProject()
 {
- m_codeModelFuture.cancel();
+ m_parseWatcher.cancel();
+ m_parseWatcher.waitForFinished();
  m_manager->unregisterProject(this);
  delete m_rootNode;
 }
 
 Core::IDocument* DProject::document() const { return m_projectIDocument; }
 
-bool DProject::addFiles(const QStringList& filePaths)
+QStringList DProject::files(FilesMode) const
 {
- QSettings projectFiles(m_projectFileName, QSettings::IniFormat);
- projectFiles.beginGroup(QLatin1String("Files"));
- foreach (const QString &filePath, filePaths)
- {
-  if(m_files.contains(filePath) == false)
-			projectFiles.setValue(m_buildDir.relativeFilePath(filePath), 0);
- }
- return true;
+ QReadLocker lock(&m_filesLock);
+ return m_files.files();
 }
 
-bool DProject::removeFiles(const QStringList &filePaths)
+QStringList DProject::includeDirectories() const
 {
-	QSettings projectFiles(m_projectFileName, QSettings::IniFormat);
- projectFiles.beginGroup(QLatin1String("Files"));
- foreach (const QString &filePath, filePaths)
+ QStringList dirs;
+	foreach(QString s, m_includes.split(QLatin1Char(' '), QString::SkipEmptyParts))
 	{
-		QString rel = m_files.value(filePath);
-		if(rel.length() > 0)
-			projectFiles.remove(rel);
+		if(s.startsWith(QLatin1String("-I")))
+			s = s.remove(0,2);
+		if(s.contains(QLatin1String("%{")))
+			continue;
+		dirs.append(QDir::isAbsolutePath(s) ? s : m_buildDir.absoluteFilePath(s));
 	}
- return true;
+ foreach(const QString &dir, m_dub.importPaths())
+  if(dirs.contains(dir) == false)
+   dirs.append(dir);
+ return dirs;
 }
 
-bool DProject::renameFile(const QString &filePath, const QString &newFilePath)
+/** The compiler of the active build configuration, empty without one. */
+QString DProject::compilerCommand() const
 {
- QSettings projectFiles(m_projectFileName, QSettings::IniFormat);
- projectFiles.beginGroup(QLatin1String("Files"));
-	projectFiles.remove(m_buildDir.relativeFilePath(filePath));
-	projectFiles.setValue(m_buildDir.relativeFilePath(newFilePath), 0);
- return true;
+ if(!activeTarget() || !activeTarget()->activeBuildConfiguration())
+  return QString();
+ BuildConfiguration *bc = activeTarget()->activeBuildConfiguration();
+ BuildStepList *bsl = bc->stepList(ProjectExplorer::Constants::BUILDSTEPS_BUILD);
+ if(!bsl)
+  return QString();
+ foreach(BuildStep *step, bsl->steps())
+  if(DMakeStep *makeStep = qobject_cast<DMakeStep *>(step))
+   return makeStep->makeCommand(bc->environment());
+ return QString();
 }
 
-bool DProject::parseProject(RefreshOptions options)
+void DProject::updateImportGraph()
 {
-	QSettings sets(m_projectFileName, QSettings::IniFormat);
+ m_importGraph->update(files(AllFiles));
+}
 
-	QDir old;
-	bool needRebuild = false;
-	if (options & Configuration)
-	{
-  m_libs = sets.value(QLatin1String(Constants::INI_LIBRARIES_KEY)).toString();
-  m_includes = sets.value(QLatin1String(Constants::INI_INCLUDES_KEY)).toString();
-  m_extraArgs = sets.value(QLatin1String(Constants::INI_EXTRA_ARGS_KEY)).toString();
+void DProject::filesSaved(const QStringList &filePaths)
+{
+ m_importGraph->updateFiles(filePaths);
+ m_symbolIndex->scheduleUpdate(files(AllFiles), includeDirectories(), filePaths);
+}
 
-  QString bds = sets.value(QLatin1String(Constants::INI_SOURCE_ROOT_KEY)).toString();
-		Utils::FileName dir = Utils::FileName::fromString(projectDirectory());
-		if(bds.length() > 0 && bds != QLatin1String("."))
-			dir.appendPath(bds);
-		if((needRebuild = (dir.toString() != m_buildDir.path())))
-		{
-			old = m_buildDir;
-			m_buildDir.setPath(dir.toString());
-		}
-	}
+void DProject::dubPackageChanged()
+{
+ refresh(Everything);
+}
 
-	if (needRebuild || (options & Files))
- {
-  m_files.clear();
+void DProject::registerImports()
+{
+ QcdAssist::sendAddImportToDCD(m_buildDir.path());
+ foreach(const QString &dir, includeDirectories())
+  QcdAssist::sendAddImportToDCD(dir);
+}
 
-		sets.beginGroup(QLatin1String("Files"));
-		foreach(QString rel, sets.allKeys())
+void DProject::updateSymbolIndex()
+{
+ m_symbolIndex->scheduleUpdate(files(AllFiles), includeDirectories());
+}
+
+bool DProject::addFiles(const QStringList& filePaths)
+{
+ DProjectFileTransaction transaction(this);
+ transaction.addFiles(filePaths);
+ return transaction.commit();
+}
+
+bool DProject::removeFiles(const QStringList &filePaths)
+{
+ DProjectFileTransaction transaction(this);
+ transaction.removeFiles(filePaths);
+ return transaction.commit();
+}
+
+bool DProject::renameFile(const QString &filePath, const QString &newFilePath)
+{
+ DProjectFileTransaction transaction(this);
+ transaction.renameFile(filePath, newFilePath);
+ return transaction.commit();
+}
+
+bool DProject::applyFileChanges(const QSet<QString> &added, const QSet<QString> &removed)
+{
+ QStringList reallyAdded;
+ QStringList reallyRemoved;
+ foreach (const QString &filePath, removed)
+  if(m_files.contains(filePath))
+   reallyRemoved.append(filePath);
+ foreach (const QString &filePath, added)
+  if(m_files.contains(filePath) == false || m_unlisted.contains(filePath))
+   reallyAdded.append(filePath);
+ if(reallyAdded.isEmpty() && reallyRemoved.isEmpty())
+  return true;
+
+ // Our own write must not come back as a reload of the whole project.
+ DocumentManager::expectFileChange(m_projectFileName);
+ bool ok;
+ {
+  QSettings projectFiles(m_projectFileName, QSettings::IniFormat);
+  projectFiles.beginGroup(QLatin1String("Files"));
+  QWriteLocker lock(&m_filesLock);
+  foreach (const QString &filePath, reallyRemoved)
   {
-			QString abs;
-			if(needRebuild)
-			{
-				abs = old.absoluteFilePath(rel);
-				sets.remove(rel);
-				rel = m_buildDir.relativeFilePath(abs);
-				sets.setValue(rel,0);
-			}
-			else
-				abs = m_buildDir.absoluteFilePath(rel);
-			m_files[abs] = rel;
+   projectFiles.remove(m_files.relativePath(filePath));
+   m_files.remove(filePath);
+   m_unlisted.remove(filePath);
   }
-  emit fileListChanged();
+  foreach (const QString &filePath, reallyAdded)
+  {
+   projectFiles.setValue(m_files.relativePath(m_files.insert(filePath)), 0);
+   m_unlisted.remove(filePath);
+  }
+  projectFiles.endGroup();
+  projectFiles.sync();
+  ok = projectFiles.status() == QSettings::NoError;
  }
-	return needRebuild;
+ DocumentManager::unexpectFileChange(m_projectFileName);
+
+ ++m_filesRevision;
+ m_filesHash = DProjectCache::filesSectionHash(m_projectFileName);
+ updateCache();
+ m_rootNode->applyDelta(reallyAdded, reallyRemoved);
+ emit filesChanged(reallyAdded, reallyRemoved);
+ emit fileListChanged();
+ return ok;
+}
+
+void DProject::applyDiscoveredFiles(const QStringList &added, const QStringList &removed)
+{
+ QStringList reallyAdded;
+ QStringList reallyRemoved;
+ QWriteLocker lock(&m_filesLock);
+ foreach (const QString &filePath, removed)
+  if(m_dubFiles.contains(filePath) == false && m_unlisted.remove(filePath))
+  {
+   m_files.remove(filePath);
+   reallyRemoved.append(filePath);
+  }
+ foreach (const QString &filePath, added)
+  if(m_files.contains(filePath) == false)
+  {
+   m_files.insert(filePath);
+   m_unlisted.insert(filePath);
+   reallyAdded.append(filePath);
+  }
+ lock.unlock();
+ if(reallyAdded.isEmpty() && reallyRemoved.isEmpty())
+  return;
+
+ ++m_filesRevision;
+ m_rootNode->applyDelta(reallyAdded, reallyRemoved);
+ emit filesChanged(reallyAdded, reallyRemoved);
+ emit fileListChanged();
+}
+
+void DProject::updateCache()
+{
+ DProjectCache::Data data;
+ // called right after the .qcd was written by the project itself
+ m_cache.stampProject(&data);
+ data.buildDirectory = m_buildDir.path();
+ data.libraries = m_libs;
+ data.includes = m_includes;
+ data.extraArgs = m_extraArgs;
+ data.autoDiscover = m_autoDiscover;
+ data.dubPackage = m_dubPackage;
+ data.filesHash = m_filesHash;
+ // discovered files are found again by the scan
+ foreach (const QString &filePath, m_files.files())
+  if (!m_unlisted.contains(filePath))
+   data.files.insert(filePath, m_files.relativePath(filePath));
+ m_cache.save(data);
 }
 
 void DProject::refresh(RefreshOptions options)
 {
-	bool needRebuildTree = parseProject(options);
+ if(m_parseWatcher.isRunning())
+ {
+  // not cancelled: it may be rewriting the keys for a new SourceRoot
+  m_pendingOptions |= options;
+  return;
+ }
+
+ DProjectParseRequest request;
+ request.options = options;
+ request.projectFileName = m_projectFileName;
+ request.projectDirectory = projectDirectory();
+ request.buildDirectory = m_buildDir.path();
+ request.compiler = compilerCommand();
+ request.oldFiles = m_files;
+ request.discovered = m_sourceTree->files();
+ request.filesHash = m_filesHash;
+ request.hadDubFiles = !m_dubFiles.isEmpty();
+ request.filesRevision = m_filesRevision;
+
+ QFuture<DProjectParseResult> future = QtConcurrent::run(&parseProjectHelper, request);
+ m_parseWatcher.setFuture(future);
+ ProgressManager::addTask(future, tr("Parsing %1").arg(m_projectName),
+                          Constants::D_PARSE_TASK_ID);
+}
+
+void DProject::parseFinished()
+{
+ int pending = m_pendingOptions;
+ m_pendingOptions = 0;
+
+ if(m_parseWatcher.isCanceled() || m_parseWatcher.future().resultCount() == 0)
+ {
+  // A SourceRoot rewrite runs to the end even when cancelled; pick up the
+  // directory it left in the cache, so the keys are not rebased twice.
+  DProjectCache::Data cached;
+  if(m_cache.load(&cached))
+  {
+   m_buildDir.setPath(cached.buildDirectory);
+   QWriteLocker lock(&m_filesLock);
+   m_files.setRoot(cached.buildDirectory);
+  }
+  if(pending)
+   refresh(RefreshOptions(pending));
+  return;
+ }
+
+ const DProjectParseResult result = m_parseWatcher.result();
+ if(result.filesRevision != m_filesRevision)
+ {
+  // files were added, removed or discovered while parsing
+  refresh(RefreshOptions(result.options | pending));
+  return;
+ }
 
-	if (needRebuildTree || (options & Files))
-		m_rootNode->refresh(needRebuildTree);
+ int changes = m_configurationLoaded ? 0 : AllChanged;
+ if(result.options & Configuration)
+ {
+  if(result.libraries != m_libs)
+   changes |= LibrariesChanged;
+  if(result.includes != m_includes)
+   changes |= IncludesChanged;
+  if(result.extraArgs != m_extraArgs)
+   changes |= ExtraArgsChanged;
+  if(result.autoDiscover != m_autoDiscover)
+   changes |= AutoDiscoverChanged;
+  m_libs = result.libraries;
+  m_includes = result.includes;
+  m_extraArgs = result.extraArgs;
+  m_autoDiscover = result.autoDiscover;
+  m_configurationLoaded = true;
+ }
+ if(result.buildDirectory != m_buildDir.path())
+  changes |= SourceRootChanged;
+ if(!result.dub.sameBuild(m_dub))
+ {
+  changes |= DubPackageChanged;
+  if(!result.dub.error.isEmpty())
+   MessageManager::write(result.dub.error);
+ }
+ m_dub = result.dub;
+ m_dubPackage = result.dubPackage;
+ if(!m_dubWatcher->files().isEmpty())
+  m_dubWatcher->removePaths(m_dubWatcher->files());
+ foreach(const QString &file, m_dub.watchedFiles)
+  if(QFileInfo(file).exists())
+   m_dubWatcher->addPath(file);
+ m_buildDir.setPath(result.buildDirectory);
+ m_filesHash = result.filesHash;
+
+ if(result.filesChanged)
+ {
+  {
+   QWriteLocker lock(&m_filesLock);
+   m_files = result.files;
+  }
+  m_unlisted = result.unlisted;
+  m_dubFiles = m_dub.sourceFiles().toSet();
+ }
+ if(result.needRebuild)
+  m_rootNode->refresh(true);
+ else if(result.filesChanged)
+  m_rootNode->applyDelta(result.added, result.removed);
+
+ if(changes & (IncludesChanged | SourceRootChanged | DubPackageChanged))
+  registerImports();
+ if(changes)
+  emit configurationChanged(changes);
+ if(result.added.size() || result.removed.size())
+ {
+  emit filesChanged(result.added, result.removed);
+  emit fileListChanged();
+ }
+
+ m_sourceTree->setRoot(m_autoDiscover ? m_buildDir.path() : QString());
+
+ if(pending)
+  refresh(RefreshOptions(pending));
 }
 
 //-------
@@ -283,6 +704,44 @@ bool DProject::fromMap(const QVariantMap &map)
  return true;
 }
 
+//--------------------------------------------------------------------------------------
+//
+// DProjectFileTransaction
+//
+//--------------------------------------------------------------------------------------
+
+void DProjectFileTransaction::addFiles(const QStringList &filePaths)
+{
+ foreach (const QString &filePath, filePaths)
+ {
+  m_removed.remove(filePath);
+  m_added.insert(filePath);
+ }
+}
+
+void DProjectFileTransaction::removeFiles(const QStringList &filePaths)
+{
+ foreach (const QString &filePath, filePaths)
+ {
+  m_added.remove(filePath);
+  m_removed.insert(filePath);
+ }
+}
+
+void DProjectFileTransaction::renameFile(const QString &filePath, const QString &newFilePath)
+{
+ removeFiles(QStringList(filePath));
+ addFiles(QStringList(newFilePath));
+}
+
+bool DProjectFileTransaction::commit()
+{
+ bool ok = m_project->applyFileChanges(m_added, m_removed);
+ m_added.clear();
+ m_removed.clear();
+ return ok;
+}
+
 //--------------------------------------------------------------------------------------
 //
 // DProjectFile
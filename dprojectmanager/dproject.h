@@ -4,6 +4,9 @@
 #include "dprojectmanagerconstants.h"
 #include "dprojectmanager.h"
 #include "dprojectnodes.h"
+#include "dprojectcache.h"
+#include "dpathtable.h"
+#include "ddubpackage.h"
 
 #include <projectexplorer/project.h>
 #include <projectexplorer/projectnodes.h>
@@ -12,13 +15,46 @@
 #include <projectexplorer/buildconfiguration.h>
 #include <coreplugin/idocument.h>
 
-#include <QFuture>
+#include <QFutureWatcher>
+#include <QReadWriteLock>
+#include <QSharedPointer>
 #include <QSet>
 
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+QT_END_NAMESPACE
+
 namespace DProjectManager {
 namespace Internal {
 
 class DProjectFile;
+class DSymbolIndex;
+class DImportGraph;
+class DSourceTree;
+
+/** What a background parse of the .qcd produced, applied by DProject::parseFinished(). */
+struct DProjectParseResult
+{
+ DProjectParseResult()
+  : options(0), autoDiscover(false), needRebuild(false), filesChanged(false), filesRevision(0) {}
+
+ int options;
+ QString buildDirectory;
+ QString libraries;
+ QString includes;
+ QString extraArgs;
+ bool autoDiscover;
+ QString dubPackage;
+ bool needRebuild;
+ bool filesChanged;             ///< false: files, unlisted, added and removed are not set
+ QByteArray filesHash;
+ DPathTable files;              ///< listed and discovered
+ QSet<QString> unlisted;
+ DDubResolution dub;
+ QStringList added;             ///< against the files when the parse started
+ QStringList removed;
+ int filesRevision;
+};
 
 class DProject : public ProjectExplorer::Project
 {
@@ -31,6 +67,16 @@ public:
   Configuration = 0x02,
   Everything    = Files | Configuration
  };
+ enum ConfigurationChange
+ {
+  LibrariesChanged    = 0x01,
+  IncludesChanged     = 0x02,
+  ExtraArgsChanged    = 0x04,
+  SourceRootChanged   = 0x08,
+  AutoDiscoverChanged = 0x10,
+  DubPackageChanged   = 0x20,
+  AllChanged          = 0x3f
+ };
 
 public:
  DProject(Manager *manager, const QString &filename);
@@ -41,7 +87,7 @@ public:
  Core::IDocument *document() const;
  ProjectExplorer::IProjectManager *projectManager() const { return m_manager; }
  DProjectNode *rootProjectNode() const { return m_rootNode; }
-	QStringList files(FilesMode ) const { return m_files.keys(); }
+ QStringList files(FilesMode ) const;
  bool setupTarget(ProjectExplorer::Target *t);
 
  bool addFiles(const QStringList &filePaths);
@@ -50,7 +96,7 @@ public:
 
  void refresh(RefreshOptions options);
 
-	const QHash<QString,QString>& files() { return m_files; }
+ const DPathTable &files() const { return m_files; }
 	const QDir buildDirectory() const { return m_buildDir; }
  const QString& libraries() const { return m_libs; }
 	void setLibraries(QString value) { m_libs = value; }
@@ -58,30 +104,93 @@ public:
 	void setIncludes(QString value) { m_includes = value; }
  const QString& extraArgs() const { return m_extraArgs; }
  void setExtraArgs(QString value) { m_extraArgs = value; }
+ QStringList includeDirectories() const;
+ /** The dub package named by the .qcd, if any, with its dependencies. */
+ const DDubResolution &dubPackage() const { return m_dub; }
+
+ QSharedPointer<DSymbolIndex> symbolIndex() const { return m_symbolIndex; }
+ DImportGraph *importGraph() const { return m_importGraph; }
+
+public slots:
+ void updateSymbolIndex();
+ void updateImportGraph();
+
+private slots:
+ void applyDiscoveredFiles(const QStringList &added, const QStringList &removed);
+ void parseFinished();
+ void dubPackageChanged();
+ void filesSaved(const QStringList &filePaths);
+
+signals:
+ /** Emitted with every change of files(), in addition to fileListChanged(). */
+ void filesChanged(const QStringList &added, const QStringList &removed);
+ /** @a changes is a combination of ConfigurationChange. */
+ void configurationChanged(int changes);
 
 protected:
  QVariantMap toMap() const;
  bool fromMap(const QVariantMap &map);
 
 private:
-	bool parseProject(RefreshOptions options);
+ friend class DProjectFileTransaction;
+
+ void updateCache();
+ void registerImports();
+ QString compilerCommand() const;
+ bool applyFileChanges(const QSet<QString> &added, const QSet<QString> &removed);
  QStringList processEntries(const QStringList &paths,
                             QHash<QString, QString> *map = 0) const;
 
  Manager *m_manager;
  const QString m_projectName;
  const QString m_projectFileName;
+ DProjectCache m_cache;
  DProjectFile* m_projectIDocument;
 	QDir m_buildDir;
 
-	QHash<QString,QString> m_files;
+ DPathTable m_files;
+ mutable QReadWriteLock m_filesLock; ///< m_files changes on the GUI thread, files() is read by the locator too
+ QSet<QString> m_unlisted; ///< found by m_sourceTree or in the dub package, not in [Files]
  QString m_libs;
  QString m_includes;
  QString m_extraArgs;
+ bool m_autoDiscover;
+ bool m_configurationLoaded;
+ QByteArray m_filesHash;  ///< of the [Files] section m_files was read from
+ int m_filesRevision; ///< bumped by every change of m_files outside a parse
+ QString m_dubPackage; ///< as the .qcd names it, kept for the cache
+ DDubResolution m_dub;
+ QSet<QString> m_dubFiles; ///< the dub package's own sources
+ QFileSystemWatcher *m_dubWatcher;
 
 
  DProjectNode *m_rootNode;
-	QFuture<void> m_codeModelFuture;
+ QSharedPointer<DSymbolIndex> m_symbolIndex; ///< shared with the locator threads
+ DImportGraph *m_importGraph;
+ DSourceTree *m_sourceTree;
+ QFutureWatcher<DProjectParseResult> m_parseWatcher;
+ int m_pendingOptions; ///< refreshes requested while parsing
+};
+
+/**
+ * Collects additions, removals and renames of project files. commit() writes
+ * the .qcd once, updates the project in memory and emits a single
+ * filesChanged() instead of reloading the whole project.
+ */
+class DProjectFileTransaction
+{
+public:
+ explicit DProjectFileTransaction(DProject *project) : m_project(project) {}
+
+ void addFiles(const QStringList &filePaths);
+ void removeFiles(const QStringList &filePaths);
+ void renameFile(const QString &filePath, const QString &newFilePath);
+ bool commit();
+
+private:
+ DProject *m_project;
+ QSet<QString> m_added;
+ QSet<QString> m_removed;
 };
 
 class DProjectFile : public Core::IDocument
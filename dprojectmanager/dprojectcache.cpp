@@ -0,0 +1,188 @@
+#include "dprojectcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <string.h>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const quint32 CACHE_MAGIC = 0x43525044; // "DPRC"
+const quint32 CACHE_VERSION = 4;
+const quint32 AUTO_DISCOVER_FLAG = 0x1;
+
+struct Header
+{
+ quint32 magic;
+ quint32 version;
+ qint64 projectSize;
+ qint64 projectMtime;
+ quint32 fileCount;
+ quint32 payloadSize;
+ quint32 checksum;
+ quint32 flags;
+};
+
+// Strings are stored as a quint32 length followed by UTF-16 data, so
+// loading is a copy instead of a decode.
+void appendString(QByteArray *payload, const QString &s)
+{
+ const quint32 length = s.length();
+ payload->append(reinterpret_cast<const char *>(&length), sizeof(length));
+ payload->append(reinterpret_cast<const char *>(s.constData()), length * sizeof(QChar));
+}
+
+bool readString(const uchar *&pos, const uchar *end, QString *s)
+{
+ quint32 length;
+ if (end - pos < qint64(sizeof(length)))
+  return false;
+ memcpy(&length, pos, sizeof(length));
+ pos += sizeof(length);
+ if (quint64(end - pos) < quint64(length) * sizeof(QChar))
+  return false;
+ *s = QString(reinterpret_cast<const QChar *>(pos), length);
+ pos += length * sizeof(QChar);
+ return true;
+}
+
+void stamp(const QString &projectFileName, qint64 *size, qint64 *mtime)
+{
+ const QFileInfo fi(projectFileName);
+ *size = fi.size();
+ *mtime = fi.lastModified().toMSecsSinceEpoch();
+}
+} // namespace
+
+DProjectCache::DProjectCache(const QString &projectFileName)
+ : m_projectFileName(projectFileName)
+{
+ const QString name = QString::fromLatin1(
+    QCryptographicHash::hash(projectFileName.toUtf8(), QCryptographicHash::Sha1).toHex());
+ m_cacheFileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+   + QLatin1String("/dprojects/") + name + QLatin1String(".cache");
+}
+
+/**
+ * Hash of the raw [Files] section of the .qcd, which tells whether the file
+ * list needs to be read again without asking QSettings for every key.
+ */
+QByteArray DProjectCache::filesSectionHash(const QString &projectFileName)
+{
+ QFile file(projectFileName);
+ if (!file.open(QIODevice::ReadOnly))
+  return QByteArray();
+ const QByteArray text = file.readAll();
+
+ int begin = text.startsWith("[Files]") ? 0 : text.indexOf("\n[Files]");
+ if (begin < 0)
+  return QCryptographicHash::hash(QByteArray(), QCryptographicHash::Sha1).toHex();
+ int end = text.indexOf("\n[", begin + 1);
+ if (end < 0)
+  end = text.size();
+ return QCryptographicHash::hash(text.mid(begin, end - begin), QCryptographicHash::Sha1).toHex();
+}
+
+bool DProjectCache::read(Data *data, bool checkStamp) const
+{
+ QFile file(m_cacheFileName);
+ if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header)))
+  return false;
+ const qint64 size = file.size();
+ const uchar *map = file.map(0, size);
+ if (!map)
+  return false;
+
+ bool ok = false;
+ Header header;
+ memcpy(&header, map, sizeof(header));
+ qint64 projectSize, projectMtime;
+ stamp(m_projectFileName, &projectSize, &projectMtime);
+
+ if (header.magic == CACHE_MAGIC && header.version == CACHE_VERSION
+     && (!checkStamp || (header.projectSize == projectSize && header.projectMtime == projectMtime))
+     && qint64(sizeof(Header)) + header.payloadSize == size
+     && header.checksum == qChecksum(reinterpret_cast<const char *>(map + sizeof(Header)),
+                                     header.payloadSize))
+ {
+  const uchar *pos = map + sizeof(Header);
+  const uchar *end = map + size;
+  data->autoDiscover = header.flags & AUTO_DISCOVER_FLAG;
+  data->projectSize = header.projectSize;
+  data->projectMtime = header.projectMtime;
+  QString filesHash;
+  ok = readString(pos, end, &data->buildDirectory)
+    && readString(pos, end, &data->libraries)
+    && readString(pos, end, &data->includes)
+    && readString(pos, end, &data->extraArgs)
+    && readString(pos, end, &data->dubPackage)
+    && readString(pos, end, &filesHash);
+  data->filesHash = filesHash.toLatin1();
+
+  data->files.clear();
+  data->files.reserve(header.fileCount);
+  QString abs, rel;
+  for (quint32 i = 0; ok && i < header.fileCount; ++i)
+  {
+   ok = readString(pos, end, &abs) && readString(pos, end, &rel);
+   if (ok)
+    data->files.insert(abs, rel);
+  }
+  ok = ok && pos == end;
+ }
+
+ file.unmap(const_cast<uchar *>(map));
+ return ok;
+}
+
+void DProjectCache::stampProject(Data *data) const
+{
+ stamp(m_projectFileName, &data->projectSize, &data->projectMtime);
+}
+
+bool DProjectCache::save(const Data &data) const
+{
+ QByteArray payload;
+ appendString(&payload, data.buildDirectory);
+ appendString(&payload, data.libraries);
+ appendString(&payload, data.includes);
+ appendString(&payload, data.extraArgs);
+ appendString(&payload, data.dubPackage);
+ appendString(&payload, QString::fromLatin1(data.filesHash));
+ typedef QHash<QString, QString>::ConstIterator FilesKeyValue;
+ for (FilesKeyValue kv = data.files.constBegin(); kv != data.files.constEnd(); ++kv)
+ {
+  appendString(&payload, kv.key());
+  appendString(&payload, kv.value());
+ }
+
+ Header header;
+ memset(&header, 0, sizeof(header));
+ header.magic = CACHE_MAGIC;
+ header.version = CACHE_VERSION;
+ // a .qcd changed while it was read must not validate what was read before
+ header.projectSize = data.projectSize;
+ header.projectMtime = data.projectMtime;
+ header.fileCount = data.files.size();
+ header.payloadSize = payload.size();
+ header.checksum = qChecksum(payload.constData(), payload.size());
+ header.flags = data.autoDiscover ? AUTO_DISCOVER_FLAG : 0;
+
+ QDir().mkpath(QFileInfo(m_cacheFileName).absolutePath());
+ QSaveFile file(m_cacheFileName);
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+ file.write(payload);
+ return file.commit();
+}
+
+} // namespace Internal
+} // namespace DProjectManager
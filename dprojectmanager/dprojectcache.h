@@ -0,0 +1,58 @@
+#ifndef DPROJECTCACHE_H
+#define DPROJECTCACHE_H
+
+#include <QHash>
+#include <QString>
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Binary copy of what DProject reads from the .qcd file: the configuration
+ * and the resolved [Files] list. It is stamped with the size and mtime the
+ * .qcd had when it was read and ignored when they differ, so the INI stays
+ * the source of truth.
+ */
+class DProjectCache
+{
+public:
+ struct Data
+ {
+  QString buildDirectory;
+  QString libraries;
+  QString includes;
+  QString extraArgs;
+  bool autoDiscover;
+  QString dubPackage;            ///< dub.json or dub.sdl, relative to the .qcd
+  QByteArray filesHash;          ///< of the [Files] section the files were read from
+  QHash<QString, QString> files; ///< absolute path -> path relative to buildDirectory
+  qint64 projectSize;            ///< of the .qcd the data was read from
+  qint64 projectMtime;
+
+  Data() : autoDiscover(false), projectSize(-1), projectMtime(-1) {}
+ };
+
+ explicit DProjectCache(const QString &projectFileName);
+
+ /// Reads the cache with a single mapping of the file; false if missing or stale.
+ bool load(Data *data) const { return read(data, true); }
+ /// Reads the cache even if the .qcd changed since it was written.
+ bool loadStale(Data *data) const { return read(data, false); }
+ /// Writes @a data with the stamp it carries, see stampProject().
+ bool save(const Data &data) const;
+ /// Stamps @a data with the .qcd as it is now; to be called before reading it.
+ void stampProject(Data *data) const;
+
+ static QByteArray filesSectionHash(const QString &projectFileName);
+
+private:
+ bool read(Data *data, bool checkStamp) const;
+
+ const QString m_projectFileName;
+ QString m_cacheFileName;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DPROJECTCACHE_H
@@ -1,8 +1,7 @@
 #include "dprojectmanagerconstants.h"
 #include "dprojectmanager.h"
 #include "dproject.h"
-
-#include "deditor/qcdassist.h"
+#include "dsymbolindex.h"
 
 #include <coreplugin/icore.h>
 #include <projectexplorer/projectexplorer.h>
@@ -33,31 +32,36 @@ ProjectExplorer::Project *Manager::openProject(const QString &fileName, QString
  }
 
  DProject* prj = new DProject(this, fileName);
-
-	QString path = prj->buildDirectory().path();
- QcdAssist::sendAddImportToDCD(path);
-	QDir dir(path);
-	foreach(QString s, prj->includes().split(QLatin1Char(' '), QString::SkipEmptyParts))
-	{
-		if(s.startsWith(QLatin1String("-I")))
-			s = s.remove(0,2);
-		if(QDir::isAbsolutePath(s))
-			QcdAssist::sendAddImportToDCD(path);
-		else
-			QcdAssist::sendAddImportToDCD(dir.absoluteFilePath(s));
-	}
  return prj;
 }
 
 void Manager::registerProject(DProject *project)
 {
+ QMutexLocker lock(&m_projectsMutex);
  m_projects.append(project);
 }
 
 void Manager::unregisterProject(DProject *project)
 {
+ QMutexLocker lock(&m_projectsMutex);
  m_projects.removeAll(project);
 }
 
+QList<QSharedPointer<DSymbolIndex> > Manager::symbolIndexes() const
+{
+ // a project unregisters itself before it goes away, so it is alive while listed
+ QMutexLocker lock(&m_projectsMutex);
+ QList<QSharedPointer<DSymbolIndex> > indexes;
+ foreach (DProject *project, m_projects)
+  indexes.append(project->symbolIndex());
+ return indexes;
+}
+
+void Manager::updateSymbolIndexes()
+{
+ foreach (DProject *project, m_projects)
+  project->updateSymbolIndex();
+}
+
 } // namespace Internal
 } // namespace DProjectManager
@@ -3,10 +3,14 @@
 
 #include <projectexplorer/iprojectmanager.h>
 
+#include <QMutex>
+#include <QSharedPointer>
+
 namespace DProjectManager {
 namespace Internal {
 
 class DProject;
+class DSymbolIndex;
 
 class Manager : public ProjectExplorer::IProjectManager
 {
@@ -20,8 +24,16 @@ public:
 
  void registerProject(DProject *project);
  void unregisterProject(DProject *project);
+ /// The open projects, for the GUI thread only.
+ const QList<DProject *> &projects() const { return m_projects; }
+ /// The symbol indexes of the open projects. Safe to call from a worker thread.
+ QList<QSharedPointer<DSymbolIndex> > symbolIndexes() const;
+
+public slots:
+ void updateSymbolIndexes();
 
 private:
+ mutable QMutex m_projectsMutex; ///< guards m_projects against symbolIndexes()
  QList<DProject *> m_projects;
 };
 
@@ -9,7 +9,27 @@ SOURCES += dprojectmanagerplugin.cpp \
     dprojectwizard.cpp \
     dbuildconfiguration.cpp \
     dmakestep.cpp \
-    drunconfiguration.cpp
+    drunconfiguration.cpp \
+    dsymbolindex.cpp \
+    dlocatorfilter.cpp \
+    dcompilechecker.cpp \
+    dprojectcache.cpp \
+    dsourcetree.cpp \
+    dpathtable.cpp \
+    ddubpackage.cpp \
+    dimportgraph.cpp \
+    dimportgraphview.cpp \
+    dincrementalbuild.cpp \
+    dcompilescheduler.cpp \
+    ddemangler.cpp \
+    dobjectcache.cpp \
+    dbuildprofile.cpp \
+    dbuildprofileview.cpp \
+    dcompilerparser.cpp \
+    dunittestrunner.cpp \
+    dunittestview.cpp \
+    dbenchmark.cpp \
+    dbenchmarkrunconfiguration.cpp
 
 HEADERS += dprojectmanagerplugin.h \
         dprojectmanager_global.h \
@@ -20,7 +40,27 @@ HEADERS += dprojectmanagerplugin.h \
     dprojectwizard.h \
     dbuildconfiguration.h \
     dmakestep.h \
-    drunconfiguration.h
+    drunconfiguration.h \
+    dsymbolindex.h \
+    dlocatorfilter.h \
+    dcompilechecker.h \
+    dprojectcache.h \
+    dsourcetree.h \
+    dpathtable.h \
+    ddubpackage.h \
+    dimportgraph.h \
+    dimportgraphview.h \
+    dincrementalbuild.h \
+    dcompilescheduler.h \
+    ddemangler.h \
+    dobjectcache.h \
+    dbuildprofile.h \
+    dbuildprofileview.h \
+    dcompilerparser.h \
+    dunittestrunner.h \
+    dunittestview.h \
+    dbenchmark.h \
+    dbenchmarkrunconfiguration.h
 
 # Qt Creator linking
 
@@ -44,6 +84,9 @@ PROVIDER = GoldMax
 
 include($$QTCREATOR_SOURCES/src/qtcreatorplugin.pri)
 
+# for the peak working set of benchmarked programs
+win32: LIBS += -lpsapi
+
 RESOURCES += \
     dprojectmanager.qrc
 
@@ -6,6 +6,7 @@ QTC_PLUGIN_DEPENDS += \
     coreplugin \
     projectexplorer \
     qtsupport \
+    locator \
     deditor
 
 QTC_PLUGIN_RECOMMENDS += \
@@ -17,6 +17,11 @@ const char FILES_MIMETYPE[]     = "application/vnd.qtcreator.generic.files";
 
 // Project
 const char DPROJECT_ID[]  = "DProjectManager.DProject";
+const char D_PARSE_TASK_ID[] = "DProjectManager.Task.Parse";
+const char D_BENCHMARK_TASK_ID[] = "DProjectManager.Task.Benchmark";
+const char D_IMPORT_GRAPH_VIEW_ID[] = "DProjectManager.ImportGraph";
+const char D_BUILD_PROFILE_VIEW_ID[] = "DProjectManager.BuildProfile";
+const char D_UNITTEST_VIEW_ID[] = "DProjectManager.Unittests";
 
 const char HIDE_FILE_FILTER_SETTING[] = "DProject/FileFilter";
 const char HIDE_FILE_FILTER_DEFAULT[] = "Makefile*; *.o; *.obj; *~; *.files; *.config; *.creator; *.user; *.includes; *.autosave";
@@ -39,11 +44,19 @@ const char ARGUMENTS_KEY[] = "ProjectExplorer.DRunConfiguration.Arguments";
 const char WORKING_DIRECTORY_KEY[] = "ProjectExplorer.DRunConfiguration.WorkingDirectory";
 const char USE_TERMINAL_KEY[] = "ProjectExplorer.DRunConfiguration.UseTerminal";
 
+const char BENCHMARK_RUN_CONFIG_ID[] = "DProjectManager.DBenchmarkRunConfiguration";
+const char BENCHMARK_ITERATIONS_KEY[] = "DProjectManager.DBenchmarkRunConfiguration.Iterations";
+const char BENCHMARK_WARM_UP_RUNS_KEY[] = "DProjectManager.DBenchmarkRunConfiguration.WarmUpRuns";
+const char BENCHMARK_THRESHOLD_KEY[] = "DProjectManager.DBenchmarkRunConfiguration.Threshold";
+const char BENCHMARK_SAVE_BASELINE_KEY[] = "DProjectManager.DBenchmarkRunConfiguration.SaveBaseline";
+
 // Settings
 const char INI_SOURCE_ROOT_KEY[]   = "SourceRoot";
 const char INI_INCLUDES_KEY[]   = "Includes";
 const char INI_LIBRARIES_KEY[]   = "Libs";
 const char INI_EXTRA_ARGS_KEY[]   = "ExtraArgs";
+const char INI_AUTO_DISCOVER_KEY[]   = "AutoDiscover";
+const char INI_DUB_PACKAGE_KEY[]   = "DubPackage";
 
 //const char INI_MAKE_COMMAND_KEY[]   = "MakeCommand";
 const char INI_BUILD_PRESET_KEY[]   = "BuildPreset";
@@ -52,6 +65,11 @@ const char INI_TARGET_NAME_KEY[]    = "TargetName";
 const char INI_TARGET_DIRNAME_KEY[] = "TargetDirName";
 const char INI_OBJ_DIRNAME_KEY[]    = "ObjDirName";
 const char INI_MAKE_ARGUMENTS_KEY[] = "MakeArguments";
+const char INI_INCREMENTAL_KEY[]    = "IncrementalBuild";
+const char INI_PARALLEL_JOBS_KEY[]  = "ParallelJobs";
+const char INI_STOP_ON_ERROR_KEY[]  = "StopOnError";
+const char INI_OBJECT_CACHE_KEY[]   = "ObjectCache";
+const char INI_PROFILE_BUILD_KEY[]  = "ProfileBuild";
 
 } // namespace DProjectManager
 } // namespace Constants
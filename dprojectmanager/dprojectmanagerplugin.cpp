@@ -7,6 +7,12 @@
 #include "dbuildconfiguration.h"
 #include "dmakestep.h"
 #include "drunconfiguration.h"
+#include "dbenchmarkrunconfiguration.h"
+#include "dlocatorfilter.h"
+#include "dcompilechecker.h"
+#include "dimportgraphview.h"
+#include "dbuildprofileview.h"
+#include "dunittestview.h"
 
 #include <coreplugin/icore.h>
 #include <coreplugin/mimedatabase.h>
@@ -43,6 +49,12 @@ bool DProjectPlugin::initialize(const QStringList &, QString *errorMessage)
  addAutoReleasedObject(new DMakeStepFactory);
  addAutoReleasedObject(new DBuildConfigurationFactory);
  addAutoReleasedObject(new DRunConfigurationFactory);
+ addAutoReleasedObject(new DBenchmarkRunControlFactory);
+ addAutoReleasedObject(new DSymbolLocatorFilter(manager));
+ addAutoReleasedObject(new DCompileChecker);
+ addAutoReleasedObject(new DImportGraphViewFactory);
+ addAutoReleasedObject(new DBuildProfileViewFactory);
+ addAutoReleasedObject(new DUnitTestViewFactory);
 
  return true;
 }
@@ -66,98 +66,118 @@ bool isEmpty(FolderNode* f)
  return f->fileNodes().length() + f->subFolderNodes().length() == 0;
 }
 
+/**
+ * Returns the folder for a path relative to the build directory, creating
+ * the missing ones. New folders are not attached yet: they are collected in
+ * @a newFolders (parents before children) and @a newChildren.
+ */
+FolderNode *DProjectNode::folderFor(const QString &relFolder, QList<FolderNode *> *newFolders,
+                                    FolderChildren *newChildren)
+{
+ if(relFolder.isEmpty())
+  return this;
+ QString absFolderPath = m_project->buildDirectory().path() + QLatin1Char('/') + relFolder;
+ if(FolderNode *folder = m_folders.value(absFolderPath))
+  return folder;
+
+ const int slash = relFolder.lastIndexOf(QLatin1Char('/'));
+ FolderNode *parent = folderFor(slash < 0 ? QString() : relFolder.left(slash), newFolders, newChildren);
+ FolderNode *folder = new FolderNode(absFolderPath);
+ folder->setDisplayName(relFolder.mid(slash + 1));
+ m_folders.insert(absFolderPath, folder);
+ newFolders->append(folder);
+ (*newChildren)[parent].append(folder);
+ return folder;
+}
+
+void DProjectNode::removeEmptyFolders(const QSet<QString> &folderPaths)
+{
+ foreach(const QString &path, folderPaths)
+ {
+  FolderNode *folder = m_folders.value(path);
+  while(folder && folder != this && isEmpty(folder))
+  {
+   FolderNode *parent = folder->parentFolderNode();
+   m_folders.remove(folder->path());
+   removeFolderNodes(QList<FolderNode *>() << folder, parent);
+   folder = parent;
+  }
+ }
+}
+
 void DProjectNode::refresh(bool needRebuild)
 {
 	if(needRebuild)
 	{
 		removeFileNodes(this->fileNodes(), this);
 		removeFolderNodes(this->subFolderNodes(), this);
+		m_folders.clear();
+		m_fileNodes.clear();
 	}
 
- //Core::MessageManager::write(QLatin1String("refresh"));
-	const QHash<QString,QString>& files = m_project->files();
+	const DPathTable& files = m_project->files();
+
+ QStringList added;
+ QStringList removed;
+ typedef QHash<QString, FileNode*>::ConstIterator NodesKeyValue;
+ for (NodesKeyValue kv = m_fileNodes.constBegin(); kv != m_fileNodes.constEnd(); ++kv)
+  if(files.contains(kv.key()) == false)
+   removed.append(kv.key());
+ foreach(const QString &filePath, files.files())
+  if(m_fileNodes.contains(filePath) == false)
+   added.append(filePath);
+ applyDelta(added, removed);
+}
 
- QHash<QString,FileNode*> nodes;
- QStack<FolderNode*> stack;
- stack.push(this);
- while(stack.count() > 0)
+void DProjectNode::applyDelta(const QStringList &added, const QStringList &removed)
+{
+	const DPathTable& files = m_project->files();
+
+ // removing: one removeFileNodes() per folder
+ QHash<FolderNode *, QList<FileNode *> > removedNodes;
+ foreach(const QString &filePath, removed)
  {
-  FolderNode* n = stack.pop();
-  foreach(FileNode* i, n->fileNodes())
-   nodes[i->path()] = i;
-  foreach(FolderNode* i, n->subFolderNodes())
-   stack.push(i);
+  FileNode *node = m_fileNodes.take(filePath);
+  if(node)
+   removedNodes[node->parentFolderNode()].append(node);
  }
-
-		// adding
-	typedef QHash<QString,QString>::ConstIterator FilesKeyValue;
-	for (FilesKeyValue kv = files.constBegin(); kv != files.constEnd(); ++kv)
-	//foreach(QString filePath, files)
+ QSet<QString> emptied;
+ typedef QHash<FolderNode *, QList<FileNode *> >::ConstIterator NodesByFolder;
+ for (NodesByFolder kv = removedNodes.constBegin(); kv != removedNodes.constEnd(); ++kv)
  {
-		if(nodes.contains(kv.key()))
-   continue;
-  FolderNode* folder = this;
-		QStringList parts = kv.value().split(QDir::separator());
-		QString absFolderPath = m_project->buildDirectory().path();
-  parts.pop_back();
-  foreach(QString part, parts)
-  {
-   FolderNode* fn = 0;
-   absFolderPath.append(QDir::separator()).append(part);
-
-   foreach(FolderNode* f, folder->subFolderNodes())
-    if(f->displayName() == part)
-    {
-     fn = f;
-     break;
-    }
-   if(fn == 0)
-   {
-    QList<FolderNode*> list;
-    list.append(fn = new FolderNode(absFolderPath));
-    fn->setDisplayName(part);
-    addFolderNodes(list, folder);
-   }
-   folder = fn;
-  }
-  FileNode* node = 0;
-  foreach(FileNode* n, folder->fileNodes())
-			if(n->path() == kv.key())
-   {
-    node = n;
-    break;
-   }
-  if(node == 0)
-  {
-   QList<FileNode*> list;
-			list.append(new FileNode(kv.key(), SourceType, false));
-   addFileNodes(list, folder);
-  }
+  if(kv.key() != this)
+   emptied.insert(kv.key()->path());
+  removeFileNodes(kv.value(), kv.key());
  }
-
- // removing
- typedef QHash<QString, FileNode*>::Iterator KeyValue;
- for (KeyValue kv = nodes.begin(); kv != nodes.end(); ++kv)
+ removeEmptyFolders(emptied);
+
+ // adding: new subtrees are filled while detached, which emits no model
+ // signals, and then attached with one addFolderNodes() per parent
+ QList<FolderNode *> newFolders;
+ FolderChildren newChildren;
+ QHash<FolderNode *, QList<FileNode *> > addedNodes;
+ foreach(const QString &filePath, added)
  {
-  if(files.contains(kv.key()))
+  const int id = files.id(filePath);
+  if(m_fileNodes.contains(filePath) || id < 0)
    continue;
-  QList<FileNode*> list;
-  list.append(kv.value());
-  FolderNode* parent = kv.value()->parentFolderNode();
-  removeFileNodes(list, parent);
-
-  while(parent != this)
-   if(isEmpty(parent))
-   {
-    FolderNode* p = parent->parentFolderNode();
-    QList<FolderNode*> list;
-    list.append(parent);
-    removeFolderNodes(list, p);
-    parent = p;
-   }
-  else
-    break;
+  const QString rel = files.relativePath(id);
+  const int slash = rel.lastIndexOf(QLatin1Char('/'));
+  FolderNode *folder = folderFor(slash < 0 ? QString() : rel.left(slash),
+                                 &newFolders, &newChildren);
+  FileNode *node = new FileNode(filePath, SourceType, false);
+  m_fileNodes.insert(filePath, node);
+  addedNodes[folder].append(node);
  }
+
+ for (NodesByFolder kv = addedNodes.constBegin(); kv != addedNodes.constEnd(); ++kv)
+  addFileNodes(kv.value(), kv.key());
+ // children come after their parent in newFolders
+ for (int i = newFolders.size() - 1; i >= 0; --i)
+  if(newChildren.contains(newFolders.at(i)))
+   addFolderNodes(newChildren.take(newFolders.at(i)), newFolders.at(i));
+ for (FolderChildren::ConstIterator kv = newChildren.constBegin(); kv != newChildren.constEnd(); ++kv)
+  addFolderNodes(kv.value(), kv.key());
 }
 } // namespace Internal
 } // namespace DProjectManager
@@ -38,10 +38,21 @@ public:
  QList<ProjectExplorer::RunConfiguration *> runConfigurationsFor(Node *node);
 
 	void refresh(bool needRebuild);
+ /** Adds and removes nodes for files already added to or removed from DProject::files(). */
+ void applyDelta(const QStringList &added, const QStringList &removed);
 
 private:
+ typedef QHash<ProjectExplorer::FolderNode *, QList<ProjectExplorer::FolderNode *> > FolderChildren;
+
+ ProjectExplorer::FolderNode *folderFor(const QString &relFolder,
+                                        QList<ProjectExplorer::FolderNode *> *newFolders,
+                                        FolderChildren *newChildren);
+ void removeEmptyFolders(const QSet<QString> &folderPaths);
+
  DProject *m_project;
  Core::IDocument *m_projectFile;
+ QHash<QString, ProjectExplorer::FolderNode *> m_folders;  ///< absolute path -> folder
+ QHash<QString, ProjectExplorer::FileNode *> m_fileNodes;  ///< absolute path -> file
 };
 
 } // namespace Internal
@@ -1,4 +1,5 @@
 #include "drunconfiguration.h"
+#include "dbenchmarkrunconfiguration.h"
 #include "dmakestep.h"
 #include "dprojectnodes.h"
 #include "dprojectmanagerconstants.h"
@@ -320,14 +321,15 @@ bool DRunConfigurationFactory::canCreate(ProjectExplorer::Target *parent,
 {
  if (!canHandle(parent))
   return false;
- return id == Constants::BUILDRUN_CONFIG_ID;
+ return id == Constants::BUILDRUN_CONFIG_ID || id == Constants::BENCHMARK_RUN_CONFIG_ID;
 }
 
 ProjectExplorer::RunConfiguration *
 DRunConfigurationFactory::doCreate(ProjectExplorer::Target *parent, const Core::Id id)
 {
  using namespace ProjectExplorer;
- Q_UNUSED(id);
+ if (id == DProjectManager::Constants::BENCHMARK_RUN_CONFIG_ID)
+  return new DBenchmarkRunConfiguration(parent);
  DRunConfiguration* run = new DRunConfiguration(parent);
  BuildConfiguration* build = parent->activeBuildConfiguration();
  if(build)
@@ -356,7 +358,8 @@ bool DRunConfigurationFactory::canRestore(ProjectExplorer::Target *parent,
 ProjectExplorer::RunConfiguration *
 DRunConfigurationFactory::doRestore(ProjectExplorer::Target *parent, const QVariantMap &map)
 {
- Q_UNUSED(map);
+ if (ProjectExplorer::idFromMap(map) == Constants::BENCHMARK_RUN_CONFIG_ID)
+  return new DBenchmarkRunConfiguration(parent);
  return new DRunConfiguration(parent);
 }
 
@@ -372,6 +375,8 @@ DRunConfigurationFactory::clone(ProjectExplorer::Target *parent,
 {
  if (!canClone(parent, source))
   return 0;
+ if (DBenchmarkRunConfiguration *benchmark = qobject_cast<DBenchmarkRunConfiguration *>(source))
+  return new DBenchmarkRunConfiguration(parent, benchmark);
  return new DRunConfiguration(parent, static_cast<DRunConfiguration*>(source));
 }
 
@@ -384,13 +389,16 @@ QList<Core::Id> DRunConfigurationFactory::availableCreationIds(ProjectExplorer::
 {
  if (!canHandle(parent))
   return QList<Core::Id>();
- return QList<Core::Id>() << Core::Id(Constants::BUILDRUN_CONFIG_ID);
+ return QList<Core::Id>() << Core::Id(Constants::BUILDRUN_CONFIG_ID)
+                          << Core::Id(Constants::BENCHMARK_RUN_CONFIG_ID);
 }
 
 QString DRunConfigurationFactory::displayNameForId(const Core::Id id) const
 {
  if (id == Constants::BUILDRUN_CONFIG_ID)
   return tr("Build Run");
+ if (id == Constants::BENCHMARK_RUN_CONFIG_ID)
+  return tr("Benchmark Run");
  return QString();
 }
 
@@ -0,0 +1,276 @@
+#include "dsourcetree.h"
+#include "dprojectmanagerconstants.h"
+
+#include <coreplugin/icore.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSettings>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+QStringList filterList(const char *key, const char *defaultValue)
+{
+ const QString value = Core::ICore::settings()->value(QLatin1String(key),
+                                                      QLatin1String(defaultValue)).toString();
+ QStringList filters;
+ foreach (const QString &filter, value.split(QLatin1Char(';'), QString::SkipEmptyParts))
+  if (!filter.trimmed().isEmpty())
+   filters.append(filter.trimmed());
+ return filters;
+}
+
+struct Listing
+{
+ QStringList files;
+ QStringList dirs;
+};
+
+class ListDirectory
+{
+public:
+ typedef Listing result_type;
+
+ ListDirectory(const QStringList &showFilters, const QStringList &hideFilters)
+  : m_showFilters(showFilters), m_hideFilters(hideFilters)
+ {}
+
+ Listing operator()(const QString &path) const
+ {
+  Listing listing;
+  const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+  foreach (const QFileInfo &fi, entries)
+  {
+   const QString name = fi.fileName();
+   if (QDir::match(m_hideFilters, name))
+    continue;
+   if (fi.isDir())
+   {
+    // hidden and linked directories are skipped, the latter to avoid cycles
+    if (!name.startsWith(QLatin1Char('.')) && !fi.isSymLink())
+     listing.dirs.append(fi.absoluteFilePath());
+   }
+   else if (QDir::match(m_showFilters, name))
+    listing.files.append(fi.absoluteFilePath());
+  }
+  return listing;
+ }
+
+private:
+ QStringList m_showFilters;
+ QStringList m_hideFilters;
+};
+} // namespace
+
+DSourceTree::DSourceTree(QObject *parent)
+ : QObject(parent),
+   m_watcher(new QFileSystemWatcher(this))
+{
+ connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+ connect(&m_scan, SIGNAL(finished()), this, SLOT(scanFinished()));
+}
+
+DSourceTree::~DSourceTree()
+{
+ m_scan.waitForFinished();
+}
+
+DSourceTree::ScanResult DSourceTree::scan(const QString &root, const QStringList &showFilters,
+                                          const QStringList &hideFilters)
+{
+ return scanDirectories(root, QStringList(root), showFilters, hideFilters);
+}
+
+DSourceTree::ScanResult DSourceTree::scanDirectories(const QString &root, const QStringList &dirs,
+                                                     const QStringList &showFilters,
+                                                     const QStringList &hideFilters)
+{
+ ScanResult result;
+ result.root = root;
+ QStringList level(dirs);
+ while (!level.isEmpty())
+ {
+  result.dirs += level;
+  const QList<Listing> listings =
+    QtConcurrent::blockingMapped(level, ListDirectory(showFilters, hideFilters));
+  level.clear();
+  foreach (const Listing &listing, listings)
+  {
+   result.files += listing.files;
+   level += listing.dirs;
+  }
+ }
+ return result;
+}
+
+void DSourceTree::setRoot(const QString &root)
+{
+ if (root == m_root)
+  return;
+
+ const QStringList removed = files();
+ if (!m_tree.isEmpty())
+  m_watcher->removePaths(m_tree.keys());
+ m_tree.clear();
+ m_scanning.clear();
+ m_queued.clear();
+ m_root = root;
+ if (!removed.isEmpty())
+  emit filesChanged(QStringList(), removed);
+
+ if (m_root.isEmpty())
+  return;
+ m_showFilters = filterList(Constants::SHOW_FILE_FILTER_SETTING, Constants::SHOW_FILE_FILTER_DEFAULT);
+ m_hideFilters = filterList(Constants::HIDE_FILE_FILTER_SETTING, Constants::HIDE_FILE_FILTER_DEFAULT);
+ m_scan.setFuture(QtConcurrent::run(&DSourceTree::scan, m_root, m_showFilters, m_hideFilters));
+}
+
+QStringList DSourceTree::files() const
+{
+ QStringList files;
+ foreach (const Directory &dir, m_tree)
+  files += dir.files.toList();
+ return files;
+}
+
+void DSourceTree::scanFinished()
+{
+ const ScanResult result = m_scan.result();
+ // a scan of a previous root
+ if (result.root != m_root)
+  return;
+
+ QStringList added;
+ // the walk of the whole root, or of new subdirectories
+ if (!result.dirs.isEmpty() && result.dirs.first() == result.root)
+  addScanned(result, &added);
+ else
+ {
+  // keep the trees of the new directories that neither they nor their parents left meanwhile
+  QStringList wanted;
+  foreach (const QString &dir, m_scanning)
+   if (m_tree.contains(QFileInfo(dir).path()))
+    wanted.append(dir + QLatin1Char('/'));
+  ScanResult kept;
+  kept.root = result.root;
+  foreach (const QString &dir, result.dirs)
+  {
+   const QString prefix = dir + QLatin1Char('/');
+   foreach (const QString &top, wanted)
+    if (prefix.startsWith(top))
+    {
+     kept.dirs.append(dir);
+     break;
+    }
+  }
+  foreach (const QString &file, result.files)
+   foreach (const QString &top, wanted)
+    if (file.startsWith(top))
+    {
+     kept.files.append(file);
+     break;
+    }
+  m_scanning.clear();
+  addScanned(kept, &added);
+ }
+ if (!added.isEmpty())
+  emit filesChanged(added, QStringList());
+ scanNewDirectories();
+}
+
+void DSourceTree::scanNewDirectories()
+{
+ if (m_scan.isRunning() || m_queued.isEmpty())
+  return;
+ m_scanning = m_queued;
+ m_queued.clear();
+ m_scan.setFuture(QtConcurrent::run(&DSourceTree::scanDirectories, m_root, m_scanning.toList(),
+                                    m_showFilters, m_hideFilters));
+}
+
+void DSourceTree::addScanned(const ScanResult &result, QStringList *added)
+{
+ // dirs are listed parents first
+ foreach (const QString &path, result.dirs)
+ {
+  m_tree.insert(path, Directory());
+  const QString parent = QFileInfo(path).path();
+  if (path != m_root && m_tree.contains(parent))
+   m_tree[parent].dirs.insert(path);
+ }
+ foreach (const QString &file, result.files)
+ {
+  Directory &dir = m_tree[QFileInfo(file).path()];
+  if (!dir.files.contains(file))
+  {
+   dir.files.insert(file);
+   added->append(file);
+  }
+ }
+ m_watcher->addPaths(result.dirs);
+}
+
+void DSourceTree::removeDirectory(const QString &path, QStringList *removed)
+{
+ const Directory dir = m_tree.take(path);
+ *removed += dir.files.toList();
+ foreach (const QString &sub, dir.dirs)
+  removeDirectory(sub, removed);
+ m_watcher->removePath(path);
+}
+
+void DSourceTree::directoryChanged(const QString &path)
+{
+ if (!m_tree.contains(path))
+  return;
+
+ QStringList added;
+ QStringList removed;
+ if (!QFileInfo(path).isDir())
+ {
+  const QString parent = QFileInfo(path).path();
+  if (m_tree.contains(parent))
+   m_tree[parent].dirs.remove(path);
+  removeDirectory(path, &removed);
+ }
+ else
+ {
+  const Listing listing = ListDirectory(m_showFilters, m_hideFilters)(path);
+  const Directory old = m_tree.value(path);
+  const QSet<QString> files = listing.files.toSet();
+  const QSet<QString> dirs = listing.dirs.toSet();
+
+  added += (files - old.files).toList();
+  removed += (old.files - files).toList();
+  m_tree[path].files = files;
+
+  foreach (const QString &sub, old.dirs - dirs)
+  {
+   m_tree[path].dirs.remove(sub);
+   removeDirectory(sub, &removed);
+  }
+  // subdirectories still waiting for their walk are forgotten when they go away
+  foreach (const QString &sub, m_queued + m_scanning)
+   if (QFileInfo(sub).path() == path && !dirs.contains(sub))
+   {
+    m_queued.remove(sub);
+    m_scanning.remove(sub);
+   }
+  // a new subdirectory may hold a whole tree, which is walked off the GUI thread
+  foreach (const QString &sub, dirs - old.dirs)
+   if (!m_scanning.contains(sub))
+    m_queued.insert(sub);
+  scanNewDirectories();
+ }
+
+ if (!added.isEmpty() || !removed.isEmpty())
+  emit filesChanged(added, removed);
+}
+
+} // namespace Internal
+} // namespace DProjectManager
@@ -0,0 +1,81 @@
+#ifndef DSOURCETREE_H
+#define DSOURCETREE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+QT_END_NAMESPACE
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * Source files found under a root directory with the project file filters.
+ * The first scan walks the tree in parallel, one directory level at a time;
+ * afterwards a QFileSystemWatcher reports changed directories and only those
+ * are listed again, so changes arrive as add/remove deltas. New subdirectories
+ * are walked in the background like the root.
+ */
+class DSourceTree : public QObject
+{
+ Q_OBJECT
+
+public:
+ struct ScanResult
+ {
+  QString root;
+  QStringList files;
+  QStringList dirs;
+ };
+
+ explicit DSourceTree(QObject *parent = 0);
+ ~DSourceTree();
+
+ /// Rescans and watches @a root; an empty root drops everything.
+ void setRoot(const QString &root);
+ const QString &root() const { return m_root; }
+ QStringList files() const;
+
+ static ScanResult scan(const QString &root, const QStringList &showFilters,
+                        const QStringList &hideFilters);
+ /// Walks @a dirs, which lie under @a root.
+ static ScanResult scanDirectories(const QString &root, const QStringList &dirs,
+                                   const QStringList &showFilters, const QStringList &hideFilters);
+
+signals:
+ void filesChanged(const QStringList &added, const QStringList &removed);
+
+private slots:
+ void scanFinished();
+ void directoryChanged(const QString &path);
+
+private:
+ struct Directory
+ {
+  QSet<QString> files;
+  QSet<QString> dirs;
+ };
+
+ void addScanned(const ScanResult &result, QStringList *added);
+ void removeDirectory(const QString &path, QStringList *removed);
+ void scanNewDirectories();
+
+ QString m_root;
+ QStringList m_showFilters;
+ QStringList m_hideFilters;
+ QHash<QString, Directory> m_tree;
+ QFileSystemWatcher *m_watcher;
+ QFutureWatcher<ScanResult> m_scan;
+ QSet<QString> m_scanning; ///< new directories the running scan walks
+ QSet<QString> m_queued;   ///< new directories found while a scan runs
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DSOURCETREE_H
@@ -0,0 +1,561 @@
+#include "dsymbolindex.h"
+
+#include "deditor/dsourcescanner.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+
+using namespace DEditor;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const quint32 INDEX_MAGIC = 0x49595344; // "DSYI"
+const quint32 INDEX_VERSION = 1;
+
+struct Header
+{
+ quint32 magic;
+ quint32 version;
+ quint32 symbolCount;
+ quint32 fileCount;
+ quint32 entriesOffset;
+ quint32 filesOffset;
+ quint32 stringsOffset;
+ quint32 stringsSize;
+};
+
+struct Entry
+{
+ quint32 keyOffset;
+ quint32 nameOffset;
+ quint32 fileIndex;
+ quint32 line;
+ quint16 keyLength;
+ quint16 nameLength;
+ quint32 kind;
+};
+
+struct FileRecord
+{
+ quint32 pathOffset;
+ quint32 pathLength;
+ qint64 mtime;
+};
+
+/**
+ * Whether a table can be read without going out of bounds: the sections lie
+ * where writeTable() puts them and every offset, length and file index of the
+ * records points into the table. A truncated or corrupt cache fails this.
+ */
+bool isValidTable(const uchar *data, qint64 size)
+{
+ if (size < qint64(sizeof(Header)))
+  return false;
+ const Header *header = reinterpret_cast<const Header *>(data);
+ if (header->magic != INDEX_MAGIC || header->version != INDEX_VERSION)
+  return false;
+ const qint64 filesOffset = qint64(sizeof(Header)) + qint64(header->symbolCount) * qint64(sizeof(Entry));
+ const qint64 stringsOffset = filesOffset + qint64(header->fileCount) * qint64(sizeof(FileRecord));
+ if (header->entriesOffset != sizeof(Header) || header->filesOffset != filesOffset
+     || header->stringsOffset != stringsOffset || stringsOffset + header->stringsSize != size)
+  return false;
+
+ const qint64 stringsSize = header->stringsSize;
+ const FileRecord *files = reinterpret_cast<const FileRecord *>(data + header->filesOffset);
+ for (quint32 i = 0; i < header->fileCount; ++i)
+  if (qint64(files[i].pathOffset) + files[i].pathLength > stringsSize)
+   return false;
+ const Entry *entries = reinterpret_cast<const Entry *>(data + header->entriesOffset);
+ for (quint32 i = 0; i < header->symbolCount; ++i)
+ {
+  const Entry &e = entries[i];
+  if (e.fileIndex >= header->fileCount || e.kind > quint32(DSymbol::Alias)
+      || qint64(e.keyOffset) + e.keyLength > stringsSize
+      || qint64(e.nameOffset) + e.nameLength > stringsSize)
+   return false;
+ }
+ return true;
+}
+
+// Words that may be followed by '(' but never name a declaration.
+bool isNonDeclaringKeyword(const QStringRef &word)
+{
+ static QSet<QString> keywords;
+ if (keywords.isEmpty())
+ {
+  const char *list[] = {
+   "if", "else", "while", "for", "foreach", "foreach_reverse", "do", "switch", "case",
+   "catch", "with", "return", "assert", "cast", "typeof", "typeid", "mixin", "is",
+   "version", "debug", "static", "this", "super", "new", "delete", "throw", "scope",
+   "synchronized", "pragma", "align", "extern", "in", "out", "body", "import",
+   "__traits", "__vector", "const", "immutable", "shared", "inout", "ref", "auto",
+   "invariant", "unittest", "deprecated", "package", "private", "protected", "public",
+   "export", "lazy", "function", "delegate", 0
+  };
+  for (int i = 0; list[i]; ++i)
+   keywords.insert(QLatin1String(list[i]));
+ }
+ return keywords.contains(word.toString());
+}
+
+DSymbol::Kind aggregateKind(const QStringRef &word, bool *ok)
+{
+ *ok = true;
+ if (word == QLatin1String("class")) return DSymbol::Class;
+ if (word == QLatin1String("struct")) return DSymbol::Struct;
+ if (word == QLatin1String("interface")) return DSymbol::Interface;
+ if (word == QLatin1String("union")) return DSymbol::Union;
+ if (word == QLatin1String("enum")) return DSymbol::Enum;
+ if (word == QLatin1String("template")) return DSymbol::Template;
+ if (word == QLatin1String("alias")) return DSymbol::Alias;
+ *ok = false;
+ return DSymbol::Function;
+}
+
+bool isReturnTypeAttribute(const QStringRef &word)
+{
+ return word == QLatin1String("auto") || word == QLatin1String("static")
+   || word == QLatin1String("ref") || word == QLatin1String("const")
+   || word == QLatin1String("immutable") || word == QLatin1String("shared")
+   || word == QLatin1String("inout");
+}
+
+bool opensBody(const QStringRef &word)
+{
+ return word == QLatin1String("this") || word == QLatin1String("unittest")
+   || word == QLatin1String("invariant") || word == QLatin1String("in")
+   || word == QLatin1String("out") || word == QLatin1String("body")
+   || word == QLatin1String("do");
+}
+
+bool followedByParenthesis(const QString &text, const DSourceScanner::Token &tk)
+{
+ int i = tk.begin + tk.length;
+ while (i < text.length() && text.at(i).isSpace())
+  ++i;
+ return i < text.length() && text.at(i) == QLatin1Char('(');
+}
+
+struct PendingEntry
+{
+ QByteArray key;
+ quint32 keyOffset;
+ quint32 nameOffset;
+ quint32 fileIndex;
+ quint32 line;
+ quint16 nameLength;
+ quint32 kind;
+};
+
+bool pendingLess(const PendingEntry &a, const PendingEntry &b)
+{
+ const int n = qMin(a.key.size(), b.key.size());
+ const int c = memcmp(a.key.constData(), b.key.constData(), n);
+ return c < 0 || (c == 0 && a.key.size() < b.key.size());
+}
+
+struct ScanFile
+{
+ typedef QPair<QString, QList<DSymbol> > result_type;
+
+ result_type operator()(const QString &fileName) const
+ {
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+   return result_type(fileName, QList<DSymbol>());
+  const QByteArray data = file.readAll();
+  return result_type(fileName, DSymbolIndex::scanSymbols(QString::fromUtf8(data.constData(), data.size())));
+ }
+};
+} // namespace
+
+DSymbolIndex::DSymbolIndex(const QString &indexFileName, QObject *parent)
+ : QObject(parent),
+   m_indexFileName(indexFileName),
+   m_data(0),
+   m_size(0),
+   m_pending(false)
+{
+ if (mapTable())
+  loadFromTable();
+ connect(&m_update, SIGNAL(finished()), this, SLOT(updateFinished()));
+}
+
+DSymbolIndex::~DSymbolIndex()
+{
+ m_update.waitForFinished();
+ unmapTable();
+}
+
+/**
+ * Extracts aggregate, enum, template, alias and function declarations.
+ * Function bodies are skipped, so locals and nested functions are not indexed.
+ */
+QList<DSymbol> DSymbolIndex::scanSymbols(const QString &text)
+{
+ QList<DSymbol> symbols;
+ DSourceScanner scanner(text);
+
+ int braceDepth = 0;
+ int parenDepth = 0;
+ int bodyDepth = -1;        // brace depth of the function body we are in
+ bool pendingFunction = false;
+ bool expectName = false;
+ DSymbol::Kind expectedKind = DSymbol::Function;
+ DSourceScanner::Token previous;
+
+ for (DSourceScanner::Token tk = scanner.next(); !tk.is(DSourceScanner::EndOfFile);
+      previous = tk, tk = scanner.next())
+ {
+  if (tk.is(DSourceScanner::Punctuation))
+  {
+   const QChar ch = scanner.punctuation(tk);
+   if (ch == QLatin1Char('('))
+    ++parenDepth;
+   else if (ch == QLatin1Char(')'))
+    parenDepth = qMax(0, parenDepth - 1);
+   else if (ch == QLatin1Char('{'))
+   {
+    if (pendingFunction && parenDepth == 0 && bodyDepth == -1)
+     bodyDepth = braceDepth;
+    pendingFunction = false;
+    ++braceDepth;
+   }
+   else if (ch == QLatin1Char('}'))
+   {
+    braceDepth = qMax(0, braceDepth - 1);
+    if (braceDepth == bodyDepth)
+     bodyDepth = -1;
+   }
+   else if (ch == QLatin1Char(';') && parenDepth == 0)
+    pendingFunction = false;
+   expectName = false;
+   continue;
+  }
+  if (!tk.is(DSourceScanner::Identifier) || bodyDepth != -1 || parenDepth > 0)
+   continue;
+
+  const QStringRef word = scanner.text(tk);
+  if (expectName)
+  {
+   expectName = false;
+   symbols.append(DSymbol(word.toString(), expectedKind, tk.line));
+   continue;
+  }
+  bool isAggregate = false;
+  expectedKind = aggregateKind(word, &isAggregate);
+  if (isAggregate)
+  {
+   expectName = true;
+   continue;
+  }
+  // constructors, contracts and unittest blocks own a body but declare nothing
+  if (opensBody(word))
+  {
+   pendingFunction = true;
+   continue;
+  }
+
+  // <type> name ( ...
+  if (isNonDeclaringKeyword(word) || !followedByParenthesis(text, tk))
+   continue;
+  if (previous.is(DSourceScanner::Identifier))
+  {
+   if (isNonDeclaringKeyword(scanner.text(previous)) && !isReturnTypeAttribute(scanner.text(previous)))
+    continue;
+  }
+  else if (!previous.is(DSourceScanner::Punctuation)
+           || (scanner.punctuation(previous) != QLatin1Char(')')
+               && scanner.punctuation(previous) != QLatin1Char(']')
+               && scanner.punctuation(previous) != QLatin1Char('*')))
+   continue;
+
+  symbols.append(DSymbol(word.toString(), DSymbol::Function, tk.line));
+  pendingFunction = true;
+ }
+ return symbols;
+}
+
+QList<DSymbolLocation> DSymbolIndex::find(const QString &prefix, int limit) const
+{
+ QList<DSymbolLocation> result;
+ const QByteArray key = prefix.toLower().toUtf8();
+
+ QMutexLocker lock(&m_tableMutex);
+ if (!m_data || key.isEmpty())
+  return result;
+
+ const Header *header = reinterpret_cast<const Header *>(m_data);
+ const Entry *entries = reinterpret_cast<const Entry *>(m_data + header->entriesOffset);
+ const FileRecord *files = reinterpret_cast<const FileRecord *>(m_data + header->filesOffset);
+ const uchar *strings = m_data + header->stringsOffset;
+
+ // lower bound of the prefix
+ quint32 lo = 0, hi = header->symbolCount;
+ while (lo < hi)
+ {
+  const quint32 mid = (lo + hi) / 2;
+  const Entry &e = entries[mid];
+  const int n = qMin<int>(e.keyLength, key.size());
+  const int c = memcmp(strings + e.keyOffset, key.constData(), n);
+  if (c < 0 || (c == 0 && e.keyLength < key.size()))
+   lo = mid + 1;
+  else
+   hi = mid;
+ }
+
+ for (quint32 i = lo; i < header->symbolCount && result.size() < limit; ++i)
+ {
+  const Entry &e = entries[i];
+  if (e.keyLength < key.size() || memcmp(strings + e.keyOffset, key.constData(), key.size()) != 0)
+   break;
+  const FileRecord &f = files[e.fileIndex];
+  DSymbolLocation loc;
+  loc.name = QString::fromUtf8(reinterpret_cast<const char *>(strings + e.nameOffset), e.nameLength);
+  loc.fileName = QString::fromUtf8(reinterpret_cast<const char *>(strings + f.pathOffset), f.pathLength);
+  loc.kind = DSymbol::Kind(e.kind);
+  loc.line = e.line;
+  result.append(loc);
+ }
+ return result;
+}
+
+void DSymbolIndex::scheduleUpdate(const QStringList &files, const QStringList &includeDirs,
+                                  const QStringList &savedFiles)
+{
+ if (m_update.isRunning())
+ {
+  // the latest lists win, saved files add up
+  m_pending = true;
+  m_pendingFiles = files;
+  m_pendingIncludeDirs = includeDirs;
+  m_pendingSavedFiles += savedFiles;
+  return;
+ }
+ m_update.setFuture(QtConcurrent::run(this, &DSymbolIndex::update, files, includeDirs, savedFiles));
+}
+
+void DSymbolIndex::updateFinished()
+{
+ if (m_pending)
+ {
+  m_pending = false;
+  const QStringList savedFiles = m_pendingSavedFiles;
+  m_pendingSavedFiles.clear();
+  scheduleUpdate(m_pendingFiles, m_pendingIncludeDirs, savedFiles);
+  m_pendingFiles.clear();
+  m_pendingIncludeDirs.clear();
+ }
+}
+
+void DSymbolIndex::update(const QStringList &projectFiles, const QStringList &includeDirs,
+                          const QStringList &savedFiles)
+{
+ QMutexLocker lock(&m_updateMutex);
+
+ static QLatin1String dotd(".d");
+ static QLatin1String dotdi(".di");
+
+ QStringList files;
+ foreach (const QString &file, projectFiles)
+  if (file.endsWith(dotd) || file.endsWith(dotdi))
+   files.append(file);
+ foreach (const QString &dir, includeDirs)
+ {
+  QDirIterator it(dir, QStringList() << QLatin1String("*.d") << QLatin1String("*.di"),
+                  QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext())
+   files.append(it.next());
+ }
+
+ // find what changed since the last update
+ // a file saved twice within the file system's time resolution keeps its time
+ const QSet<QString> saved = savedFiles.toSet();
+ QHash<QString, FileSymbols> current;
+ QStringList changed;
+ foreach (const QString &file, files)
+ {
+  if (current.contains(file))
+   continue;
+  const qint64 mtime = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+  QHash<QString, FileSymbols>::const_iterator old = m_files.constFind(file);
+  if (old != m_files.constEnd() && old->mtime == mtime && !saved.contains(file))
+   current.insert(file, *old);
+  else
+  {
+   FileSymbols fs;
+   fs.mtime = mtime;
+   current.insert(file, fs);
+   changed.append(file);
+  }
+ }
+ if (changed.isEmpty() && current.size() == m_files.size())
+  return;
+
+ const QList<QPair<QString, QList<DSymbol> > > scanned = QtConcurrent::blockingMapped(changed, ScanFile());
+ for (int i = 0; i < scanned.size(); ++i)
+  current[scanned.at(i).first].symbols = scanned.at(i).second;
+
+ m_files = current;
+ if (writeTable(m_files))
+  mapTable();
+}
+
+bool DSymbolIndex::writeTable(const QHash<QString, FileSymbols> &files)
+{
+ QByteArray strings;
+ QVector<FileRecord> fileRecords;
+ QVector<PendingEntry> pending;
+ fileRecords.reserve(files.size());
+
+ typedef QHash<QString, FileSymbols>::ConstIterator FilesKeyValue;
+ for (FilesKeyValue kv = files.constBegin(); kv != files.constEnd(); ++kv)
+ {
+  const QByteArray path = kv.key().toUtf8();
+  FileRecord fr;
+  fr.pathOffset = strings.size();
+  fr.pathLength = path.size();
+  fr.mtime = kv.value().mtime;
+  strings.append(path);
+  const quint32 fileIndex = fileRecords.size();
+  fileRecords.append(fr);
+
+  foreach (const DSymbol &s, kv.value().symbols)
+  {
+   const QByteArray name = s.name.toUtf8();
+   PendingEntry p;
+   p.key = s.name.toLower().toUtf8();
+   p.nameOffset = strings.size();
+   p.nameLength = name.size();
+   strings.append(name);
+   if (p.key == name)
+    p.keyOffset = p.nameOffset;
+   else
+   {
+    p.keyOffset = strings.size();
+    strings.append(p.key);
+   }
+   p.fileIndex = fileIndex;
+   p.line = s.line;
+   p.kind = s.kind;
+   pending.append(p);
+  }
+ }
+
+ std::sort(pending.begin(), pending.end(), pendingLess);
+
+ Header header;
+ header.magic = INDEX_MAGIC;
+ header.version = INDEX_VERSION;
+ header.symbolCount = pending.size();
+ header.fileCount = fileRecords.size();
+ header.entriesOffset = sizeof(Header);
+ header.filesOffset = header.entriesOffset + pending.size() * sizeof(Entry);
+ header.stringsOffset = header.filesOffset + fileRecords.size() * sizeof(FileRecord);
+ header.stringsSize = strings.size();
+
+ QByteArray data;
+ data.reserve(header.stringsOffset + strings.size());
+ data.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+ foreach (const PendingEntry &p, pending)
+ {
+  Entry e;
+  e.keyOffset = p.keyOffset;
+  e.nameOffset = p.nameOffset;
+  e.fileIndex = p.fileIndex;
+  e.line = p.line;
+  e.keyLength = p.key.size();
+  e.nameLength = p.nameLength;
+  e.kind = p.kind;
+  data.append(reinterpret_cast<const char *>(&e), sizeof(Entry));
+ }
+ data.append(reinterpret_cast<const char *>(fileRecords.constData()), fileRecords.size() * sizeof(FileRecord));
+ data.append(strings);
+
+ // Write next to the table and rename, so a mapped table is never rewritten in place.
+ QDir().mkpath(QFileInfo(m_indexFileName).absolutePath());
+ const QString tmpName = m_indexFileName + QLatin1String(".tmp");
+ QFile tmp(tmpName);
+ if (!tmp.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  return false;
+ if (tmp.write(data) != data.size())
+ {
+  tmp.remove();
+  return false;
+ }
+ tmp.close();
+
+ QMutexLocker lock(&m_tableMutex);
+ unmapTable();
+ QFile::remove(m_indexFileName);
+ return QFile::rename(tmpName, m_indexFileName);
+}
+
+bool DSymbolIndex::mapTable()
+{
+ QMutexLocker lock(&m_tableMutex);
+ unmapTable();
+ m_table.setFileName(m_indexFileName);
+ if (!m_table.open(QIODevice::ReadOnly))
+  return false;
+ m_size = m_table.size();
+ if (m_size < qint64(sizeof(Header)))
+ {
+  m_table.close();
+  return false;
+ }
+ m_data = m_table.map(0, m_size);
+ if (!m_data || !isValidTable(m_data, m_size))
+ {
+  unmapTable();
+  return false;
+ }
+ return true;
+}
+
+void DSymbolIndex::unmapTable()
+{
+ if (m_data)
+  m_table.unmap(const_cast<uchar *>(m_data));
+ m_data = 0;
+ m_size = 0;
+ if (m_table.isOpen())
+  m_table.close();
+}
+
+void DSymbolIndex::loadFromTable()
+{
+ QMutexLocker lock(&m_tableMutex);
+ if (!m_data)
+  return;
+ const Header *header = reinterpret_cast<const Header *>(m_data);
+ const Entry *entries = reinterpret_cast<const Entry *>(m_data + header->entriesOffset);
+ const FileRecord *files = reinterpret_cast<const FileRecord *>(m_data + header->filesOffset);
+ const char *strings = reinterpret_cast<const char *>(m_data + header->stringsOffset);
+
+ QVector<QString> paths(header->fileCount);
+ for (quint32 i = 0; i < header->fileCount; ++i)
+ {
+  paths[i] = QString::fromUtf8(strings + files[i].pathOffset, files[i].pathLength);
+  m_files[paths[i]].mtime = files[i].mtime;
+ }
+ for (quint32 i = 0; i < header->symbolCount; ++i)
+ {
+  const Entry &e = entries[i];
+  m_files[paths[e.fileIndex]].symbols.append(
+     DSymbol(QString::fromUtf8(strings + e.nameOffset, e.nameLength), DSymbol::Kind(e.kind), e.line));
+ }
+}
+
+} // namespace Internal
+} // namespace DProjectManager
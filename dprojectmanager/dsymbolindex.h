@@ -0,0 +1,114 @@
+#ifndef DSYMBOLINDEX_H
+#define DSYMBOLINDEX_H
+
+#include <QObject>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMetaType>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+
+namespace DProjectManager {
+namespace Internal {
+
+struct DSymbol
+{
+ enum Kind
+ {
+  Function,
+  Class,
+  Struct,
+  Interface,
+  Union,
+  Enum,
+  Template,
+  Alias
+ };
+
+ DSymbol() : kind(Function), line(0) {}
+ DSymbol(const QString &n, Kind k, int l) : name(n), kind(k), line(l) {}
+
+ QString name;
+ Kind kind;
+ int line;
+};
+
+struct DSymbolLocation
+{
+ DSymbolLocation() : kind(DSymbol::Function), line(0) {}
+
+ QString name;
+ QString fileName;
+ DSymbol::Kind kind;
+ int line;
+};
+
+/**
+ * Symbol index for the locator. The searchable table is a file of fixed size
+ * records sorted by lower-cased name, with a string pool and a file table,
+ * which is memory-mapped; a lookup is a binary search for the prefix range.
+ * The per-file symbol lists and modification times are rebuilt from the
+ * table when it is mapped, so later updates only rescan changed files.
+ */
+class DSymbolIndex : public QObject
+{
+ Q_OBJECT
+
+public:
+ DSymbolIndex(const QString &indexFileName, QObject *parent = 0);
+ ~DSymbolIndex();
+
+ static QList<DSymbol> scanSymbols(const QString &text);
+
+ QList<DSymbolLocation> find(const QString &prefix, int limit) const;
+
+ /**
+  * Rescans changed files and rewrites the table. A file is changed if its
+  * modification time differs or it is in @a savedFiles. Safe to call from a
+  * worker thread.
+  */
+ void update(const QStringList &files, const QStringList &includeDirs,
+             const QStringList &savedFiles = QStringList());
+ /// Runs update() in the background, after the running one if there is one.
+ void scheduleUpdate(const QStringList &files, const QStringList &includeDirs,
+                     const QStringList &savedFiles = QStringList());
+
+private slots:
+ void updateFinished();
+
+private:
+ struct FileSymbols
+ {
+  FileSymbols() : mtime(0) {}
+  qint64 mtime;
+  QList<DSymbol> symbols;
+ };
+
+ bool mapTable();
+ void unmapTable();
+ void loadFromTable();
+ bool writeTable(const QHash<QString, FileSymbols> &files);
+
+ const QString m_indexFileName;
+ mutable QMutex m_tableMutex;
+ QFile m_table;
+ const uchar *m_data;
+ qint64 m_size;
+
+ QMutex m_updateMutex;
+ QHash<QString, FileSymbols> m_files;
+ QFutureWatcher<void> m_update;
+ QStringList m_pendingFiles;
+ QStringList m_pendingIncludeDirs;
+ QStringList m_pendingSavedFiles;
+ bool m_pending;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+Q_DECLARE_METATYPE(DProjectManager::Internal::DSymbolLocation)
+
+#endif // DSYMBOLINDEX_H
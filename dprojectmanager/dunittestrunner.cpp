@@ -0,0 +1,418 @@
+#include "dunittestrunner.h"
+
+#include "dproject.h"
+#include "dmakestep.h"
+#include "dimportgraph.h"
+
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildsteplist.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/target.h>
+#include <utils/hostosinfo.h>
+#include <utils/qtcprocess.h>
+
+#include <QDir>
+#include <QMap>
+#include <QProcess>
+#include <QSaveFile>
+#include <QThread>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const char RUNNER_MODULE[] = "dunit_runner";
+const char FILTER_VARIABLE[] = "DUNIT_FILTER";
+const char LINE_PREFIX[] = "##dunit\t";
+const int MAX_CRASH_OUTPUT = 4096;
+
+/**
+ * The runner module; %1 are the static imports, %2 the calls of dunitRun
+ * for each module. Only the unittest blocks at module level are found by
+ * getUnitTests.
+ */
+const char RUNNER_SOURCE[] =
+  "// Generated by the D project manager of Qt Creator.\n"
+  "module dunit_runner;\n"
+  "\n"
+  "import core.runtime : Runtime;\n"
+  "import core.time : MonoTime;\n"
+  "import std.array : replace, split;\n"
+  "import std.conv : to;\n"
+  "import std.process : environment;\n"
+  "import std.stdio : stdout;\n"
+  "\n"
+  "%1"
+  "\n"
+  "private __gshared string[] dunitFilter;\n"
+  "\n"
+  "private bool dunitSelected(string mod, size_t line)\n"
+  "{\n"
+  "\tif (dunitFilter.length == 0)\n"
+  "\t\treturn true;\n"
+  "\tforeach (entry; dunitFilter)\n"
+  "\t\tif (entry == mod || entry == mod ~ \":\" ~ line.to!string)\n"
+  "\t\t\treturn true;\n"
+  "\treturn false;\n"
+  "}\n"
+  "\n"
+  "private void dunitPrint(string[] fields...)\n"
+  "{\n"
+  "\tstring text = \"##dunit\";\n"
+  "\tforeach (field; fields)\n"
+  "\t\ttext ~= \"\\t\" ~ field.replace(\"\\t\", \" \").replace(\"\\r\", \"\").replace(\"\\n\", \"\\\\n\");\n"
+  "\tstdout.writeln(text);\n"
+  "\tstdout.flush();\n"
+  "}\n"
+  "\n"
+  "private size_t dunitRun(string name, alias mod)()\n"
+  "{\n"
+  "\tsize_t failed;\n"
+  "\tforeach (test; __traits(getUnitTests, mod))\n"
+  "\t{\n"
+  "\t\tstatic if (__traits(compiles, __traits(getLocation, test)))\n"
+  "\t\t{\n"
+  "\t\t\tenum file = __traits(getLocation, test)[0];\n"
+  "\t\t\tenum size_t line = __traits(getLocation, test)[1];\n"
+  "\t\t}\n"
+  "\t\telse\n"
+  "\t\t{\n"
+  "\t\t\tenum file = \"\";\n"
+  "\t\t\tenum size_t line = 0;\n"
+  "\t\t}\n"
+  "\t\tenum testName = __traits(identifier, test);\n"
+  "\t\tif (!dunitSelected(name, line))\n"
+  "\t\t\tcontinue;\n"
+  "\t\tdunitPrint(\"start\", name, testName, line.to!string, file);\n"
+  "\t\timmutable start = MonoTime.currTime;\n"
+  "\t\ttry\n"
+  "\t\t{\n"
+  "\t\t\ttest();\n"
+  "\t\t\tdunitPrint(\"pass\", name, testName, line.to!string, file,\n"
+  "\t\t\t\t(MonoTime.currTime - start).total!\"usecs\".to!string);\n"
+  "\t\t}\n"
+  "\t\tcatch (Throwable t)\n"
+  "\t\t{\n"
+  "\t\t\t++failed;\n"
+  "\t\t\tdunitPrint(\"fail\", name, testName, line.to!string, file,\n"
+  "\t\t\t\t(MonoTime.currTime - start).total!\"usecs\".to!string, t.file, t.line.to!string, t.msg);\n"
+  "\t\t}\n"
+  "\t}\n"
+  "\treturn failed;\n"
+  "}\n"
+  "\n"
+  "shared static this()\n"
+  "{\n"
+  "\timmutable filter = environment.get(\"DUNIT_FILTER\", \"\");\n"
+  "\tif (filter.length)\n"
+  "\t\tdunitFilter = filter.split(\";\");\n"
+  "\tRuntime.moduleUnitTester = function bool()\n"
+  "\t{\n"
+  "\t\timport core.stdc.stdlib : exit;\n"
+  "\t\tsize_t failed;\n"
+  "%2"
+  "\t\tstdout.flush();\n"
+  "\t\t// main is not to run\n"
+  "\t\texit(failed ? 1 : 0);\n"
+  "\t\treturn false;\n"
+  "\t};\n"
+  "}\n";
+
+QString processEnd(QProcess *process)
+{
+ if (process->error() == QProcess::FailedToStart)
+  return DUnitTestRunner::tr("it could not be started");
+ if (process->exitStatus() == QProcess::CrashExit)
+  return DUnitTestRunner::tr("it crashed");
+ return DUnitTestRunner::tr("exit code %1").arg(process->exitCode());
+}
+} // namespace
+
+DUnitTestRunner::DUnitTestRunner(QObject *parent)
+ : QObject(parent),
+   m_build(0),
+   m_success(true)
+{
+}
+
+DUnitTestRunner::~DUnitTestRunner()
+{
+ cancel();
+ if (m_build)
+ {
+  m_build->disconnect(this);
+  m_build->waitForFinished();
+ }
+ foreach (QProcess *process, m_running.keys())
+ {
+  process->disconnect(this);
+  process->waitForFinished();
+ }
+}
+
+bool DUnitTestRunner::isRunning() const
+{
+ return m_build || !m_running.isEmpty();
+}
+
+QString DUnitTestRunner::testId(const QString &module, int line)
+{
+ return module + QLatin1Char(':') + QString::number(line);
+}
+
+void DUnitTestRunner::run(DProject *project, const QStringList &filter)
+{
+ if (isRunning())
+  return;
+ m_project = project;
+ m_success = true;
+ m_queue.clear();
+
+ BuildConfiguration *bc = project && project->activeTarget()
+   ? project->activeTarget()->activeBuildConfiguration() : 0;
+ BuildStepList *bsl = bc ? bc->stepList(ProjectExplorer::Constants::BUILDSTEPS_BUILD) : 0;
+ DMakeStep *makeStep = 0;
+ if (bsl)
+  foreach (BuildStep *step, bsl->steps())
+   if ((makeStep = qobject_cast<DMakeStep *>(step)))
+    break;
+ if (!makeStep)
+ {
+  emit message(tr("There is no D project with a make step to test."));
+  emit finished(false);
+  return;
+ }
+ const Utils::Environment env = bc->environment();
+ m_command = makeStep->makeCommand(env);
+ m_workingDirectory = bc->buildDirectory().toString();
+ m_environment = env.toProcessEnvironment();
+
+ const DImportGraph *graph = project->importGraph();
+ QStringList sources;
+ QStringList modules;
+ foreach (const QString &file, project->files().files())
+ {
+  if (!file.endsWith(QLatin1String(".d")))
+   continue;
+  sources.append(file);
+  const QString module = graph->moduleForFile(file);
+  if (!module.isEmpty())
+   modules.append(module);
+ }
+ // dub dependencies are built in, but not tested
+ sources << project->dubPackage().dependencySourceFiles();
+ sources.removeDuplicates();
+ modules.removeDuplicates();
+ modules.sort();
+
+ QMap<QString, QStringList> selected;
+ if (filter.isEmpty())
+ {
+  foreach (const QString &module, modules)
+   selected.insert(module, QStringList(module));
+ }
+ else
+ {
+  foreach (const QString &entry, filter)
+  {
+   const QString module = entry.section(QLatin1Char(':'), 0, 0);
+   if (modules.contains(module))
+    selected[module].append(entry);
+  }
+ }
+ for (QMap<QString, QStringList>::ConstIterator it = selected.constBegin(); it != selected.constEnd(); ++it)
+  m_queue.append(qMakePair(it.key(), it.value().join(QLatin1String(";"))));
+ emit started(selected.keys());
+
+ const QString directory = makeStep->unittestDirectory();
+ const QString runner = directory + QLatin1Char('/') + QLatin1String(RUNNER_MODULE) + QLatin1String(".d");
+ const QString responseFile = directory + QLatin1String("/sources.rsp");
+ m_binary = Utils::HostOsInfo::withExecutableSuffix(directory + QLatin1String("/dunit"));
+ QDir().mkpath(directory);
+ if (!writeRunner(runner, modules) || !DMakeStep::writeResponseFile(responseFile, sources))
+ {
+  emit message(tr("Could not write the unittest runner to %1.").arg(QDir::toNativeSeparators(directory)));
+  m_success = false;
+  m_queue.clear();
+  finish();
+  return;
+ }
+
+ QStringList args = Utils::QtcProcess::splitArgs(makeStep->unittestArguments());
+ args << QLatin1Char('@') + responseFile << runner
+      << QLatin1String("-of") + m_binary << QLatin1String("-od") + directory + QLatin1String("/obj");
+ m_build = new QProcess(this);
+ m_build->setProcessChannelMode(QProcess::MergedChannels);
+ m_build->setWorkingDirectory(m_workingDirectory);
+ m_build->setProcessEnvironment(m_environment);
+ connect(m_build, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(buildFinished()));
+ connect(m_build, SIGNAL(error(QProcess::ProcessError)), this, SLOT(buildFinished()));
+ emit message(tr("Building the unittests"));
+ m_build->start(m_command, args);
+}
+
+void DUnitTestRunner::cancel()
+{
+ m_queue.clear();
+ if (m_build)
+  m_build->kill();
+ foreach (QProcess *process, m_running.keys())
+  process->kill();
+}
+
+bool DUnitTestRunner::writeRunner(const QString &fileName, const QStringList &modules) const
+{
+ QString imports;
+ QString calls;
+ foreach (const QString &module, modules)
+ {
+  imports += QString::fromLatin1("static import %1;\n").arg(module);
+  calls += QString::fromLatin1("\t\tfailed += dunitRun!(\"%1\", %1)();\n").arg(module);
+ }
+ QSaveFile file(fileName);
+ if (!file.open(QIODevice::WriteOnly))
+  return false;
+ file.write(QString::fromLatin1(RUNNER_SOURCE).arg(imports, calls).toUtf8());
+ return file.commit();
+}
+
+void DUnitTestRunner::buildFinished()
+{
+ if (!m_build || m_build->state() != QProcess::NotRunning)
+  return;
+ const bool success = m_build->error() == QProcess::UnknownError
+   && m_build->exitStatus() == QProcess::NormalExit && m_build->exitCode() == 0;
+ const QString output = QString::fromLocal8Bit(m_build->readAll());
+ m_build->disconnect(this);
+ m_build->deleteLater();
+ m_build = 0;
+ if (!success)
+ {
+  emit message(tr("Building the unittests failed:\n%1").arg(output));
+  m_success = false;
+  m_queue.clear();
+ }
+ startTests();
+}
+
+void DUnitTestRunner::startTests()
+{
+ const int workers = qMax(1, QThread::idealThreadCount());
+ while (m_running.size() < workers && !m_queue.isEmpty())
+ {
+  const QPair<QString, QString> next = m_queue.takeFirst();
+  QProcessEnvironment environment = m_environment;
+  environment.insert(QLatin1String(FILTER_VARIABLE), next.second);
+  QProcess *process = new QProcess(this);
+  process->setProcessChannelMode(QProcess::MergedChannels);
+  process->setWorkingDirectory(m_workingDirectory);
+  process->setProcessEnvironment(environment);
+  connect(process, SIGNAL(readyRead()), this, SLOT(readOutput()));
+  connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(testProcessFinished()));
+  connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(testProcessFinished()));
+  RunningModule running;
+  running.module = next.first;
+  m_running.insert(process, running);
+  process->start(m_binary);
+ }
+ finish();
+}
+
+void DUnitTestRunner::readOutput()
+{
+ QProcess *process = qobject_cast<QProcess *>(sender());
+ if (!process || !m_running.contains(process))
+  return;
+ RunningModule *running = &m_running[process];
+ running->buffer += process->readAll();
+ int end;
+ while ((end = running->buffer.indexOf('\n')) >= 0)
+ {
+  const QString line = QString::fromLocal8Bit(running->buffer.constData(), end).remove(QLatin1Char('\r'));
+  running->buffer.remove(0, end + 1);
+  parseLine(running, line);
+ }
+}
+
+/**
+ * The runner prints "start", then "pass" or "fail", tab-separated with the
+ * module, test name, test line, test file and, when done, the time in
+ * microseconds; a failure adds its file, line and message.
+ */
+void DUnitTestRunner::parseLine(RunningModule *running, const QString &line)
+{
+ if (!line.startsWith(QLatin1String(LINE_PREFIX)))
+ {
+  if (running->output.size() < MAX_CRASH_OUTPUT)
+   running->output += line + QLatin1Char('\n');
+  return;
+ }
+ const QStringList fields = line.mid(qstrlen(LINE_PREFIX)).split(QLatin1Char('\t'));
+ const QString status = fields.value(0);
+ DUnitTestResult result;
+ result.module = fields.value(1);
+ result.test = fields.value(2);
+ result.line = fields.value(3).toInt();
+ result.file = fields.value(4);
+ if (status == QLatin1String("start"))
+ {
+  running->current = result;
+  running->output.clear();
+  return;
+ }
+ result.passed = status == QLatin1String("pass");
+ result.duration = fields.value(5).toLongLong();
+ result.failureFile = fields.value(6);
+ result.failureLine = fields.value(7).toInt();
+ result.message = fields.value(8).replace(QLatin1String("\\n"), QLatin1String("\n"));
+ running->current = DUnitTestResult();
+ if (!result.passed)
+ {
+  running->failed = true;
+  m_success = false;
+ }
+ emit testFinished(result);
+}
+
+void DUnitTestRunner::testProcessFinished()
+{
+ QProcess *process = qobject_cast<QProcess *>(sender());
+ if (!process || !m_running.contains(process) || process->state() != QProcess::NotRunning)
+  return;
+ readOutput();
+ RunningModule running = m_running.take(process);
+ if (!running.buffer.isEmpty())
+  parseLine(&running, QString::fromLocal8Bit(running.buffer));
+
+ if (!running.current.test.isEmpty())
+ {
+  DUnitTestResult result = running.current;
+  result.message = tr("The test process ended during the test (%1).").arg(processEnd(process));
+  if (!running.output.isEmpty())
+   result.message += QLatin1Char('\n') + running.output.trimmed();
+  m_success = false;
+  emit testFinished(result);
+ }
+ else if (!running.failed && (process->error() != QProcess::UnknownError
+                              || process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0))
+ {
+  // e.g. a module constructor that threw
+  emit message(tr("The tests of %1 did not run: %2.\n%3")
+               .arg(running.module, processEnd(process), running.output.trimmed()));
+  m_success = false;
+ }
+ process->disconnect(this);
+ process->deleteLater();
+ startTests();
+}
+
+void DUnitTestRunner::finish()
+{
+ if (!isRunning() && m_queue.isEmpty())
+  emit finished(m_success);
+}
+
+} // namespace Internal
+} // namespace DProjectManager
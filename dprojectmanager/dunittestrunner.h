@@ -0,0 +1,107 @@
+#ifndef DUNITTESTRUNNER_H
+#define DUNITTESTRUNNER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QProcessEnvironment>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QProcess;
+QT_END_NAMESPACE
+
+namespace DProjectManager {
+namespace Internal {
+
+class DProject;
+
+struct DUnitTestResult
+{
+ DUnitTestResult() : line(0), passed(false), duration(0), failureLine(0) {}
+
+ QString module;
+ QString test;
+ QString file;
+ int line;
+ bool passed;
+ qint64 duration; ///< in microseconds
+ QString failureFile;
+ int failureLine;
+ QString message;
+};
+
+/**
+ * Builds a unittest binary of a D project with a generated runner module
+ * and runs it once per module, on as many processes at once as there are
+ * cores. The runner replaces druntime's module unit tester: it runs the
+ * unittest blocks of the modules given by DUNIT_FILTER one by one and
+ * prints a line per test, so results, times and failure locations are
+ * known per test and a crash only takes its module down.
+ */
+class DUnitTestRunner : public QObject
+{
+ Q_OBJECT
+
+public:
+ explicit DUnitTestRunner(QObject *parent = 0);
+ ~DUnitTestRunner();
+
+ bool isRunning() const;
+ /**
+  * Runs the tests of @a project selected by @a filter, all if it is empty.
+  * An entry is a module name, or a module name and the line of a test,
+  * as in "app.parser:42".
+  */
+ void run(DProject *project, const QStringList &filter = QStringList());
+ /// Where relative file names of the results are relative to.
+ QString workingDirectory() const { return m_workingDirectory; }
+
+ static QString testId(const QString &module, int line);
+
+public slots:
+ void cancel();
+
+signals:
+ void started(const QStringList &modules);
+ void testFinished(const DProjectManager::Internal::DUnitTestResult &result);
+ void message(const QString &text);
+ void finished(bool success);
+
+private slots:
+ void buildFinished();
+ void readOutput();
+ void testProcessFinished();
+
+private:
+ struct RunningModule
+ {
+  RunningModule() : failed(false) {}
+  QString module;
+  QByteArray buffer;
+  QString output; ///< of the tests themselves, for crash reports
+  DUnitTestResult current; ///< the test that started and has not ended yet
+  bool failed;
+ };
+
+ bool writeRunner(const QString &fileName, const QStringList &modules) const;
+ void startTests();
+ void parseLine(RunningModule *running, const QString &line);
+ void finish();
+
+ QPointer<DProject> m_project;
+ QString m_command;
+ QString m_workingDirectory;
+ QProcessEnvironment m_environment;
+ QString m_binary;
+ QProcess *m_build;
+ QList<QPair<QString, QString> > m_queue; ///< module and its DUNIT_FILTER
+ QHash<QProcess *, RunningModule> m_running;
+ bool m_success;
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DUNITTESTRUNNER_H
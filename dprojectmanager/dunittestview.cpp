@@ -0,0 +1,217 @@
+#include "dunittestview.h"
+
+#include "dprojectmanagerconstants.h"
+#include "dproject.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/messagemanager.h>
+#include <projectexplorer/session.h>
+
+#include <QDir>
+#include <QHeaderView>
+#include <QToolButton>
+
+using namespace ProjectExplorer;
+
+namespace DProjectManager {
+namespace Internal {
+
+namespace {
+const int FileNameRole = Qt::UserRole;
+const int LineRole = Qt::UserRole + 1;
+const int TestIdRole = Qt::UserRole + 2;
+const int PassedRole = Qt::UserRole + 3;
+
+enum Column { NameColumn, ResultColumn, TimeColumn, ColumnCount };
+
+double milliseconds(qint64 microseconds)
+{
+ return qRound64(microseconds / 100.0) / 10.0;
+}
+
+QToolButton *createButton(const QString &text, const QString &toolTip)
+{
+ QToolButton *button = new QToolButton;
+ button->setText(text);
+ button->setToolTip(toolTip);
+ button->setAutoRaise(true);
+ return button;
+}
+} // namespace
+
+DUnitTestView::DUnitTestView(QWidget *parent)
+ : QTreeWidget(parent),
+   m_runButton(createButton(tr("Run"), tr("Run Unittests"))),
+   m_rerunButton(createButton(tr("Rerun Failed"), tr("Rerun Failed Unittests"))),
+   m_stopButton(createButton(tr("Stop"), tr("Stop Unittests")))
+{
+ setColumnCount(ColumnCount);
+ setHeaderLabels(QStringList() << tr("Module / Test") << tr("Result") << tr("Time (ms)"));
+ header()->setStretchLastSection(false);
+ header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+ setUniformRowHeights(true);
+ setSortingEnabled(true);
+ sortByColumn(NameColumn, Qt::AscendingOrder);
+ connect(this, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(openItem(QTreeWidgetItem*)));
+ connect(m_runButton, SIGNAL(clicked()), this, SLOT(runAll()));
+ connect(m_rerunButton, SIGNAL(clicked()), this, SLOT(rerunFailed()));
+ connect(m_stopButton, SIGNAL(clicked()), &m_runner, SLOT(cancel()));
+ connect(&m_runner, SIGNAL(started(QStringList)), this, SLOT(started(QStringList)));
+ connect(&m_runner, SIGNAL(testFinished(DProjectManager::Internal::DUnitTestResult)),
+         this, SLOT(testFinished(DProjectManager::Internal::DUnitTestResult)));
+ connect(&m_runner, SIGNAL(message(QString)), this, SLOT(showMessage(QString)));
+ connect(&m_runner, SIGNAL(finished(bool)), this, SLOT(finished(bool)));
+ updateButtons();
+}
+
+void DUnitTestView::runAll()
+{
+ run(QStringList());
+}
+
+void DUnitTestView::rerunFailed()
+{
+ run(m_failed);
+}
+
+void DUnitTestView::run(const QStringList &filter)
+{
+ if (m_runner.isRunning())
+  return;
+ // a full run starts over, a rerun updates the items of the tests it reruns
+ if (filter.isEmpty())
+  clear();
+ m_failed.clear();
+ m_runner.run(qobject_cast<DProject *>(SessionManager::startupProject()), filter);
+ updateButtons();
+}
+
+void DUnitTestView::started(const QStringList &modules)
+{
+ foreach (const QString &module, modules)
+  moduleItem(module);
+}
+
+void DUnitTestView::testFinished(const DUnitTestResult &result)
+{
+ QTreeWidgetItem *parent = moduleItem(result.module);
+ const QString id = DUnitTestRunner::testId(result.module, result.line);
+ QTreeWidgetItem *item = 0;
+ for (int i = 0; i < parent->childCount() && !item; ++i)
+  if (parent->child(i)->data(NameColumn, TestIdRole).toString() == id)
+   item = parent->child(i);
+ if (!item)
+ {
+  item = new QTreeWidgetItem;
+  parent->addChild(item);
+ }
+
+ // compiler generated names say no more than the line
+ item->setText(NameColumn, result.test.startsWith(QLatin1String("__unittest"))
+               ? tr("unittest, line %1").arg(result.line) : result.test);
+ item->setData(NameColumn, TestIdRole, id);
+ item->setData(NameColumn, PassedRole, result.passed);
+ item->setData(TimeColumn, Qt::DisplayRole, milliseconds(result.duration));
+ item->setText(ResultColumn, result.passed ? tr("passed") : tr("failed"));
+ item->setForeground(ResultColumn, result.passed ? palette().text() : QBrush(Qt::red));
+ const bool atFailure = !result.passed && !result.failureFile.isEmpty();
+ item->setData(NameColumn, FileNameRole, atFailure ? result.failureFile : result.file);
+ item->setData(NameColumn, LineRole, atFailure ? result.failureLine : result.line);
+ QString toolTip;
+ if (!result.passed)
+ {
+  toolTip = result.message;
+  if (atFailure)
+   toolTip = QDir::toNativeSeparators(result.failureFile)
+     + QString::fromLatin1("(%1): ").arg(result.failureLine) + toolTip;
+  m_failed.append(result.line > 0 ? id : result.module);
+  parent->setExpanded(true);
+ }
+ item->setToolTip(NameColumn, toolTip);
+ item->setToolTip(ResultColumn, toolTip);
+
+ int passed = 0;
+ qint64 duration = 0;
+ bool failed = false;
+ for (int i = 0; i < parent->childCount(); ++i)
+ {
+  QTreeWidgetItem *child = parent->child(i);
+  if (child->data(NameColumn, PassedRole).toBool())
+   ++passed;
+  else
+   failed = true;
+  duration += qRound64(child->data(TimeColumn, Qt::DisplayRole).toDouble() * 1000);
+ }
+ parent->setText(ResultColumn, tr("%1 of %2 passed").arg(passed).arg(parent->childCount()));
+ parent->setForeground(ResultColumn, failed ? QBrush(Qt::red) : palette().text());
+ parent->setData(TimeColumn, Qt::DisplayRole, milliseconds(duration));
+}
+
+void DUnitTestView::showMessage(const QString &text)
+{
+ Core::MessageManager::write(text);
+}
+
+void DUnitTestView::finished(bool success)
+{
+ if (!success && m_failed.isEmpty())
+  Core::MessageManager::write(tr("The unittests did not run to the end."));
+ updateButtons();
+}
+
+void DUnitTestView::updateButtons()
+{
+ const bool running = m_runner.isRunning();
+ m_runButton->setEnabled(!running);
+ m_rerunButton->setEnabled(!running && !m_failed.isEmpty());
+ m_stopButton->setEnabled(running);
+}
+
+QTreeWidgetItem *DUnitTestView::moduleItem(const QString &module)
+{
+ for (int i = 0; i < topLevelItemCount(); ++i)
+  if (topLevelItem(i)->text(NameColumn) == module)
+   return topLevelItem(i);
+ QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(module));
+ addTopLevelItem(item);
+ return item;
+}
+
+void DUnitTestView::openItem(QTreeWidgetItem *item)
+{
+ QString fileName = item->data(NameColumn, FileNameRole).toString();
+ if (fileName.isEmpty())
+  return;
+ // the runner reports the locations the compiler saw, relative to where it ran
+ if (!m_runner.workingDirectory().isEmpty())
+  fileName = QDir(m_runner.workingDirectory()).absoluteFilePath(fileName);
+ const int line = item->data(NameColumn, LineRole).toInt();
+ if (line > 0)
+  Core::EditorManager::openEditorAt(fileName, line);
+ else
+  Core::EditorManager::openEditor(fileName);
+}
+
+//--------------------------------------------------------------------------------------
+
+QString DUnitTestViewFactory::displayName() const
+{
+ return tr("D Unittests");
+}
+
+Core::Id DUnitTestViewFactory::id() const
+{
+ return Core::Id(Constants::D_UNITTEST_VIEW_ID);
+}
+
+Core::NavigationView DUnitTestViewFactory::createWidget()
+{
+ DUnitTestView *view = new DUnitTestView;
+ Core::NavigationView navigationView;
+ navigationView.widget = view;
+ navigationView.dockToolBarWidgets << view->runButton() << view->rerunButton() << view->stopButton();
+ return navigationView;
+}
+
+} // namespace Internal
+} // namespace DProjectManager
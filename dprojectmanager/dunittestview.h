@@ -0,0 +1,67 @@
+#ifndef DUNITTESTVIEW_H
+#define DUNITTESTVIEW_H
+
+#include "dunittestrunner.h"
+
+#include <coreplugin/inavigationwidgetfactory.h>
+
+#include <QTreeWidget>
+
+QT_BEGIN_NAMESPACE
+class QToolButton;
+QT_END_NAMESPACE
+
+namespace DProjectManager {
+namespace Internal {
+
+/**
+ * The unittest results of the startup D project, a module item with an item
+ * per test. A test item opens the location of its failure, or the test.
+ */
+class DUnitTestView : public QTreeWidget
+{
+ Q_OBJECT
+
+public:
+ explicit DUnitTestView(QWidget *parent = 0);
+
+ QToolButton *runButton() const { return m_runButton; }
+ QToolButton *rerunButton() const { return m_rerunButton; }
+ QToolButton *stopButton() const { return m_stopButton; }
+
+private slots:
+ void runAll();
+ void rerunFailed();
+ void started(const QStringList &modules);
+ void testFinished(const DProjectManager::Internal::DUnitTestResult &result);
+ void showMessage(const QString &text);
+ void finished(bool success);
+ void openItem(QTreeWidgetItem *item);
+
+private:
+ void run(const QStringList &filter);
+ void updateButtons();
+ QTreeWidgetItem *moduleItem(const QString &module);
+
+ DUnitTestRunner m_runner;
+ QToolButton *m_runButton;
+ QToolButton *m_rerunButton;
+ QToolButton *m_stopButton;
+ QStringList m_failed; ///< test ids for rerunFailed()
+};
+
+class DUnitTestViewFactory : public Core::INavigationWidgetFactory
+{
+ Q_OBJECT
+
+public:
+ QString displayName() const;
+ int priority() const { return 620; }
+ Core::Id id() const;
+ Core::NavigationView createWidget();
+};
+
+} // namespace Internal
+} // namespace DProjectManager
+
+#endif // DUNITTESTVIEW_H